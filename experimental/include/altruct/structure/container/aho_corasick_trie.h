@@ -1,7 +1,11 @@
 #pragma once
 
 #include "altruct/algorithm/collections/collections.h"
+#include "altruct/algorithm/math/intrinsic.h"
+#include "altruct/io/reader.h"
 
+#include <algorithm>
+#include <map>
 #include <queue>
 #include <vector>
 #include <iterator>
@@ -14,7 +18,8 @@ namespace container {
  * A trie structure post-processed with the Aho�Corasick algorithm.
  *
  * Note, if the ALPHABET_SIZE is big (e.g. 256 letters, 8 bit),
- * one can split each letter into two or more symbols (e.g. 4 bits each).
+ * one can split each letter into two or more symbols (e.g. 4 bits each),
+ * or use `compact_aho_corasick_trie` instead.
  *
  * Space complexity: `O(ALPHABET_SIZE * DICT_SIZE)`.
  * Time complexities:
@@ -84,7 +89,7 @@ public:
         while (!q.empty()) {
             index_t cur_node = q.front(); q.pop();
             index_t* next = trie[cur_node].next;
-            for (alpha_t let = 0; let < ALPHABET_SIZE; let++) {
+            for (int let = 0; let < ALPHABET_SIZE; let++) {
                 if (next[let]) q.push(next[let]);
             }
             index_t suff_link = _get_suff_link(cur_node);
@@ -147,5 +152,269 @@ public:
     }
 };
 
+/**
+ * A compact Aho-Corasick automaton over an 8-bit alphabet.
+ *
+ * Unlike `aho_corasick_trie` that keeps a dense transition table per node,
+ * here each node keeps a 256-bit bitmap of its children, which get laid out
+ * contiguously in the BFS order. The child for the letter `let` is then at
+ * `first_child + rank(bitmap, let)`. Missing transitions are resolved by
+ * following the suffix links (amortized `O(1)` per letter), with the root
+ * transitions kept dense.
+ *
+ * Patterns are inserted first, and the automaton gets laid out by `build`;
+ * no patterns can be inserted after that.
+ *
+ * Besides the search over an iterator range, there is a streaming search over
+ * `io::reader`, and an interleaved search over multiple ranges at once, which
+ * advances several automaton states in lockstep so that their memory accesses
+ * overlap.
+ *
+ * Space complexity: `O(DICT_SIZE)`, 56 bytes per node for 32-bit indices.
+ * Time complexities:
+ *   insert:    `O(WORD_SIZE log ALPHABET_SIZE)`
+ *   build:     `O(DICT_SIZE)`
+ *   move_next: `O(1)` amortized
+ */
+template<typename INDEX_T = int>
+class compact_aho_corasick_trie {
+public:
+    typedef INDEX_T index_t;
+
+    static const index_t NIL = 0;
+    static const index_t ROOT = 1;
+    static const index_t RESERVED = 2;
+    static const int LANES = 8; // number of states advanced in lockstep by the interleaved search
+
+    struct node_t {
+        uint64_t bitmap[4];   // children letters
+        uint8_t rank[4];      // number of children in the preceding bitmap words
+        index_t first_child;  // index of the first child; children are contiguous
+        index_t suff_link;    // longest proper suffix that is in the trie
+        index_t out_link;     // longest proper suffix that is a word
+        index_t word_cnt;     // number of words that are suffixes of this node, including itself
+        index_t depth;        // length of the node's string
+    };
+
+    std::vector<node_t> trie;
+    index_t root_next[256];             // dense transitions of the root, the most frequent fallback
+    std::vector<index_t> pattern_nodes; // node of each pattern
+
+private:
+    std::vector<std::map<uint8_t, index_t>> _edges; // insertion trie, cleared by `build`
+    std::vector<index_t> _ends;                      // number of patterns ending at each insertion trie node
+
+public:
+    compact_aho_corasick_trie() : _edges(RESERVED), _ends(RESERVED) {
+        std::fill(root_next, root_next + 256, index_t(ROOT));
+    }
+
+    // Insert pattern word to the trie dictionary.
+    // Letters are taken as 8-bit values, the same as when searching.
+    // Returns the pattern index; see `pattern_node`.
+    template<typename It>
+    index_t insert(It begin, It end) {
+        index_t cur_node = ROOT;
+        for (auto it = begin; it != end; ++it) {
+            uint8_t let = (uint8_t)*it;
+            // not a reference into `_edges`, as `emplace_back` may reallocate it
+            index_t next = _edges[cur_node][let];
+            if (next == NIL) {
+                next = (index_t)_edges.size();
+                _edges[cur_node][let] = next;
+                _edges.emplace_back();
+                _ends.push_back(0);
+            }
+            cur_node = next;
+        }
+        _ends[cur_node]++;
+        pattern_nodes.push_back(cur_node);
+        return (index_t)pattern_nodes.size() - 1;
+    }
+
+    // Lays out the trie in the BFS order and postprocesses it with the Aho-Corasick algorithm.
+    void build() {
+        index_t n = (index_t)_edges.size();
+        std::vector<index_t> new_index(n, index_t(NIL));
+        std::vector<index_t> order(RESERVED, index_t(NIL));
+        order[ROOT] = ROOT, new_index[ROOT] = ROOT;
+        // in the BFS order, children of each node are assigned contiguous indices
+        for (index_t i = ROOT; i < (index_t)order.size(); i++) {
+            for (const auto& e : _edges[order[i]]) {
+                new_index[e.second] = (index_t)order.size();
+                order.push_back(e.second);
+            }
+        }
+        trie.assign(order.size(), node_t());
+        for (index_t i = ROOT; i < (index_t)order.size(); i++) {
+            node_t& t = trie[i];
+            const auto& edges = _edges[order[i]];
+            t.first_child = edges.empty() ? NIL : new_index[edges.begin()->second];
+            for (const auto& e : edges) t.bitmap[e.first >> 6] |= uint64_t(1) << (e.first & 63);
+            for (int j = 1; j < 4; j++) t.rank[j] = uint8_t(t.rank[j - 1] + math::popcount64(t.bitmap[j - 1]));
+            t.word_cnt = _ends[order[i]];
+        }
+        for (auto& p : pattern_nodes) p = new_index[p];
+        for (int let = 0; let < 256; let++) {
+            index_t next = child(ROOT, uint8_t(let));
+            root_next[let] = (next != NIL) ? next : ROOT;
+        }
+        // suffix links in the BFS order, so that the shallower nodes are already linked
+        trie[ROOT].suff_link = ROOT;
+        for (index_t i = ROOT; i < (index_t)order.size(); i++) {
+            node_t& t = trie[i];
+            for (const auto& e : _edges[order[i]]) {
+                index_t c = new_index[e.second];
+                node_t& tc = trie[c];
+                tc.depth = t.depth + 1;
+                tc.suff_link = (i == ROOT) ? ROOT : move_next(t.suff_link, e.first);
+                const node_t& ts = trie[tc.suff_link];
+                tc.out_link = (_ends[order[tc.suff_link]] > 0) ? tc.suff_link : ts.out_link;
+                tc.word_cnt += ts.word_cnt;
+            }
+        }
+        std::vector<std::map<uint8_t, index_t>>().swap(_edges);
+        std::vector<index_t>().swap(_ends);
+    }
+
+    // Returns the child of the given node, or NIL if there is no such.
+    index_t child(index_t cur_node, uint8_t let) const {
+        const node_t& t = trie[cur_node];
+        uint64_t w = t.bitmap[let >> 6], m = uint64_t(1) << (let & 63);
+        if (!(w & m)) return NIL;
+        return t.first_child + t.rank[let >> 6] + math::popcount64(w & (m - 1));
+    }
+
+    // Moves to the next state given the current state and the transition letter.
+    index_t move_next(index_t cur_node, uint8_t let) const {
+        for (;;) {
+            if (cur_node == ROOT) return root_next[let];
+            index_t next = child(cur_node, let);
+            if (next != NIL) return next;
+            cur_node = trie[cur_node].suff_link;
+        }
+    }
+
+    // Feeds the given letters to the automaton, starting from the state `cur_node`.
+    // `visitor(pos, node)` gets called for each word `node` that ends right before `pos`;
+    // `pos` is relative to `begin`, offset by `pos0`.
+    // Returns the final state, to be used for the subsequent chunk of the input.
+    template<typename It, typename F>
+    index_t scan(index_t cur_node, It begin, It end, F visitor, size_t pos0 = 0) const {
+        size_t pos = pos0;
+        for (auto it = begin; it != end; ++it) {
+            cur_node = move_next(cur_node, (uint8_t)*it);
+            pos++;
+            if (trie[cur_node].word_cnt == 0) continue;
+            index_t w = is_word(cur_node) ? cur_node : trie[cur_node].out_link;
+            for (; w != NIL; w = trie[w].out_link) visitor(pos, w);
+        }
+        return cur_node;
+    }
+
+    // Calls `visitor(pos, node)` for all occurences of all dictionary words within the given string.
+    // The word `node` occurs at `[pos - depth(node), pos)`.
+    template<typename It, typename F>
+    void for_each_match(It begin, It end, F visitor) const {
+        scan(ROOT, begin, end, visitor);
+    }
+
+    // Calls `visitor(pos, node)` for all occurences of all dictionary words within the given stream.
+    template<typename F>
+    void for_each_match(io::reader& in, F visitor, size_t buffer_size = 1 << 16) const {
+        std::vector<char> buff(buffer_size);
+        index_t cur_node = ROOT;
+        size_t pos = 0;
+        for (size_t len; (len = in.read(buff.data(), buff.size())) > 0; pos += len) {
+            cur_node = scan(cur_node, buff.begin(), buff.begin() + len, visitor, pos);
+        }
+    }
+
+    // Counts all occurences of all dictionary words within the given string.
+    template<typename It>
+    int64_t count_matches(It begin, It end) const {
+        int64_t r = 0;
+        index_t cur_node = ROOT;
+        for (auto it = begin; it != end; ++it) {
+            cur_node = move_next(cur_node, (uint8_t)*it);
+            r += trie[cur_node].word_cnt;
+        }
+        return r;
+    }
+
+    // Counts all occurences of all dictionary words within the given stream.
+    int64_t count_matches(io::reader& in, size_t buffer_size = 1 << 16) const {
+        std::vector<char> buff(buffer_size);
+        int64_t r = 0;
+        index_t cur_node = ROOT;
+        for (size_t len; (len = in.read(buff.data(), buff.size())) > 0; ) {
+            for (size_t i = 0; i < len; i++) {
+                cur_node = move_next(cur_node, (uint8_t)buff[i]);
+                r += trie[cur_node].word_cnt;
+            }
+        }
+        return r;
+    }
+
+    // Counts all occurences of all dictionary words within each of the given strings.
+    // `LANES` strings are scanned at once, with their states advanced in lockstep.
+    template<typename It>
+    std::vector<int64_t> count_matches_interleaved(const std::vector<std::pair<It, It>>& ranges) const {
+        std::vector<int64_t> r(ranges.size());
+        for (size_t g = 0; g < ranges.size(); g += LANES) {
+            int lanes = (int)std::min(ranges.size() - g, size_t(LANES));
+            It it[LANES], end[LANES];
+            index_t cur_node[LANES];
+            int64_t cnt[LANES];
+            for (int l = 0; l < lanes; l++) {
+                it[l] = ranges[g + l].first, end[l] = ranges[g + l].second;
+                cur_node[l] = ROOT, cnt[l] = 0;
+            }
+            for (int active = lanes; active > 0; ) {
+                active = 0;
+                for (int l = 0; l < lanes; l++) {
+                    if (it[l] == end[l]) continue;
+                    cur_node[l] = move_next(cur_node[l], (uint8_t)*it[l]);
+                    cnt[l] += trie[cur_node[l]].word_cnt;
+                    ++it[l];
+                    active++;
+                }
+            }
+            for (int l = 0; l < lanes; l++) r[g + l] = cnt[l];
+        }
+        return r;
+    }
+
+    // Whether some pattern ends at the given node.
+    bool is_word(index_t node) const {
+        return trie[node].word_cnt > (trie[node].out_link ? trie[trie[node].out_link].word_cnt : 0);
+    }
+
+    // Returns the node of the given pattern.
+    index_t pattern_node(index_t pattern) const {
+        return pattern_nodes[pattern];
+    }
+
+    // Returns the length of the string of the given node.
+    index_t depth(index_t node) const {
+        return trie[node].depth;
+    }
+
+    // Returns the index of the root node.
+    index_t root() const {
+        return ROOT;
+    }
+
+    // Returns the number of nodes.
+    index_t size() const {
+        return (index_t)trie.size();
+    }
+
+    // Accesses node by its index.
+    const node_t& operator[] (index_t index) const {
+        return trie[index];
+    }
+};
+
 } // container
 } // altruct
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "altruct/concurrency/executor.h"
+#include "altruct/structure/container/suffix_array.h"
+#include "altruct/structure/container/wavelet_matrix.h"
+
+#include <vector>
+#include <iterator>
+#include <type_traits>
+
+namespace altruct {
+namespace container {
+
+/**
+ * FM-index for counting pattern occurrences.
+ *
+ * The Burrows-Wheeler transform of the string is derived from its suffix array
+ * and stored in a wavelet matrix. The occurrences of a pattern are counted by
+ * a backward search, with a pair of wavelet matrix ranks per pattern character.
+ * The suffix array is not needed once the index is built.
+ *
+ * Space complexity: `O(n log sigma)` bits.
+ * Time complexities:
+ *   build: `O(n log sigma)`
+ *   count: `O(m log sigma)` for a pattern of length `m`
+ */
+template<typename ALPHA_T = char, typename INDEX_T = int>
+class fm_index {
+public:
+    typedef ALPHA_T alpha_t;
+    typedef INDEX_T index_t;
+    typedef suffix_array<alpha_t, index_t> suffix_array_t;
+
+    typedef typename std::make_unsigned<alpha_t>::type ualpha_t;
+
+    wavelet_matrix<uint32_t> _bwt;    // BWT with the characters as `offset + 1`, and the sentinel as 0
+    std::vector<index_t> _counts;     // number of BWT characters smaller than the given (coded) one
+    alpha_t _min;                     // the smallest character of the string
+
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    fm_index(It begin, It end, const EXEC& exec = EXEC()) {
+        build(suffix_array_t(begin, end, exec), exec);
+    }
+
+    template<typename EXEC = concurrency::serial_range_executor>
+    fm_index(const suffix_array_t& sa, const EXEC& exec = EXEC()) {
+        build(sa, exec);
+    }
+
+    // returns the length of the indexed string
+    index_t size() const { return index_t(_bwt.size()) - 1; }
+
+    // returns the number of occurrences of the given pattern
+    template<typename It>
+    index_t count(It begin, It end) const {
+        index_t lo = 0, hi = index_t(_bwt.size());
+        for (It it = end; it != begin && lo < hi; ) {
+            uint64_t d = offset(*--it);
+            if (d >= _counts.size() - 2) return 0;
+            uint32_t c = uint32_t(d) + 1;
+            lo = _counts[c] + index_t(_bwt.rank(0, lo, c));
+            hi = _counts[c] + index_t(_bwt.rank(0, hi, c));
+        }
+        return (lo < hi) ? hi - lo : 0;
+    }
+
+private:
+    template<typename EXEC>
+    void build(const suffix_array_t& sa, const EXEC& exec) {
+        index_t n = sa.size();
+        _min = (n > 0) ? *std::min_element(sa._string.begin(), sa._string.end()) : alpha_t();
+        std::vector<uint32_t> bwt(n + 1);
+        for (index_t k = 0; k <= n; k++) {
+            index_t i = sa.get_kth_suffix(k);
+            bwt[k] = (i == 0) ? 0 : uint32_t(offset(sa._string[i - 1])) + 1;
+        }
+        for (uint32_t c : bwt) {
+            if (c + 2 > _counts.size()) _counts.resize(c + 2);
+            _counts[c + 1]++;
+        }
+        for (size_t c = 1; c < _counts.size(); c++) {
+            _counts[c] += _counts[c - 1];
+        }
+        _bwt = wavelet_matrix<uint32_t>(bwt.begin(), bwt.end(), exec);
+    }
+
+    // the offset from the smallest character, in the order of the suffix array;
+    // the characters smaller than `_min` wrap around, past the offsets in the string
+    uint64_t offset(alpha_t a) const {
+        return uint64_t(ualpha_t(ualpha_t(a) - ualpha_t(_min)));
+    }
+};
+
+} // container
+} // altruct
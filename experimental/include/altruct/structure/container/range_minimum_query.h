@@ -62,6 +62,16 @@ public:
         build_sparse_table();
     }
 
+    // takes over the given array instead of copying it
+    void build(std::vector<value_t>&& v) {
+        index_t len = (index_t)v.size();
+        blocks = (len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        _array = std::move(v);
+        _array.resize(blocks * BLOCK_SIZE);
+        build_block_trees();
+        build_sparse_table();
+    }
+
     value_t get_value(index_t begin, index_t end) const {
         return _array.at(get_index(begin, end));
     }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "altruct/concurrency/executor.h"
 #include "altruct/structure/container/range_minimum_query.h"
 
 #include <vector>
 #include <iterator>
 #include <functional>
+#include <type_traits>
 
 namespace altruct {
 namespace container {
@@ -13,6 +15,25 @@ namespace container {
  * Suffix array structure.
  * Also computes inverse suffix array, lcp and its rmq.
  *
+ * The suffix array is built by SA-IS, and the lcp array by Kasai's algorithm.
+ * The independent parts of the build are dispatched through the given range
+ * executor (see `concurrency::serial_range_executor`): the induced sorting,
+ * naming of the LMS substrings, the inverse suffix array, and the lcp array,
+ * computed in chunks of the input that each restart the Kasai's scan from zero.
+ *
+ * The induced sorting scans the suffix array in blocks. For each block, the
+ * preceding positions of its suffixes and their characters and types, which
+ * are the random accesses, get read through the executor, and then the
+ * suffixes get placed into their buckets serially. A slot that the block
+ * itself overwrites after it got read is read again serially.
+ *
+ * Besides the suffix array itself, SA-IS needs the copy of the input,
+ * `max(alphabet size, n / 2)` bucket offsets, the L/S types of `n / 8`
+ * bytes, halving with each level of the recursion, that works in place within
+ * the suffix array, and three indices per slot of an induced sorting block.
+ * For bytes and 32-bit indices this is about `3.25 n` bytes, plus 768 KB.
+ * The inverse suffix array and the lcp array (moved into its rmq) are kept.
+ *
  * Space complexity: `O(n)`.
  * Time complexities:
  *   build: `O(n)`
@@ -24,58 +45,71 @@ public:
     typedef ALPHA_T alpha_t;
     typedef INDEX_T index_t;
 
+    // the number of suffix array slots per block of the induced sorting
+    static index_t induce_block_size;
+
     std::vector<alpha_t> _string;     // input string (we only need this for `compare_substrings`)
     std::vector<index_t> _suff_arr;   // position (offset in the string) of the k-th lexicographically smallest suffix
     std::vector<index_t> _suff_ord;   // lexicographical order of the suffix starting at position `i`; inverse of `_suff_arr`
     //std::vector<index_t> _lcp_arr;  // longest-common-prefix for each pair of successive sorted suffixes
     direct_rmq<index_t> _lcp_arr_rmq; // range-minimum-query structure for lcp array
 
-    template<typename It>
-    suffix_array(It begin, It end) {
-        build_all(begin, end);
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    suffix_array(It begin, It end, const EXEC& exec = EXEC()) {
+        build_all(begin, end, exec);
     }
 
 private:
-    template<typename It>
-    void build_all(It begin, It end) {
-        build_suffix_array(begin, end);
-        build_inverse_suffix_array();
-        build_lcp_array();
+    template<typename It, typename EXEC>
+    void build_all(It begin, It end, const EXEC& exec) {
+        build_suffix_array(begin, end, exec);
+        build_inverse_suffix_array(exec);
+        build_lcp_array(exec);
     }
 
-    template<typename It>
-    void build_suffix_array(It begin, It end) {
-        alpha_t max_elem = *std::max_element(begin, end);
-        build_suffix_array(begin, end, (index_t)max_elem + 1);
-    }
-
-    template<typename It>
-    void build_suffix_array(It begin, It end, index_t alpha_size) {
+    template<typename It, typename EXEC>
+    void build_suffix_array(It begin, It end, const EXEC& exec) {
         _string.assign(begin, end);
         _suff_arr.assign(_string.size() + 1, 0);
         if (_string.size() > 0) {
-            sa_is<alpha_t>(_string.data(), (index_t)_string.size(), alpha_size, _suff_arr.data());
+            alpha_t min_elem = *std::min_element(_string.begin(), _string.end());
+            alpha_t max_elem = *std::max_element(_string.begin(), _string.end());
+            if (min_elem < alpha_t(0)) {
+                // the characters are the bucket indices; shifting them by the minimum preserves the order
+                typedef typename std::make_unsigned<alpha_t>::type ualpha_t;
+                std::vector<ualpha_t> shifted(_string.size());
+                for (size_t i = 0; i < _string.size(); i++) {
+                    shifted[i] = ualpha_t(ualpha_t(_string[i]) - ualpha_t(min_elem));
+                }
+                sa_is<ualpha_t>(shifted.data(), (index_t)_string.size(), (index_t)ualpha_t(ualpha_t(max_elem) - ualpha_t(min_elem)) + 1, _suff_arr.data(), exec);
+            } else {
+                sa_is<alpha_t>(_string.data(), (index_t)_string.size(), (index_t)max_elem + 1, _suff_arr.data(), exec);
+            }
         }
     }
 
-    void build_inverse_suffix_array() {
+    template<typename EXEC>
+    void build_inverse_suffix_array(const EXEC& exec) {
         index_t n = size();
         _suff_ord.resize(n + 1);
-        for (index_t i = 0; i <= n; i++) {
-            _suff_ord[_suff_arr[i]] = i;
-        }
+        exec(0, (int)n + 1, [&](int i0, int i1) {
+            for (index_t i = i0; i < i1; i++) {
+                _suff_ord[_suff_arr[i]] = i;
+            }
+        });
     }
 
     // Construction by SA-IS algorithm
 
-    template<typename alphat>
-    static void sa_is(const alphat *str, index_t n, index_t alpha_size, index_t *sa) {
+    template<typename alphat, typename EXEC>
+    static void sa_is(const alphat *str, index_t n, index_t alpha_size, index_t *sa, const EXEC& exec) {
         std::vector<index_t> bucket_offsets(std::max(alpha_size, (n + 1) / 2) + 1);
-        sa_is<alphat>(str, n, alpha_size, sa, bucket_offsets);
+        sa_is<alphat>(str, n, alpha_size, sa, bucket_offsets, exec);
     }
 
-    template<typename alphat>
-    static void sa_is(const alphat *str, index_t n, index_t alpha_size, index_t *sa, std::vector<index_t>& bucket_offsets) {
+    template<typename alphat, typename EXEC>
+    static void sa_is(const alphat *str, index_t n, index_t alpha_size, index_t *sa, std::vector<index_t>& bucket_offsets, const EXEC& exec) {
+        // a bit per position; only read by the parallel naming below
         std::vector<bool> types(n + 1);
         types[n - 1] = 0; types[n] = 1;
         for (index_t i = n - 2; i >= 0; i--) {
@@ -89,7 +123,7 @@ private:
             if (types[i] && !types[i - 1]) sa[--bucket_offsets[(index_t)str[i]]] = i;
         }
         sa[0] = n;
-        induced_sort(str, n, alpha_size, types, sa, bucket_offsets);
+        induced_sort(str, n, alpha_size, types, sa, bucket_offsets, exec);
 
         index_t n1 = 0;
         for (index_t i = 0; i <= n; i++) {
@@ -99,28 +133,19 @@ private:
 
         index_t *buffer = sa + n1;
         std::fill(buffer, sa + n + 1, -1);
-        index_t unique_lms_count = 0, prev_pos = -1;
+        // each sorted LMS substring is compared to its predecessor independently;
+        // the flags get stored at the name positions and then turned into names
+        exec(1, (int)n1, [&](int i0, int i1) {
+            for (index_t i = i0; i < i1; i++) {
+                buffer[sa[i] / 2] = (i == 1 || lms_substrings_differ(str, n, types, sa[i], sa[i - 1])) ? 1 : 0;
+            }
+        });
+        index_t unique_lms_count = 0;
         buffer[sa[0] / 2] = unique_lms_count++;
         for (index_t i = 1; i < n1; i++) {
-            index_t pos = sa[i];
-            bool diff = false;
-            if (prev_pos == -1) {
-                diff = true;
-            } else {
-                for (index_t j = pos, k = prev_pos;; j++, k++) {
-                    if (str[j] != str[k] || types[j] != types[k]) {
-                        diff = true;
-                        break;
-                    } else if (j != pos && ((types[j] && !types[j - 1]) || (types[k] && !types[k - 1]))) {
-                        break;
-                    }
-                }
-            }
-            if (diff) {
-                unique_lms_count++;
-                prev_pos = pos;
-            }
-            buffer[pos / 2] = unique_lms_count - 1;
+            index_t& name = buffer[sa[i] / 2];
+            unique_lms_count += name;
+            name = unique_lms_count - 1;
         }
         for (index_t i = n, j = n; i >= n1; i--) {
             if (sa[i] >= 0) sa[j--] = sa[i];
@@ -130,7 +155,7 @@ private:
         if (unique_lms_count == n1) {
             for (index_t i = 0; i < n1; i++) sa1[s1[i]] = i;
         } else {
-            sa_is<index_t>(s1, n1 - 1, unique_lms_count, sa1, bucket_offsets);
+            sa_is<index_t>(s1, n1 - 1, unique_lms_count, sa1, bucket_offsets, exec);
         }
 
         count_alphabets(str, n, alpha_size, bucket_offsets);
@@ -144,20 +169,71 @@ private:
             index_t j = sa[i]; sa[i] = -1;
             sa[--bucket_offsets[(index_t)str[j]]] = j;
         }
-        induced_sort(str, n, alpha_size, types, sa, bucket_offsets);
+        induced_sort(str, n, alpha_size, types, sa, bucket_offsets, exec);
     }
 
+    // compares the LMS substrings starting at `pos1` and `pos2`;
+    // the sentinel at `n` is unique, so it differs from everything else
     template<typename alphat>
-    static void induced_sort(const alphat *str, index_t n, index_t alpha_size, const std::vector<bool>& types, index_t *sa, std::vector<index_t>& bucket_offsets) {
+    static bool lms_substrings_differ(const alphat *str, index_t n, const std::vector<bool>& types, index_t pos1, index_t pos2) {
+        for (index_t j = pos1, k = pos2;; j++, k++) {
+            if (j == n || k == n) {
+                return true;
+            } else if (str[j] != str[k] || types[j] != types[k]) {
+                return true;
+            } else if (j != pos1 && ((types[j] && !types[j - 1]) || (types[k] && !types[k - 1]))) {
+                return false;
+            }
+        }
+    }
+
+    // the suffixes read for a block of the induced sorting
+    struct induce_buffer {
+        std::vector<index_t> seen;   // the slot as it was read
+        std::vector<index_t> pred;   // the preceding position to place; -1 if none
+        std::vector<index_t> bucket; // the character at `pred`
+    };
+
+    // induces the L-type suffixes left to right, and then the S-type suffixes right to left
+    template<typename alphat, typename EXEC>
+    static void induced_sort(const alphat *str, index_t n, index_t alpha_size, const std::vector<bool>& types, index_t *sa, std::vector<index_t>& bucket_offsets, const EXEC& exec) {
+        index_t block = std::max(index_t(1), std::min(n + 1, induce_block_size));
+        induce_buffer buf{ std::vector<index_t>(block), std::vector<index_t>(block), std::vector<index_t>(block) };
         get_bucket_offsets(str, n, false, alpha_size, bucket_offsets);
-        for (index_t i = 0; i < n; i++) {
-            index_t j = sa[i] - 1;
-            if (j >= 0 && !types[j]) sa[bucket_offsets[(index_t)str[j]]++] = j;
+        for (index_t b = 0; b < n; b += block) {
+            induce_block(str, types, sa, bucket_offsets, false, b, std::min(n, b + block), buf, exec);
         }
         get_bucket_offsets(str, n, true, alpha_size, bucket_offsets);
-        for (index_t i = n; i >= 1; i--) {
-            index_t j = sa[i] - 1;
-            if (j >= 0 && types[j]) sa[--bucket_offsets[(index_t)str[j]]] = j;
+        for (index_t e = n + 1; e > 1; e -= block) {
+            induce_block(str, types, sa, bucket_offsets, true, std::max(index_t(1), e - block), e, buf, exec);
+        }
+    }
+
+    // places the suffixes preceding those in the slots `[b, e)`, if of the type `stype`;
+    // the L-type ones go to the bucket fronts, after their slot, and the S-type ones to the bucket backs, before it
+    template<typename alphat, typename EXEC>
+    static void induce_block(const alphat *str, const std::vector<bool>& types, index_t *sa, std::vector<index_t>& bucket_offsets, bool stype, index_t b, index_t e, induce_buffer& buf, const EXEC& exec) {
+        auto read = [&](index_t v, index_t& j, index_t& c) {
+            j = v - 1;
+            if (j >= 0 && types[j] == stype) c = (index_t)str[j]; else j = -1;
+        };
+        exec(0, int(e - b), [&](int k0, int k1) {
+            for (index_t k = k0; k < k1; k++) {
+                buf.seen[k] = sa[b + k];
+                read(buf.seen[k], buf.pred[k], buf.bucket[k]);
+            }
+        });
+        for (index_t k = 0; k < e - b; k++) {
+            index_t kk = stype ? e - b - 1 - k : k;
+            index_t j = buf.pred[kk], c = buf.bucket[kk];
+            // written by this block after it got read
+            if (sa[b + kk] != buf.seen[kk]) read(sa[b + kk], j, c);
+            if (j < 0) continue;
+            if (stype) {
+                sa[--bucket_offsets[c]] = j;
+            } else {
+                sa[bucket_offsets[c]++] = j;
+            }
         }
     }
 
@@ -200,19 +276,24 @@ private:
     // computes the length of the largest-common-prefix
     // for each pair of successive (sorted) suffixes and
     // preprocesses range-minimum-query for lcp array
-    void build_lcp_array() {
+    template<typename EXEC>
+    void build_lcp_array(const EXEC& exec) {
         index_t n = size();
         std::vector<index_t> _lcp_arr(n + 2);
-        index_t h = 0;
-        for (index_t i = 0; i < n; i++) {
-            index_t ord = _suff_ord[i];
-            index_t j = _suff_arr[ord - 1];
-            index_t hmax = std::min(n - j, n - i);
-            for (index_t k = 0; h < hmax && _string[i + h] == _string[j + h]; ++h);
-            _lcp_arr[ord - 1] = h;
-            if (h > 0) --h;
-        }
-        _lcp_arr_rmq.build(_lcp_arr.begin(), _lcp_arr.end());
+        // Kasai: the lcp decreases by at most one from position `i` to `i + 1`;
+        // each chunk of positions starts its scan from zero
+        exec(0, (int)n, [&](int i0, int i1) {
+            index_t h = 0;
+            for (index_t i = i0; i < i1; i++) {
+                index_t ord = _suff_ord[i];
+                index_t j = _suff_arr[ord - 1];
+                index_t hmax = std::min(n - j, n - i);
+                for (; h < hmax && _string[i + h] == _string[j + h]; ++h);
+                _lcp_arr[ord - 1] = h;
+                if (h > 0) --h;
+            }
+        });
+        _lcp_arr_rmq.build(std::move(_lcp_arr));
     }
 
 public:
@@ -250,6 +331,8 @@ public:
     // note that there is one more suffix, the empty one.
     index_t size() const { return (index_t)_string.size(); }
 };
+template<typename ALPHA_T, typename INDEX_T>
+INDEX_T suffix_array<ALPHA_T, INDEX_T>::induce_block_size = 1 << 16;
 
 } // container
 } // altruct
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "altruct/algorithm/math/intrinsic.h"
+#include "altruct/structure/container/append_only_array.h"
+
 #include <stdint.h>
 #include <type_traits>
 #include <array>
+#include <mutex>
 #include <vector>
 
 namespace altruct {
@@ -10,29 +14,39 @@ namespace hash {
 
 /**
  * Polynomial hash with only 1 base.
+ *
+ * The power tables are shared by all the hashes of the type, and are thread-safe;
+ * see `polynomial_hash`.
  */
 template<int32_t M, int32_t B, int32_t BI>
 class polynomial_hash1 {
     typedef int32_t I;
     typedef int64_t IT;
 public:
-    static std::vector<I> W;
-    static std::vector<I> WI;
+    typedef container::append_only_array<I> table_t;
+    static table_t W;
+    static table_t WI;
+    static std::mutex table_mutex;
 
-    static void _ensure(std::vector<I>& w, size_t sz, I b) {
+    static void _ensure(table_t& w, size_t sz, I b) {
         size_t i0 = w.size();
-        w.resize(sz);
+        w.reserve(sz);
         if (i0 == 0) w[i0++] = 1;
         for (size_t i = i0; i < sz; i++) {
             w[i] = (w[i - 1] * IT(b)) % M;
         }
     }
 
+    // `W` gets published last, as its size is what the readers check
     static void ensure(size_t size) {
+        if (W.size() >= size) return;
+        std::lock_guard<std::mutex> lock(table_mutex);
         if (W.size() >= size) return;
         size = std::max(size, W.size() + W.size() / 2);
         _ensure(W, size, B);
         _ensure(WI, size, BI);
+        WI.resize(size);
+        W.resize(size);
     }
 
 
@@ -59,14 +73,98 @@ public:
 
     int32_t hash() const { return h; }
 };
-template<int32_t M, int32_t B, int32_t BI> std::vector<int32_t> polynomial_hash1<M, B, BI>::W;
-template<int32_t M, int32_t B, int32_t BI> std::vector<int32_t> polynomial_hash1<M, B, BI>::WI;
+template<int32_t M, int32_t B, int32_t BI> typename polynomial_hash1<M, B, BI>::table_t polynomial_hash1<M, B, BI>::W;
+template<int32_t M, int32_t B, int32_t BI> typename polynomial_hash1<M, B, BI>::table_t polynomial_hash1<M, B, BI>::WI;
+template<int32_t M, int32_t B, int32_t BI> std::mutex polynomial_hash1<M, B, BI>::table_mutex;
+
+
+/**
+ * Polynomial hash modulo the Mersenne prime `2^61 - 1`, with only 1 base.
+ *
+ * The reduction modulo `2^61 - 1` takes a shift and an addition instead of a division,
+ * and a single 61-bit modulus collides about as rarely as two 31-bit ones.
+ * The base inverse gets computed on the first use.
+ */
+template<uint64_t B>
+class polynomial_hash_m61 {
+    typedef uint64_t I;
+public:
+    static const I M = (I(1) << 61) - 1;
+    typedef container::append_only_array<I> table_t;
+    static table_t W;
+    static table_t WI;
+    static std::mutex table_mutex;
+
+    static I mul(I a, I b) {
+        I hi, lo = math::mul_128(a, b, &hi);
+        return add_mod(lo & M, (lo >> 61) | (hi << 3));
+    }
+    static I add_mod(I a, I b) { I r = a + b; return (r >= M) ? r - M : r; }
+    static I sub_mod(I a, I b) { return (a >= b) ? a - b : a + M - b; }
+
+    static void _ensure(table_t& w, size_t sz, I b) {
+        size_t i0 = w.size();
+        w.reserve(sz);
+        if (i0 == 0) w[i0++] = 1;
+        for (size_t i = i0; i < sz; i++) {
+            w[i] = mul(w[i - 1], b);
+        }
+    }
+
+    // `W` gets published last, as its size is what the readers check
+    static void ensure(size_t size) {
+        if (W.size() >= size) return;
+        std::lock_guard<std::mutex> lock(table_mutex);
+        if (W.size() >= size) return;
+        size = std::max(size, W.size() + W.size() / 2);
+        I bi = 1; // B^(M-2)
+        for (I e = M - 2, b = B % M; e > 0; e >>= 1, b = mul(b, b)) {
+            if (e & 1) bi = mul(bi, b);
+        }
+        _ensure(W, size, B % M);
+        _ensure(WI, size, bi);
+        WI.resize(size);
+        W.resize(size);
+    }
+
+
+    I h;
+
+    polynomial_hash_m61(I h = 0) : h(h % M) {}
+    polynomial_hash_m61 clone() const { return polynomial_hash_m61(*this); }
+    bool operator < (const polynomial_hash_m61& rhs) const { return h < rhs.h; }
+    bool operator == (const polynomial_hash_m61& rhs) const { return h == rhs.h; }
+    polynomial_hash_m61 operator * (const polynomial_hash_m61& rhs) const { return clone() *= rhs; }
+    polynomial_hash_m61 operator + (const polynomial_hash_m61& rhs) const { return clone() += rhs; }
+    polynomial_hash_m61 operator - (const polynomial_hash_m61& rhs) const { return clone() -= rhs; }
+    polynomial_hash_m61 operator >> (int cnt) const { return clone() >>= cnt; } // divide by B^cnt
+    polynomial_hash_m61 operator << (int cnt) const { return clone() <<= cnt; } // multiply by B^cnt
+    polynomial_hash_m61& operator *= (const polynomial_hash_m61& rhs) { h = mul(h, rhs.h); return *this; }
+    polynomial_hash_m61& operator += (const polynomial_hash_m61& rhs) { h = add_mod(h, rhs.h); return *this; }
+    polynomial_hash_m61& operator -= (const polynomial_hash_m61& rhs) { h = sub_mod(h, rhs.h); return *this; }
+    polynomial_hash_m61& operator >>= (int cnt) { ensure(cnt + 1); h = mul(h, WI[cnt]); return *this; }
+    polynomial_hash_m61& operator <<= (int cnt) { ensure(cnt + 1); h = mul(h, W[cnt]); return *this; }
+    // H = H + (RHS << pos)
+    polynomial_hash_m61& add(const polynomial_hash_m61& rhs, size_t pos) { ensure(pos + 1); h = add_mod(h, mul(rhs.h, W[pos])); return *this; }
+    // H = (H - RHS) >> pos
+    polynomial_hash_m61& sub_shr(const polynomial_hash_m61& rhs, size_t pos) { ensure(pos + 1); h = mul(sub_mod(h, rhs.h), WI[pos]); return *this; }
+
+    uint64_t hash() const { return h; }
+};
+template<uint64_t B> typename polynomial_hash_m61<B>::table_t polynomial_hash_m61<B>::W;
+template<uint64_t B> typename polynomial_hash_m61<B>::table_t polynomial_hash_m61<B>::WI;
+template<uint64_t B> std::mutex polynomial_hash_m61<B>::table_mutex;
 
 
 /**
  * Polynomial hash with `K` bases.
  *
  * `M`, `B`, `BI` must be defined by the client.
+ *
+ * The tables of the powers of `B` and `BI` are shared by all the hashes of the type.
+ * They are thread-safe, so that different threads can hash different sequences:
+ * the tables are append-only and never move their entries; the readers check
+ * the published size without locking, and only the growth is serialized by a mutex.
  */
 template<size_t K, typename I = int32_t, typename IT = int64_t>
 class polynomial_hash {
@@ -75,33 +173,66 @@ public:
     static I B[K];  // bases
     static I BI[K]; // base inverses; B * BI == 1 (mod M)
 
-    static std::vector<I> W[K];
-    static std::vector<I> WI[K];
+    typedef container::append_only_array<I> table_t;
+    static table_t W[K];
+    static table_t WI[K];
+    static uint64_t MR[K]; // Barrett reciprocals; floor((2^64 - 1) / M)
+    static std::mutex table_mutex;
 
     static I mul(I a, I b, I m) { return (I)((a * (IT)b) % m); }
     static I mul(I s, I a, I b, I m) { return (I)((s + a * (IT)b) % m); }
 
-    static void _ensure(std::vector<I>& w, size_t sz, I b, I m) {
-        size_t i0 = w.size();
-        w.resize(sz);
-        if (i0 == 0) {
-            w[i0++] = 1;
-        }
-        for (size_t i = i0; i < sz; i++) {
-            w[i] = mul(w[i - 1], b, m);
-        }
-    }
+    // same as `mul` modulo `M[k]`, but with Barrett reduction when `IT` is a 64-bit integer;
+    // valid only once the tables got ensured (i.e. `MR` got initialized).
+    // Used for the sequential recurrences (the power tables, and `add` for cumulative hashes),
+    // where the latency of the division dominates; the independent reductions (e.g. in `sub_shr`)
+    // are not faster than the division on their own.
+    static I mul_k(int k, I a, I b) { return reduce(k, a * (IT)b, use_barrett()); }
+    static I mul_k(int k, I s, I a, I b) { return reduce(k, s + a * (IT)b, use_barrett()); }
 
     static void ensure(size_t size) {
+        if (W[0].size() >= size) return;
+        std::lock_guard<std::mutex> lock(table_mutex);
         size_t curr_size = W[0].size();
         if (curr_size >= size) return;
         size = std::max(size, curr_size + curr_size / 2);
         for (int k = 0; k < K; k++) {
-            _ensure(W[k], size, B[k], M[k]);
-            _ensure(WI[k], size, BI[k], M[k]);
+            W[k].reserve(size);
+            WI[k].reserve(size);
+            if (curr_size == 0) {
+                MR[k] = ~uint64_t(0) / uint64_t(M[k]);
+                W[k][0] = WI[k][0] = 1;
+            }
+        }
+        // the lanes are independent, so interleaving them overlaps their multiplications
+        for (size_t i = std::max(curr_size, size_t(1)); i < size; i++) {
+            for (int k = 0; k < K; k++) {
+                W[k][i] = mul_k(k, W[k][i - 1], B[k]);
+                WI[k][i] = mul_k(k, WI[k][i - 1], BI[k]);
+            }
+        }
+        // `W[0]` gets published last, as its size is what the readers check
+        for (int k = K - 1; k >= 0; k--) {
+            WI[k].resize(size);
+            W[k].resize(size);
         }
     }
 
+    typedef std::integral_constant<bool, std::is_integral<IT>::value && sizeof(IT) == 8> use_barrett;
+
+    static I reduce(int k, IT x, std::false_type) {
+        return I(x % M[k]);
+    }
+
+    // for `0 <= x < 2^64` the quotient estimate `x * MR / 2^64` is off by at most one
+    static I reduce(int k, IT x, std::true_type) {
+        if (x < 0) return I(x % M[k]);
+        uint64_t q, m = uint64_t(M[k]);
+        math::mul_128(uint64_t(x), MR[k], &q);
+        uint64_t r = uint64_t(x) - q * m;
+        return I((r >= m) ? r - m : r);
+    }
+
 
     std::array<I, K> h;
 
@@ -208,7 +339,7 @@ public:
     polynomial_hash& add(I rhs, size_t pos) {
         ensure(pos + 1);
         for (int k = 0; k < K; k++) {
-            h[k] = mul(h[k], rhs, W[k][pos], M[k]);
+            h[k] = mul_k(k, h[k], rhs, W[k][pos]);
         }
         return *this;
     }
@@ -217,7 +348,7 @@ public:
     polynomial_hash& add(const polynomial_hash& rhs, size_t pos) {
         ensure(pos + 1);
         for (int k = 0; k < K; k++) {
-            h[k] = mul(h[k], rhs.h[k], W[k][pos], M[k]);
+            h[k] = mul_k(k, h[k], rhs.h[k], W[k][pos]);
         }
         return *this;
     }
@@ -246,9 +377,13 @@ public:
 };
 
 template<size_t K, typename I, typename IT>
-std::vector<I> polynomial_hash<K, I, IT>::W[K];
+typename polynomial_hash<K, I, IT>::table_t polynomial_hash<K, I, IT>::W[K];
+template<size_t K, typename I, typename IT>
+typename polynomial_hash<K, I, IT>::table_t polynomial_hash<K, I, IT>::WI[K];
+template<size_t K, typename I, typename IT>
+uint64_t polynomial_hash<K, I, IT>::MR[K];
 template<size_t K, typename I, typename IT>
-std::vector<I> polynomial_hash<K, I, IT>::WI[K];
+std::mutex polynomial_hash<K, I, IT>::table_mutex;
 
 /**
  * Cumulative hashes of a sequence (e.g. of a string).
@@ -277,8 +412,9 @@ public:
     template<typename It>
     void assign(It begin, It end) {
         HASH h;
-        size_t pos = 0;
-        h.ensure(std::distance(begin, end));
+        size_t pos = 0, n = std::distance(begin, end);
+        h.ensure(n);
+        vh.reserve(vh.size() + n);
         for (It it = begin; it != end; ++it) {
             h.add(*it, pos++);
             vh.push_back(h);
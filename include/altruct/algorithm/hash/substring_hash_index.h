@@ -0,0 +1,236 @@
+#pragma once
+
+#include "altruct/algorithm/hash/polynomial_hash.h"
+#include "altruct/concurrency/executor.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace altruct {
+namespace hash {
+
+/**
+ * Index of the substrings of the given lengths by their rolling hashes.
+ *
+ * For each of the requested window lengths `L`, there is an open-addressing
+ * hash table from the hash of a window to the first of its occurrences,
+ * and the occurrences of the same window are linked in the increasing order.
+ * The hashes of the windows are taken from a `cumulative_hash` of the sequence;
+ * an index constructed from a `cumulative_hash` refers to it rather than copying it,
+ * so it must outlive the index.
+ * The tables of different lengths are built independently, through the given executor.
+ *
+ * Note: the windows are compared only by their hashes, so a multi-modulus
+ * `HASH` (e.g. `polynomial_hash<2>`) is recommended to keep the collisions unlikely.
+ *
+ * Space complexity: `O(n)` per length.
+ * Time complexities:
+ *   build:   `O(n)` per length
+ *   find:    `O(1)` expected, plus the number of occurrences
+ *   repeats: `O(n)`
+ *
+ * param HASH    - the underlying hash type, see `cumulative_hash`
+ * param INDEX_T - position type
+ */
+template<typename HASH, typename INDEX_T = int>
+class substring_hash_index {
+public:
+    typedef HASH hash_t;
+    typedef INDEX_T index_t;
+    typedef cumulative_hash<HASH> cumulative_hash_t;
+
+    struct table {
+        index_t len;
+        int shift;
+        std::vector<index_t> slots; // the first occurrence of a window; -1 if empty
+        std::vector<index_t> next;  // the next occurrence of the same window; -1 if none
+    };
+
+protected:
+    cumulative_hash_t own_ch;       // when constructed from the sequence
+    const cumulative_hash_t* ch;    // the caller's cumulative hash; `nullptr` if `own_ch` is used
+    std::vector<table> tables;      // sorted by the length
+
+public:
+    // indexes the windows of the given lengths of the sequence `[begin, end)`;
+    // `exec` runs the table builds, one per length, see `concurrency::serial_range_executor`
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    substring_hash_index(It begin, It end, std::vector<index_t> lengths, const EXEC& exec = EXEC()) : own_ch(begin, end), ch(nullptr) {
+        build(lengths, exec);
+    }
+
+    // indexes the windows of the given lengths of the sequence hashed by `ch`, which must outlive the index
+    template<typename EXEC = concurrency::serial_range_executor>
+    substring_hash_index(const cumulative_hash_t& ch, std::vector<index_t> lengths, const EXEC& exec = EXEC()) : ch(&ch) {
+        build(lengths, exec);
+    }
+
+    // the length of the indexed sequence
+    index_t size() const { return index_t(hashes().size()); }
+
+    // the underlying cumulative hash, e.g. for hashing the patterns
+    const cumulative_hash_t& hashes() const { return ch ? *ch : own_ch; }
+
+    // whether the windows of the given length are indexed
+    bool has_length(index_t len) const { return find_table(len) != nullptr; }
+
+    // returns the first occurrence of the window of the given length and hash, or -1 if there is none;
+    // the next ones are given by `next_occurrence`; always -1 if the length is not indexed
+    index_t first_occurrence(const HASH& h, index_t len) const {
+        const table* pt = find_table(len);
+        if (!pt || pt->slots.empty()) return -1;
+        const table& t = *pt;
+        size_t mask = t.slots.size() - 1;
+        for (size_t s = slot_of(h, t.shift); t.slots[s] >= 0; s = (s + 1) & mask) {
+            index_t i = t.slots[s];
+            if (window(i, len) == h) return i;
+        }
+        return -1;
+    }
+
+    // returns the next occurrence of the same window after the occurrence `i`, or -1 if there is none
+    index_t next_occurrence(index_t i, index_t len) const {
+        const table* pt = find_table(len);
+        return pt ? pt->next[i] : -1;
+    }
+
+    // returns all the occurrences of the window of the given length and hash, in the increasing order
+    std::vector<index_t> find(const HASH& h, index_t len) const {
+        std::vector<index_t> r;
+        for (index_t i = first_occurrence(h, len); i >= 0; i = next_occurrence(i, len)) r.push_back(i);
+        return r;
+    }
+
+    // returns all the occurrences of the pattern `[begin, end)`; none if its length is not indexed
+    template<typename It>
+    std::vector<index_t> find(It begin, It end) const {
+        HASH h;
+        size_t pos = 0;
+        for (It it = begin; it != end; ++it) h.add(*it, pos++);
+        return find(h, index_t(pos));
+    }
+
+    // returns the first occurrence of each window of the given length that occurs more than once,
+    // in the increasing order; the other occurrences are given by `next_occurrence`;
+    // empty if the length is not indexed
+    std::vector<index_t> repeats(index_t len) const {
+        std::vector<index_t> r;
+        const table* pt = find_table(len);
+        if (!pt) return r;
+        const table& t = *pt;
+        std::vector<char> seen(t.next.size());
+        for (index_t i = 0; i < index_t(t.next.size()); i++) {
+            if (seen[i] || t.next[i] < 0) continue;
+            r.push_back(i);
+            for (index_t j = i; j >= 0; j = t.next[j]) seen[j] = 1;
+        }
+        return r;
+    }
+
+    // returns the first occurrence of the first window of the given length that occurs more than once,
+    // or -1 if there is none or if the length is not indexed
+    index_t first_repeat(index_t len) const {
+        const table* pt = find_table(len);
+        if (!pt) return -1;
+        const table& t = *pt;
+        for (index_t i = 0; i < index_t(t.next.size()); i++) {
+            if (t.next[i] >= 0) return i;
+        }
+        return -1;
+    }
+
+private:
+    template<typename EXEC>
+    void build(std::vector<index_t>& lengths, const EXEC& exec) {
+        std::sort(lengths.begin(), lengths.end());
+        lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+        tables.resize(lengths.size());
+        exec(0, int(lengths.size()), [&](int l0, int l1) {
+            for (int l = l0; l < l1; l++) build_table(tables[l], lengths[l]);
+        });
+    }
+
+    void build_table(table& t, index_t len) {
+        t.len = len;
+        index_t m = (len >= 0 && len <= size()) ? size() - len + 1 : 0;
+        int bits = 1;
+        while ((size_t(1) << bits) < 2 * size_t(m)) bits++;
+        t.shift = 64 - bits;
+        t.slots.assign(m ? size_t(1) << bits : 0, -1);
+        t.next.assign(m, -1);
+        if (m == 0) return;
+        std::vector<HASH> wh(m);
+        for (index_t i = 0; i < m; i++) wh[i] = window(i, len);
+        size_t mask = t.slots.size() - 1;
+        // backwards, so that each window gets prepended to the occurrences that follow it
+        for (index_t i = m - 1; i >= 0; i--) {
+            size_t s = slot_of(wh[i], t.shift);
+            while (t.slots[s] >= 0 && !(wh[t.slots[s]] == wh[i])) s = (s + 1) & mask;
+            t.next[i] = t.slots[s];
+            t.slots[s] = i;
+        }
+    }
+
+    const table* find_table(index_t len) const {
+        auto it = std::lower_bound(tables.begin(), tables.end(), len, [](const table& t, index_t l) { return t.len < l; });
+        return (it != tables.end() && it->len == len) ? &*it : nullptr;
+    }
+
+    HASH window(index_t i, index_t len) const {
+        return hashes().get(size_t(i), size_t(i + len));
+    }
+
+    static size_t slot_of(const HASH& h, int shift) {
+        return size_t((uint64_t(h.hash()) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+};
+
+/**
+ * Longest substring that occurs at least twice (the occurrences may overlap),
+ * by a search on the length over `substring_hash_index`.
+ *
+ * A repeat of length `L` implies a repeat of each shorter length, so the lengths
+ * that have a repeat form a prefix. Each round indexes `probes` evenly spaced lengths
+ * of the remaining range at once, through the given executor, and narrows the range
+ * to `1 / (probes + 1)`. With `probes = 1` this is a binary search.
+ *
+ * @return `{length, position}` of the first such substring; `{0, 0}` if there is no repeat
+ */
+template<typename HASH, typename INDEX_T = int, typename EXEC = concurrency::serial_range_executor>
+std::pair<INDEX_T, INDEX_T> longest_repeated_substring(const cumulative_hash<HASH>& ch, int probes = 1, const EXEC& exec = EXEC()) {
+    typedef substring_hash_index<HASH, INDEX_T> index_type;
+    std::pair<INDEX_T, INDEX_T> best(0, 0);
+    INDEX_T lo = 1, hi = INDEX_T(ch.size()) - 1; // the answer is in `[lo - 1, hi]`
+    while (lo <= hi) {
+        std::vector<INDEX_T> lengths;
+        INDEX_T k = std::min(INDEX_T(probes), hi - lo + 1);
+        for (INDEX_T j = 1; j <= k; j++) {
+            lengths.push_back(lo + (hi - lo + 1) * j / (k + 1));
+        }
+        // refers to `ch`, so each round only builds the tables
+        index_type index(ch, lengths, exec);
+        INDEX_T lo2 = lo, hi2 = hi;
+        for (INDEX_T len : lengths) {
+            INDEX_T i = index.first_repeat(len);
+            if (i >= 0) {
+                best = { len, i };
+                lo2 = std::max(lo2, len + 1);
+            } else {
+                hi2 = std::min(hi2, len - 1);
+            }
+        }
+        lo = lo2, hi = hi2;
+    }
+    return best;
+}
+
+template<typename HASH, typename INDEX_T = int, typename It, typename EXEC = concurrency::serial_range_executor>
+std::pair<INDEX_T, INDEX_T> longest_repeated_substring(It begin, It end, int probes = 1, const EXEC& exec = EXEC()) {
+    return longest_repeated_substring<HASH, INDEX_T>(cumulative_hash<HASH>(begin, end), probes, exec);
+}
+
+}
+}
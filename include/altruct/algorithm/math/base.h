@@ -115,6 +115,26 @@ struct conjugateT {
     }
 };
 
+/**
+ * Dot product: `s + Sum[a[i * sa] * b[i * sb], {i, 0, n-1}]`.
+ *
+ * Specialize this template for a custom or tweaked implementation;
+ * e.g. for types that can defer the normalization to the end of the sum.
+ * The terms must be accumulated in the order of increasing `i`.
+ *
+ * Note: implemented as a class because C++ doesn't allow
+ * partial template specializations for functions.
+ */
+template<typename T, typename ENABLE = void>
+struct dot_product {
+    static T impl(T s, const T* a, int sa, const T* b, int sb, int n) {
+        for (int i = 0; i < n; i++) {
+            s += a[i * sa] * b[i * sb];
+        }
+        return s;
+    }
+};
+
 /**
  * Absolute value.
  */
@@ -1,20 +1,144 @@
 #pragma once
 
 #include "base.h"
+#include "primes.h"
+#include "altruct/concurrency/executor.h"
 #include "altruct/structure/math/modulo.h"
+#include "altruct/structure/math/montgomery.h"
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <string>
+#include <type_traits>
 
 namespace altruct {
 namespace math {
 
+/**
+ * Whether `I` is an integral type that fits in 64 bits,
+ * so that `montgomery64` can be used for the modular arithmetic.
+ */
+template<typename I>
+struct is_montgomery64_compatible : std::integral_constant<bool, std::is_integral<I>::value && sizeof(I) <= sizeof(uint64_t)> {};
+
+/**
+ * Modular arithmetic over the plain residues, with the same interface as `montgomery`.
+ * Used for the types that `montgomery` does not support.
+ */
+template<typename I>
+struct modulo_context {
+    I n;
+
+    modulo_context(const I& n) : n(n) {}
+
+    I to(const I& x) const { return x % n; }
+    I from(const I& x) const { return x; }
+    I one() const { return I(1); }
+
+    I mul(const I& x, const I& y) const { return modulo_mul(x, y, n); }
+    I add(const I& x, const I& y) const { return modulo_add(x, y, n); }
+    I sub(const I& x, const I& y) const { return modulo_sub(x, y, n); }
+    I pow(I x, I e) const {
+        I r = one();
+        for (; e > 0; e /= 2) {
+            if (e % 2 == 1) r = mul(r, x);
+            x = mul(x, x);
+        }
+        return r;
+    }
+};
+
+/**
+ * The modular arithmetic for an odd modulus of type `I`, and the word type it operates on:
+ * `montgomery64` for the integral types of up to 64 bits, `montgomery128` for
+ * the 128-bit integers where supported, and `modulo_context<I>` otherwise.
+ */
+template<typename I, typename = void>
+struct modular_arithmetic {
+    typedef modulo_context<I> type;
+    typedef I word;
+};
+template<typename I>
+struct modular_arithmetic<I, std::enable_if_t<is_montgomery64_compatible<I>::value>> {
+    typedef montgomery64 type;
+    typedef uint64_t word;
+};
+#if defined(__SIZEOF_INT128__)
+template<>
+struct modular_arithmetic<__int128> {
+    typedef montgomery128 type;
+    typedef unsigned __int128 word;
+};
+template<>
+struct modular_arithmetic<unsigned __int128> {
+    typedef montgomery128 type;
+    typedef unsigned __int128 word;
+};
+#endif
+
+/**
+ * Whether `x = b^d` passes the strong probable prime test to the base `b`, where `n-1 = 2^r * d`.
+ */
+template<typename CTX, typename E>
+bool miller_rabin_pass(const CTX& ctx, E x, int r, const E& one, const E& minus_one) {
+    if (x == one || x == minus_one) return true;
+    for (int j = 1; j < r; j++) {
+        x = ctx.mul(x, x);
+        if (x == one || x == minus_one) break;
+    }
+    return x == minus_one;
+}
+
+/**
+ * Miller-Rabin primality test core; `n` is odd.
+ *
+ * The first base alone rejects most of the composites. The exponentiations
+ * of the remaining bases are independent, so they get interleaved in groups
+ * of `LANES` to keep several multiplications in flight.
+ */
+template<typename T>
+bool miller_rabin_odd(const T& n, const T* bases) {
+    typedef typename modular_arithmetic<T>::word E;
+    const int LANES = 4;
+    E d = E(n) - 1; int r = 0; // n-1 = 2^r * d
+    while (d % 2 == 0) d /= 2, r++;
+    typename modular_arithmetic<T>::type ctx{ E(n) };
+    E one = ctx.one(), minus_one = ctx.sub(E(0), one);
+    for (int i = 0, k = 1; bases[i] && bases[i] < n; k = LANES) {
+        E x[LANES], y[LANES];
+        int m = 0;
+        for (; m < k && bases[i + m] && bases[i + m] < n; m++) {
+            x[m] = ctx.to(E(bases[i + m]));
+        }
+        if (m == 1) {
+            y[0] = ctx.pow(x[0], d);
+        } else {
+            // the unused lanes just repeat the first one
+            for (int j = m; j < LANES; j++) x[j] = x[0];
+            for (int j = 0; j < LANES; j++) y[j] = one;
+            for (E e = d; e > 0; e /= 2) {
+                for (int j = 0; j < LANES; j++) {
+                    if (e % 2 == 1) y[j] = ctx.mul(y[j], x[j]);
+                    x[j] = ctx.mul(x[j], x[j]);
+                }
+            }
+        }
+        for (int j = 0; j < m; j++) {
+            if (!miller_rabin_pass(ctx, y[j], r, one, minus_one)) return false; // composite
+        }
+        i += m;
+    }
+    return true; // probably prime
+}
+
 /**
  * Miller-Rabin primality test.
  *
  * Probabilistic primality test with accuracy `4^-k`, where `k` is the number of bases tested.
+ * Integral types of up to 64 bits (and 128 bits where supported) use Montgomery multiplication.
  *
- * Complexity: O(p^(1/2)) <= O(n^(1/4)), where `p` is the smallest prime factor of `n`.
+ * Complexity: O(k log n) modular multiplications.
  *
  * @param n - number to test for primality
  * @param bases - a null-terminated array of bases to test against.
@@ -25,19 +149,7 @@ bool miller_rabin(const T& n, const T* bases) {
     if (n == 0 || n == 1) return 0;
     if (n == 2 || n == 3) return 1;
     if ((n % 2) == 0) return 0;
-    typedef moduloX<T> modx;
-    T d = n - 1; int r = 0; // n-1 = 2^r * d
-    while (d % 2 == 0) d /= 2, r++;
-    for (int i = 0; bases[i] && bases[i] < n; i++) {
-        modx x = powT(modx(bases[i], n), d);
-        if (x == 1 || x == n - 1) continue;
-        for (int i = 1; i < r; i++) {
-            x *= x;
-            if (x == 1 || x == n - 1) break;
-        }
-        if (x != n - 1) return false; // composite
-    }
-    return true; // probably prime
+    return miller_rabin_odd(n, bases);
 }
 
 /**
@@ -66,8 +178,10 @@ bool miller_rabin(const T& n) {
     // 10^18, 2^61
     static T bases9[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 0 };
     if (n < 3825123056546413051LL) return miller_rabin(n, bases9);
-    // fallback to bases9 for larger numbers too
-    return miller_rabin(n, bases9);
+    // 3 * 10^23, 2^78
+    static T bases12[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 0 };
+    // fallback to bases12 for larger numbers too
+    return miller_rabin(n, bases12);
 }
 
 /**
@@ -121,14 +235,328 @@ I pollard_rho_repeated(const I& n, const I& max_iter = 20, const I& max_inner_it
     return n;
 }
 
+/**
+ * Pollard's Rho factorization algorithm with Brent's cycle detection, core.
+ *
+ * `n` is odd and the arithmetic is done by `ctx`. The differences are accumulated
+ * into a product and a gcd is taken only once per `BATCH` steps; if the batch
+ * overshoots (the gcd is `n`), its steps are retraced one by one.
+ */
+template<typename CTX, typename E>
+E pollard_rho_brent_ctx(const CTX& ctx, const E& n, const E& k, const E& a, int64_t max_inner_iter) {
+    const int64_t BATCH = 128;
+    auto g = [&](const E& x){ return ctx.add(ctx.mul(x, x), a); };
+    E x = k, y = k, ys = k, q = ctx.one(), d = E(1);
+    for (int64_t r = 1, iter = 0; d == E(1); r *= 2) {
+        if (iter >= max_inner_iter) return n;
+        x = y;
+        for (int64_t i = 0; i < r; i++) y = g(y);
+        for (int64_t j = 0; j < r && d == E(1); j += BATCH) {
+            ys = y;
+            for (int64_t i = 0; i < BATCH && i < r - j; i++) {
+                y = g(y);
+                q = ctx.mul(q, ctx.sub(x, y));
+            }
+            d = gcd(q, n);
+        }
+        iter += 2 * r;
+    }
+    if (d == n) {
+        do {
+            ys = g(ys);
+            d = gcd(ctx.sub(x, ys), n);
+        } while (d == E(1));
+    }
+    return d;
+}
+
+/**
+ * Pollard's Rho factorization algorithm with Brent's cycle detection.
+ *
+ * Same as `pollard_rho` above, but with Brent's cycle detection which takes fewer
+ * polynomial evaluations, and with a single gcd per a batch of steps.
+ * Integral types of up to 64 bits (and 128 bits where supported) use Montgomery multiplication.
+ *
+ * Complexity: O(p^(1/2)) <= O(n^(1/4)), where `p` is the smallest prime factor of `n`.
+ *
+ * @param n - number to factor
+ * @param k - initial value
+ * @param a - parameter of the polynomial g(x) = x^2 + a
+ * @param max_inner_iter - maximum allowed number of iterations
+ * @return d - a nontrivial factor of `n`, or `n` if factorization failed
+ */
+template<typename I>
+I pollard_rho_brent(const I& n, const I& k = 2, const I& a = 1, int64_t max_inner_iter = 1000000) {
+    if (n == 0) return 0;
+    if (n == 1) return 1;
+    if (n % 2 == 0) return 2;
+    typedef typename modular_arithmetic<I>::word E;
+    E m = E(n);
+    return I(pollard_rho_brent_ctx(typename modular_arithmetic<I>::type(m), m, E(k) % m, E(a) % m, max_inner_iter));
+}
+
+/**
+ * Pollard's Rho factorization algorithm with Brent's cycle detection,
+ * applied iteratively with `k` and `a` being increased in each iteration.
+ */
+template<typename I>
+I pollard_rho_brent_repeated(const I& n, int max_iter = 20, int64_t max_inner_iter = 1000000) {
+    for (int k = 2; k <= max_iter; k++) {
+        I d = pollard_rho_brent(n, I(k), I(k), max_inner_iter);
+        if (d != n) return d;
+    }
+    return n;
+}
+
+/**
+ * Parameters of Lenstra's elliptic curve method, and the tables precomputed from them.
+ *
+ * The tables only depend on the bounds, so a single instance can be shared
+ * by all the numbers being factored, from multiple threads as well.
+ */
+struct ecm_params {
+    int b1;                        // stage 1 bound
+    int b2;                        // stage 2 bound
+    int curves;                    // number of curves to try
+    int d;                         // stage 2 giant step
+    std::vector<uint32_t> stage1;  // the largest power of each prime up to `b1`
+    std::vector<int> baby;         // baby steps; odd `j < d / 2` coprime to `d`
+    std::vector<char> stage2;      // whether `q` is a prime in `(b1, b2]`, for `q < b2 + d`
+
+    ecm_params(int b1, int b2, int curves) : b1(b1), b2(b2), curves(curves) {
+        d = (b1 < 2310) ? 210 : 2310;
+        std::vector<char> q(b2 + d);
+        primes(nullptr, q.data(), int(q.size()));
+        for (int p = 2; p <= b1; p++) {
+            if (!q[p]) continue;
+            uint32_t pk = p;
+            while (pk <= uint32_t(b1) / p) pk *= p;
+            stage1.push_back(pk);
+        }
+        for (int j = 1; j < d / 2; j += 2) {
+            if (gcd(j, d) == 1) baby.push_back(j);
+        }
+        stage2.assign(b2 + d, 0);
+        for (int p = b1 + 1; p <= b2; p++) stage2[p] = q[p];
+    }
+
+    // parameters tuned for the factors of about 15, 20 and 25 digits respectively
+    static const ecm_params& level(int i) {
+        if (i <= 0) { static const ecm_params p(2000, 200000, 25); return p; }
+        if (i == 1) { static const ecm_params p(11000, 1100000, 90); return p; }
+        static const ecm_params p(50000, 5000000, 300); return p;
+    }
+};
+
+/**
+ * Lenstra's elliptic curve method with a single curve, core.
+ *
+ * `n` is odd and the arithmetic is done by `ctx`. The curve is the Montgomery curve
+ * obtained by Suyama's parametrization from `sigma`. The points are kept in the
+ * projective `(X : Z)` form, and the curve constant as `A24 / C24 = (A + 2) / 4`,
+ * so that no modular inversions are needed.
+ */
+template<typename CTX, typename E>
+E ecm_ctx(const CTX& ctx, const E& n, const ecm_params& params, uint64_t sigma) {
+    struct point { E x, z; };
+    E s = ctx.to(E(sigma));
+    E u = ctx.sub(ctx.mul(s, s), ctx.to(E(5)));
+    E v = ctx.add(ctx.add(s, s), ctx.add(s, s));
+    E u3 = ctx.mul(ctx.mul(u, u), u), vu = ctx.sub(v, u);
+    E a24 = ctx.mul(ctx.mul(ctx.mul(vu, vu), vu), ctx.add(ctx.add(ctx.add(u, u), u), v));
+    E c24 = ctx.mul(ctx.mul(ctx.to(E(16)), u3), v);
+    point q{ u3, ctx.mul(ctx.mul(v, v), v) };
+    auto dbl = [&](const point& p) {
+        E s = ctx.add(p.x, p.z), d = ctx.sub(p.x, p.z);
+        s = ctx.mul(s, s), d = ctx.mul(d, d);
+        E t = ctx.sub(s, d); // 4 x z
+        return point{ ctx.mul(ctx.mul(s, d), c24), ctx.mul(t, ctx.add(ctx.mul(d, c24), ctx.mul(t, a24))) };
+    };
+    // `p + q`, given `p - q`
+    auto add = [&](const point& p, const point& q, const point& pq) {
+        E u = ctx.mul(ctx.sub(p.x, p.z), ctx.add(q.x, q.z));
+        E v = ctx.mul(ctx.add(p.x, p.z), ctx.sub(q.x, q.z));
+        E a = ctx.add(u, v), b = ctx.sub(u, v);
+        return point{ ctx.mul(pq.z, ctx.mul(a, a)), ctx.mul(pq.x, ctx.mul(b, b)) };
+    };
+    // `k p` by the Montgomery ladder; `k >= 1`
+    auto mul = [&](const point& p, uint64_t k) {
+        point r0 = p, r1 = dbl(p);
+        int h = 0; while ((k >> h) > 1) h++;
+        for (int i = h - 1; i >= 0; i--) {
+            if ((k >> i) & 1) {
+                r0 = add(r1, r0, p), r1 = dbl(r1);
+            } else {
+                r1 = add(r0, r1, p), r0 = dbl(r0);
+            }
+        }
+        return r0;
+    };
+    // stage 1: `q = k q`, where `k` is the product of all the prime powers up to `b1`
+    for (uint32_t pk : params.stage1) q = mul(q, pk);
+    E g = gcd(q.z, n);
+    if (g != E(1)) return g;
+    // stage 2: for each prime `p = m d +- j` in `(b1, b2]`, `p q` is zero iff `x(m d q) z(j q) = x(j q) z(m d q)`
+    int d = params.d;
+    std::vector<point> vs(d / 2);
+    vs[1] = q;
+    point q2 = dbl(q);
+    if (d / 2 > 3) vs[3] = add(q2, q, q);
+    for (int j = 5; j < d / 2; j += 2) vs[j] = add(vs[j - 2], q2, vs[j - 4]);
+    point qd = mul(q, d);
+    int m = std::max(1, params.b1 / d);
+    point r = mul(qd, m), r_next = mul(qd, m + 1);
+    E acc = ctx.one();
+    for (; int64_t(m) * d - d / 2 <= params.b2; m++) {
+        for (int j : params.baby) {
+            if (!params.stage2[m * d - j] && !params.stage2[m * d + j]) continue;
+            acc = ctx.mul(acc, ctx.sub(ctx.mul(r.x, vs[j].z), ctx.mul(vs[j].x, r.z)));
+        }
+        point t = add(r_next, qd, r);
+        r = r_next, r_next = t;
+    }
+    return gcd(acc, n);
+}
+
+/**
+ * Lenstra's elliptic curve factorization method.
+ *
+ * Tries `params.curves` curves, with `sigma = seed + i` for the `i`-th one,
+ * see `ecm_ctx` above. Stage 1 multiplies the point by all the prime powers
+ * up to `params.b1`, and stage 2 covers a single larger prime up to `params.b2`
+ * by the baby-step giant-step continuation.
+ * Integral types of up to 64 bits (and 128 bits where supported) use Montgomery multiplication.
+ *
+ * Complexity: `exp((sqrt(2) + o(1)) sqrt(ln p ln ln p))` modular multiplications
+ * with the optimal bounds, where `p` is the smallest prime factor of `n`.
+ *
+ * @param n - number to factor, with no prime factors below 7
+ * @param params - bounds and the number of curves, see `ecm_params`
+ * @param seed - the `sigma` of the first curve; at least 6
+ * @return d - a nontrivial factor of `n`, or `n` if factorization failed
+ */
+template<typename I>
+I ecm(const I& n, const ecm_params& params, uint64_t seed = 6) {
+    if (n == 0) return 0;
+    if (n == 1) return 1;
+    if (n % 2 == 0) return 2;
+    typedef typename modular_arithmetic<I>::word E;
+    E m = E(n);
+    typename modular_arithmetic<I>::type ctx{ m };
+    for (int i = 0; i < params.curves; i++) {
+        E d = ecm_ctx(ctx, m, params, seed + i);
+        if (d != E(1) && d != m) return I(d);
+    }
+    return n;
+}
+
+/**
+ * Lenstra's elliptic curve factorization method,
+ * applied with the increasing bounds of `ecm_params::level`.
+ */
+template<typename I>
+I ecm_repeated(const I& n, int max_level = 2) {
+    for (int i = 0; i <= max_level; i++) {
+        I d = ecm(n, ecm_params::level(i), 6 + 1000 * i);
+        if (d != n) return d;
+    }
+    return n;
+}
+
+/**
+ * Divisors for trial division by the primes below `TRIAL_DIVISION_BOUND`.
+ *
+ * For an odd `p`, `n` is divisible by `p` iff `n * inv <= lim` (mod 2^64),
+ * in which case the product equals `n / p`.
+ */
+struct trial_divisor {
+    static const int TRIAL_DIVISION_BOUND = 1 << 10;
+    uint64_t p;
+    uint64_t inv; // p^-1 mod 2^64
+    uint64_t lim; // (2^64 - 1) / p
+
+    static const std::vector<trial_divisor>& odd_primes() {
+        static const std::vector<trial_divisor> vd = [](){
+            std::vector<trial_divisor> vd;
+            std::vector<char> composite(TRIAL_DIVISION_BOUND);
+            for (uint64_t p = 3; p < TRIAL_DIVISION_BOUND; p += 2) {
+                if (composite[p]) continue;
+                for (uint64_t m = p * p; m < TRIAL_DIVISION_BOUND; m += 2 * p) composite[m] = 1;
+                vd.push_back({ p, montgomery64(p).n_inv, ~uint64_t(0) / p });
+            }
+            return vd;
+        }();
+        return vd;
+    }
+};
+
+template<typename I>
+I trial_division_impl(const I& n, std::vector<std::pair<I, int>>& vf, std::true_type) {
+    uint64_t m = uint64_t(n);
+    int e = 0;
+    while (m % 2 == 0) m /= 2, e++;
+    if (e > 0) vf.push_back({ I(2), e });
+    for (const auto& d : trial_divisor::odd_primes()) {
+        if (d.p * d.p > m) break;
+        if (m * d.inv > d.lim) continue;
+        e = 0;
+        while (m * d.inv <= d.lim) m *= d.inv, e++;
+        vf.push_back({ I(d.p), e });
+    }
+    if (m > 1 && m < uint64_t(trial_divisor::TRIAL_DIVISION_BOUND) * trial_divisor::TRIAL_DIVISION_BOUND) {
+        vf.push_back({ I(m), 1 });
+        m = 1;
+    }
+    return I(m);
+}
+template<typename I>
+I trial_division_impl(I n, std::vector<std::pair<I, int>>& vf, std::false_type) {
+    int e = 0;
+    while (n % 2 == 0) n /= 2, e++;
+    if (e > 0) vf.push_back({ I(2), e });
+    for (const auto& d : trial_divisor::odd_primes()) {
+        I p = I(d.p);
+        if (p * p > n) break;
+        if (n % p != 0) continue;
+        e = 0;
+        while (n % p == 0) n /= p, e++;
+        vf.push_back({ p, e });
+    }
+    I b = I(trial_divisor::TRIAL_DIVISION_BOUND);
+    if (n > 1 && n < b * b) {
+        vf.push_back({ n, 1 });
+        n = 1;
+    }
+    return n;
+}
+
+/**
+ * Factors out the primes below `trial_divisor::TRIAL_DIVISION_BOUND` by trial division.
+ *
+ * The found prime factors get appended to `vf`.
+ * Returns the remaining cofactor, which is either 1, or has all its prime factors
+ * above the bound and is at least the square of the bound.
+ */
+template<typename I>
+I trial_division(const I& n, std::vector<std::pair<I, int>>& vf) {
+    return trial_division_impl(n, vf, is_montgomery64_compatible<I>());
+}
+
 /**
  * Factors integer `n` using a general-purpose factoring algorithm.
+ *
+ * The small prime factors are found by trial division first, then the remaining
+ * cofactors get tested for primality by Miller-Rabin, and split by Pollard's Rho,
+ * or by the elliptic curve method when Pollard's Rho fails.
+ * A composite that could not be split ends up in the result as if it were a prime.
+ *
+ * The factors get appended to `vf`; `q` is a scratch space, reusable across calls.
  */
 template<typename I>
-std::vector<std::pair<I, int>> factor_integer(const I& n, int max_iter = 20) {
-    std::vector<std::pair<I, int>> vf;
-    if (n == 0 || n == 1) return vf;
-    std::vector<I> q = { n };
+void factor_integer(std::vector<std::pair<I, int>>& vf, const I& n, std::vector<I>& q, int max_iter = 20) {
+    if (n == 0 || n == 1) return;
+    q.clear();
+    q.push_back(trial_division(n, vf));
     while (!q.empty()) {
         I a = q.back(); q.pop_back();
         if (a == 1) {
@@ -143,8 +571,11 @@ std::vector<std::pair<I, int>> factor_integer(const I& n, int max_iter = 20) {
             vf.push_back({ a, e });
             continue;
         }
-        // `a` is composite
-        I d = pollard_rho_repeated<I>(a, max_iter);
+        // `a` is composite; beyond some `2^18` steps ECM is faster than rho
+        I d = pollard_rho_brent_repeated<I>(a, max_iter, 1 << 18);
+        if (d == 1 || d == a) {
+            d = ecm_repeated<I>(a);
+        }
         if (d == 1 || d == a) {
             // failed to factor the composite
             vf.push_back({ a, 1 });
@@ -154,9 +585,101 @@ std::vector<std::pair<I, int>> factor_integer(const I& n, int max_iter = 20) {
         q.push_back(d);
         q.push_back(a / d);
     }
+}
+
+/**
+ * Factors integer `n` using a general-purpose factoring algorithm.
+ */
+template<typename I>
+std::vector<std::pair<I, int>> factor_integer(const I& n, int max_iter = 20) {
+    std::vector<std::pair<I, int>> vf;
+    std::vector<I> q;
+    factor_integer(vf, n, q, max_iter);
     return vf;
 }
 
+/**
+ * Factorizations of a batch of integers, in a compact (CSR) layout.
+ *
+ * The factorization of the `i`-th integer consists of the `(p, e)` pairs
+ * in `[factors.begin() + offsets[i], factors.begin() + offsets[i + 1])`.
+ */
+template<typename I>
+struct factorization_batch {
+    std::vector<size_t> offsets;
+    std::vector<std::pair<I, int>> factors;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const std::pair<I, int>* begin(size_t i) const { return factors.data() + offsets[i]; }
+    const std::pair<I, int>* end(size_t i) const { return factors.data() + offsets[i + 1]; }
+    std::vector<std::pair<I, int>> operator[](size_t i) const { return{ begin(i), end(i) }; }
+};
+
+/**
+ * Factors the integers in `[begin, end)`, see `factor_integer`.
+ *
+ * The integers are processed in chunks; `exec` runs the chunks, see
+ * `concurrency::serial_range_executor`. Each executor call (i.e. each thread)
+ * reuses its own scratch space, and each chunk collects its factors into
+ * a buffer of its own, which get concatenated into the result at the end.
+ */
+template<typename It, typename EXEC = concurrency::serial_range_executor, typename I = typename std::iterator_traits<It>::value_type>
+factorization_batch<I> factor_integers(It begin, It end, const EXEC& exec = EXEC(), int max_iter = 20) {
+    const size_t CHUNK = 1 << 12;
+    size_t n = std::distance(begin, end);
+    int chunks = int((n + CHUNK - 1) / CHUNK);
+    factorization_batch<I> r;
+    r.offsets.assign(n + 1, 0);
+    std::vector<std::vector<std::pair<I, int>>> vvf(chunks);
+    exec(0, chunks, [&](int c0, int c1) {
+        std::vector<I> q;
+        for (int c = c0; c < c1; c++) {
+            size_t i1 = std::min(n, (c + 1) * CHUNK);
+            It it = begin; std::advance(it, c * CHUNK);
+            for (size_t i = c * CHUNK; i < i1; i++, ++it) {
+                factor_integer(vvf[c], I(*it), q, max_iter);
+                r.offsets[i + 1] = vvf[c].size(); // relative to the chunk for now
+            }
+        }
+    });
+    std::vector<size_t> base(chunks + 1);
+    for (int c = 0; c < chunks; c++) base[c + 1] = base[c] + vvf[c].size();
+    r.factors.resize(base[chunks]);
+    exec(0, chunks, [&](int c0, int c1) {
+        for (int c = c0; c < c1; c++) {
+            std::copy(vvf[c].begin(), vvf[c].end(), r.factors.begin() + base[c]);
+            std::vector<std::pair<I, int>>().swap(vvf[c]);
+            size_t i1 = std::min(n, (c + 1) * CHUNK);
+            for (size_t i = c * CHUNK; i < i1; i++) r.offsets[i + 1] += base[c];
+        }
+    });
+    return r;
+}
+
+/**
+ * Tests the integers in `[begin, end)` for primality, see `miller_rabin`.
+ *
+ * The integers are processed in chunks; `exec` runs the chunks, see
+ * `concurrency::serial_range_executor`.
+ *
+ * @return - a vector with 1 for each prime, and 0 for each non-prime integer
+ */
+template<typename It, typename EXEC = concurrency::serial_range_executor, typename I = typename std::iterator_traits<It>::value_type>
+std::vector<char> is_prime_batch(It begin, It end, const EXEC& exec = EXEC()) {
+    const size_t CHUNK = 1 << 12;
+    size_t n = std::distance(begin, end);
+    int chunks = int((n + CHUNK - 1) / CHUNK);
+    std::vector<char> r(n);
+    exec(0, chunks, [&](int c0, int c1) {
+        size_t i1 = std::min(n, c1 * CHUNK);
+        It it = begin; std::advance(it, c0 * CHUNK);
+        for (size_t i = c0 * CHUNK; i < i1; i++, ++it) {
+            r[i] = miller_rabin(I(*it));
+        }
+    });
+    return r;
+}
+
 /**
  * Factors integer `n` by trial division.
  */
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "altruct/algorithm/math/base.h"
+#include "altruct/algorithm/math/bits.h"
 
 #if defined(__clang__)
 // builtin, no header needed
@@ -9,6 +10,10 @@
 #elif defined(_MSC_VER)
 #include <intrin.h>
 #endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define ALTRUCT_HAS_PDEP
+#endif
 
 namespace altruct {
 namespace math {
@@ -29,5 +34,104 @@ inline bool add_overflow(uint8_t x, uint8_t y, uint8_t* r) { return _addcarry_u8
 //inline bool add_overflow(int8_t x, int8_t y, int8_t* r) { auto c = _addcarry_u8(0, x, y, (uint8_t*)r); auto ci = (x ^ y ^ *r) >> 7; return c ^ ci; }
 #endif
 
+/**
+ * Full 64x64 -> 128 bit multiplication.
+ * Returns the low 64 bits of the product, and stores the high 64 bits to `hi`.
+ */
+#if defined(__SIZEOF_INT128__)
+inline uint64_t mul_128(uint64_t x, uint64_t y, uint64_t* hi) {
+    unsigned __int128 r = (unsigned __int128)x * y;
+    *hi = uint64_t(r >> 64);
+    return uint64_t(r);
+}
+#elif defined(_MSC_VER) && defined(_M_X64)
+inline uint64_t mul_128(uint64_t x, uint64_t y, uint64_t* hi) {
+    return _umul128(x, y, hi);
+}
+#else
+inline uint64_t mul_128(uint64_t x, uint64_t y, uint64_t* hi) {
+    uint64_t x0 = uint32_t(x), x1 = x >> 32, y0 = uint32_t(y), y1 = y >> 32;
+    uint64_t p00 = x0 * y0, p01 = x0 * y1, p10 = x1 * y0, p11 = x1 * y1;
+    uint64_t m = (p00 >> 32) + uint32_t(p01) + uint32_t(p10);
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (m >> 32);
+    return (m << 32) | uint32_t(p00);
+}
+#endif
+
+#if defined(__SIZEOF_INT128__)
+/**
+ * Full 256-bit product of two 128-bit unsigned integers.
+ * Returns the low 128 bits of the product, and stores the high 128 bits to `hi`.
+ */
+inline unsigned __int128 mul_256(unsigned __int128 x, unsigned __int128 y, unsigned __int128* hi) {
+    typedef unsigned __int128 u128;
+    u128 x0 = uint64_t(x), x1 = x >> 64, y0 = uint64_t(y), y1 = y >> 64;
+    u128 p00 = x0 * y0, p01 = x0 * y1, p10 = x1 * y0, p11 = x1 * y1;
+    u128 m = (p00 >> 64) + uint64_t(p01) + uint64_t(p10);
+    *hi = p11 + (p01 >> 64) + (p10 >> 64) + (m >> 64);
+    return (m << 64) | uint64_t(p00);
+}
+#endif
+
+/**
+ * Number of bits set to 1.
+ * Uses the POPCNT instruction when available.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+inline int popcount64(uint64_t x) { return __builtin_popcountll(x); }
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+inline int popcount64(uint64_t x) { return int(__popcnt64(x)); }
+#else
+inline int popcount64(uint64_t x) { return bit_cnt1(x); }
+#endif
+
+/**
+ * Position of the highest bit set to 1; `ilog2_64(0) = 0` as with `ilog2`.
+ * Uses the BSR/LZCNT instruction when available.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+inline int ilog2_64(uint64_t x) { return x ? 63 - __builtin_clzll(x) : 0; }
+#elif defined(_MSC_VER) && defined(_M_X64)
+inline int ilog2_64(uint64_t x) { unsigned long r = 0; _BitScanReverse64(&r, x); return int(r); }
+#else
+inline int ilog2_64(uint64_t x) { return ilog2(x); }
+#endif
+
+/**
+ * Position of the lowest bit set to 1; `x` must be nonzero.
+ * Uses the BSF/TZCNT instruction when available.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+inline int tzc64(uint64_t x) { return __builtin_ctzll(x); }
+#elif defined(_MSC_VER) && defined(_M_X64)
+inline int tzc64(uint64_t x) { unsigned long r = 0; _BitScanForward64(&r, x); return int(r); }
+#else
+inline int tzc64(uint64_t x) { return tzc(x); }
+#endif
+
+/**
+ * Position of the `k`-th (0-based) bit set to 1; `0 <= k < popcount64(x)`.
+ * Uses the PDEP instruction when available.
+ */
+#if defined(ALTRUCT_HAS_PDEP)
+inline int select64(uint64_t x, int k) {
+    // not `_tzcnt_u64`, as that would need BMI1 on top of BMI2
+    return tzc64(_pdep_u64(uint64_t(1) << k, x));
+}
+#else
+inline int select64(uint64_t x, int k) {
+    // byte-wise prefix counts: the byte `i` of `c` holds the number of ones in the bytes `0..i`
+    uint64_t c = x - ((x >> 1) & 0x5555555555555555ULL);
+    c = (c & 0x3333333333333333ULL) + ((c >> 2) & 0x3333333333333333ULL);
+    c = ((c + (c >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL;
+    int b = 0;
+    while (int((c >> b) & 0xFF) <= k) b += 8;
+    if (b > 0) k -= int((c >> (b - 8)) & 0xFF);
+    uint8_t w = uint8_t(x >> b);
+    for (; k > 0; k--) w &= w - 1;
+    return b + tzc(w);
+}
+#endif
+
 } // math
 } // altruct
@@ -3,7 +3,9 @@
 #include "altruct/structure/math/modulo.h"
 #include "altruct/structure/math/quadratic.h"
 #include "altruct/structure/math/prime_holder.h"
+#include "altruct/concurrency/executor.h"
 
+#include <stdint.h>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -381,31 +383,137 @@ I discrete_log_brute_force_g(G a, G b, I max_iter) {
     return -1;
 }
 
+/**
+ * Baby-step table for discrete logarithms to the base `a`,
+ * in a cyclic group of order `n` (the order of `a` is `n` or its divisor).
+ *
+ * The `m` baby steps `a^j` are kept in an open-addressing hash table with linear probing.
+ * Each slot packs a 32-bit fingerprint of `hasherT<G>` of `a^j` together with `j`
+ * into a single 64-bit word. The table is built once and reused for any number of `b`.
+ * Fingerprint matches get verified, so `hasherT<G>` doesn't have to be injective.
+ * For `k` queries, `m = sqrt(n k)` baby steps minimize the total work.
+ *
+ * Space complexity: `O(m)`
+ * Time complexities:
+ *   build: `O(m)` group operations
+ *   log:   `O(n / m)` group operations
+ */
+template <typename G, typename I>
+class baby_step_table {
+    I n, m;
+    G a, alpha; // alpha = a^-m
+    int shift;
+    std::vector<uint64_t> slots; // fingerprint in the high half, `j + 1` in the low half; 0 if empty
+
+public:
+    // builds the table with `m` baby steps; `sqrt(n) + 1` if not specified, at most `2^32 - 1`
+    baby_step_table(G a, I n, I m = 0) : n(n), m(num_steps(n, m)), a(a), alpha(powT(a, this->n - this->m)) {
+        int bits = 1;
+        while ((uint64_t(1) << bits) < 2 * uint64_t(this->m)) bits++;
+        shift = 64 - bits;
+        slots.assign(size_t(1) << bits, 0);
+        G e = identityOf(a), cur = e;
+        for (I j = 0; j < this->m; j++) {
+            if (j > 0 && cur == e) break; // the order of `a` is `j`
+            uint64_t h = hash(cur);
+            size_t mask = slots.size() - 1;
+            size_t s = size_t(h >> shift);
+            while (slots[s] != 0) s = (s + 1) & mask;
+            slots[s] = (h << 32) | (uint64_t(j) + 1);
+            cur *= a;
+        }
+    }
+
+    I size() const { return m; }
+
+    // returns `x` such that `a^x = b`, or -1 if there is none
+    I log(const G& b) const {
+        size_t mask = slots.size() - 1;
+        G gamma = b;
+        for (I i = 0; i <= n / m; i++) {
+            // giant steps: b * alpha^i
+            uint64_t h = hash(gamma);
+            for (size_t s = size_t(h >> shift); slots[s] != 0; s = (s + 1) & mask) {
+                if ((slots[s] >> 32) != (h & 0xFFFFFFFFu)) continue;
+                I x = i * m + I(uint32_t(slots[s]) - 1);
+                if (powT(a, x) == b) return x;
+            }
+            gamma *= alpha;
+        }
+        return -1;
+    }
+
+private:
+    // at most `2^32 - 1`, so that `j + 1` fits in the low half of a slot
+    static I num_steps(I n, I m) {
+        if (m <= 0) m = sqrtT(n) + 1;
+        m = std::max(I(1), std::min(m, n));
+        if (uint64_t(m) > 0xFFFFFFFFu) m = I(0xFFFFFFFFu);
+        return m;
+    }
+
+    static uint64_t hash(const G& g) {
+        return uint64_t(hasherT<G>()(g)) * 0x9E3779B97F4A7C15ULL;
+    }
+};
+
 /**
  * Discrete logarithm in cyclic group of order `n`; in O(sqrt(n))
  *
  * `a^x = b`, order of `a` is `n` (or its divisor)
+ * To solve for many `b` with the same `a`, reuse a `baby_step_table` instead.
  *
  * @return `x`
  */
 template <typename G, typename I>
 I discrete_log_baby_giant_g(G a, G b, I n) {
-    I q = sqrtT(n) + 1;
-    std::unordered_map<G, I, hasherT<G>> baby;
-    // baby steps: a^j
-    G cur = identityOf(a);
-    for (I j = 0; j < q; ++j) {
-        if (!baby.emplace(cur, j).second) break;
-        cur *= a;
-    }
-    G alpha = powT(a, n - q); // a^-q
-    // giant steps: b * alpha^i
-    G gamma = b;
-    for (I i = 0; i < q; ++i) {
-        if (baby.count(gamma)) {
-            return i * q + baby[gamma];
+    return baby_step_table<G, I>(a, n).log(b);
+}
+
+/**
+ * Discrete logarithm in cyclic group of order `n`; Pollard's rho in expected O(sqrt(n)) and O(1) space
+ *
+ * `a^x = b`, order of `a` is `n`
+ *
+ * The walk multiplies the current element by `a`, by `b`, or squares it, depending on
+ * its hash, while keeping track of its representation `a^u b^v`. Brent's cycle detection
+ * finds a collision `a^u1 b^v1 = a^u2 b^v2`, which gives `(v1 - v2) x = u2 - u1 (mod n)`.
+ * The solutions of that congruence get verified.
+ *
+ * @param max_attempts - maximum number of walks from different starting points
+ * @return `x`, or -1 if not found
+ */
+template <typename G, typename I>
+I discrete_log_pollard_rho_g(G a, G b, I n, int max_attempts = 20) {
+    const I MAX_CANDIDATES = 1 << 10;
+    G e = identityOf(a);
+    if (b == e) return 0;
+    auto step = [&](G& x, I& u, I& v) {
+        switch ((uint64_t(hasherT<G>()(x)) * 0x9E3779B97F4A7C15ULL >> 32) % 3) {
+        case 0: x *= a; u = modulo_add(u, I(1), n); break;
+        case 1: x *= x; u = modulo_add(u, u, n); v = modulo_add(v, v, n); break;
+        default: x *= b; v = modulo_add(v, I(1), n); break;
+        }
+    };
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+        I u1 = I(attempt) % n, v1 = I(1) % n;
+        G x1 = powT(a, u1) * b;
+        G x2 = x1; I u2 = u1, v2 = v1;
+        for (uint64_t len = 1, pw = 1; ; len++) {
+            step(x2, u2, v2);
+            if (x2 == x1) break;
+            if (len == pw) x1 = x2, u1 = u2, v1 = v2, pw *= 2, len = 0;
+        }
+        I r = modulo_sub(v1, v2, n), s = modulo_sub(u2, u1, n);
+        I d = gcd(r, n);
+        if (s % d != 0 || d > MAX_CANDIDATES) continue;
+        I nd = n / d;
+        I x0 = (nd == 1) ? I(0) : modulo_mul(I(s / d), modulo_inv(I(r / d), nd), nd);
+        G ax0 = powT(a, x0), a_nd = powT(a, nd);
+        for (I k = 0; k < d; k++) {
+            if (ax0 == b) return x0 + k * nd;
+            ax0 *= a_nd;
         }
-        gamma *= alpha;
     }
     return -1;
 }
@@ -452,25 +560,152 @@ I discrete_log_order_pp_g(G a, G b, I p, int s) {
  * @param n
  * @param n_factors - unique prime factors of `n`
  * @param out_o - optional output `o`, order of `a`, `o` divides `n`
+ * @param exec - runs the independent prime power subproblems, see `concurrency::serial_range_executor`
  * @return `x`
  */
-template <typename G, typename I, typename P>
-I discrete_log_g(G a, G b, I n, const std::vector<P>& n_factors, I* out_o = nullptr) {
+template <typename G, typename I, typename P, typename EXEC = concurrency::serial_range_executor>
+I discrete_log_g(G a, G b, I n, const std::vector<P>& n_factors, I* out_o = nullptr, const EXEC& exec = EXEC()) {
     I o = multiplicative_order_g(a, n, n_factors);
-    I x = 0, q = 1;
+    std::vector<I> vp, vpe, vx;
+    std::vector<int> ve;
     for (const P& p : n_factors) {
         I d = o, pe = 1; int e = 0;
         while (d % p == 0) d /= p, pe *= p, e++;
         if (e == 0) continue;
-        G a_sub = powT(a, d); // generator in subgroup
-        G b_sub = powT(b, d); // target in subgroup
-        I x_pe = discrete_log_order_pp_g(a_sub, b_sub, p, e);
-        chinese_remainder(&x, &q, x_pe, pe);
+        vp.push_back(I(p)), vpe.push_back(pe), ve.push_back(e);
+    }
+    vx.resize(vp.size());
+    exec(0, int(vp.size()), [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            I d = o / vpe[i];
+            G a_sub = powT(a, d); // generator in subgroup
+            G b_sub = powT(b, d); // target in subgroup
+            vx[i] = discrete_log_order_pp_g(a_sub, b_sub, vp[i], ve[i]);
+        }
+    });
+    I x = 0, q = 1;
+    for (size_t i = 0; i < vx.size(); i++) {
+        chinese_remainder(&x, &q, vx[i], vpe[i]);
     }
     if (out_o) *out_o = o; // q == o at this point
     return x;
 }
 
+/**
+ * Pohlig-Hellman precomputation for discrete logarithms to the base `a`,
+ * in a cyclic group of order `n`.
+ *
+ * The order `o` of `a` gets factored into prime powers `p^e`, and a `baby_step_table`
+ * is built for the subgroup of each order `p`. Each logarithm then only takes
+ * the giant steps; `e` table lookups for each prime power, and a CRT at the end.
+ * Use this instead of `discrete_log_g` when solving for many `b` with the same `a`.
+ * The table is read-only once built, so concurrent queries are safe.
+ *
+ * Time complexities:
+ *   build: `O(Sum[sqrt(p_i e_i k)])` group operations
+ *   log:   `O(Sum[sqrt(p_i e_i / k)] + Sum[e_i] log n)` group operations
+ * where `k` is the expected number of queries
+ */
+template <typename G, typename I>
+class discrete_log_table {
+    struct subgroup {
+        I p, pe; int e;
+        G a_sub, a_sub_inv;           // a^(o/p^e) of order `p^e`, and its inverse
+        baby_step_table<G, I> table;  // for a_sub^(p^(e-1)) of order `p`
+    };
+    G a;
+    I o;
+    std::vector<subgroup> subgroups;
+
+public:
+    // `n_factors` are the unique prime factors of `n`;
+    // `num_queries` is the expected number of queries, used to size the baby-step tables;
+    // `exec` builds the baby-step tables, see `concurrency::serial_range_executor`
+    template <typename P, typename EXEC = concurrency::serial_range_executor>
+    discrete_log_table(G a, I n, const std::vector<P>& n_factors, I num_queries = 1, const EXEC& exec = EXEC()) :
+        a(a), o(multiplicative_order_g(a, n, n_factors)) {
+        for (const P& p : n_factors) {
+            I d = o, pe = 1; int e = 0;
+            while (d % p == 0) d /= p, pe *= p, e++;
+            if (e == 0) continue;
+            G a_sub = powT(a, d);
+            // a tiny placeholder table; the actual ones get built below
+            subgroups.push_back({ I(p), pe, e, a_sub, powT(a_sub, pe - 1), baby_step_table<G, I>(a_sub, 1, 1) });
+        }
+        exec(0, int(subgroups.size()), [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+                subgroup& sg = subgroups[i];
+                G gamma = powT(sg.a_sub, sg.pe / sg.p);
+                sg.table = baby_step_table<G, I>(gamma, sg.p, num_steps(sg.p, sg.e, num_queries));
+            }
+        });
+    }
+
+    // the order of `a`; logarithms are modulo this
+    I order() const { return o; }
+
+    // returns `x` in `[0, o)` such that `a^x = b`, or -1 if there is none;
+    // `exec` runs the independent prime power subproblems
+    template <typename EXEC = concurrency::serial_range_executor>
+    I log(const G& b, const EXEC& exec = EXEC()) const {
+        std::vector<I> vx(subgroups.size());
+        exec(0, int(subgroups.size()), [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) vx[i] = log_pp(subgroups[i], b);
+        });
+        return combine(vx, b);
+    }
+
+    // returns the logarithms of all the elements in `[begin, end)`, or -1 for those that have none;
+    // the elements are processed in chunks, and `exec` runs the chunks
+    template <typename It, typename EXEC = concurrency::serial_range_executor>
+    std::vector<I> log_batch(It begin, It end, const EXEC& exec = EXEC()) const {
+        const size_t CHUNK = 1 << 8;
+        size_t k = std::distance(begin, end);
+        std::vector<I> r(k);
+        int chunks = int((k + CHUNK - 1) / CHUNK);
+        exec(0, chunks, [&](int c0, int c1) {
+            size_t i1 = std::min(k, c1 * CHUNK);
+            It it = begin; std::advance(it, c0 * CHUNK);
+            std::vector<I> vx(subgroups.size());
+            for (size_t i = c0 * CHUNK; i < i1; i++, ++it) {
+                for (size_t j = 0; j < subgroups.size(); j++) vx[j] = log_pp(subgroups[j], *it);
+                r[i] = combine(vx, *it);
+            }
+        });
+        return r;
+    }
+
+private:
+    // the baby steps that balance the work for `k` queries; `sqrt(p e k)`
+    static I num_steps(I p, int e, I k) {
+        I s = sqrtT(I(e) * std::max(I(1), k)), sp = sqrtT(p) + 1;
+        return (s >= sp) ? p : sp * s;
+    }
+
+    // the logarithm of `b^(o/p^e)` to the base `a_sub`, digit by digit in base `p`
+    I log_pp(const subgroup& sg, const G& b) const {
+        G bk = powT(b, o / sg.pe); // a_sub^-x * b_sub
+        I x = 0;
+        for (I pk = 1, pr = sg.pe / sg.p; pk < sg.pe; pk *= sg.p, pr /= sg.p) {
+            I d = sg.table.log(powT(bk, pr));
+            if (d < 0) return -1;
+            bk *= powT(sg.a_sub_inv, d * pk);
+            x += d * pk;
+        }
+        return x;
+    }
+
+    // combines the results of the subgroups by CRT, and verifies that `b` is in the group generated by `a`
+    I combine(const std::vector<I>& vx, const G& b) const {
+        I x = 0, q = 1;
+        for (size_t i = 0; i < vx.size(); i++) {
+            if (vx[i] < 0) return -1;
+            chinese_remainder(&x, &q, vx[i], subgroups[i].pe);
+        }
+        return (powT(a, x) == b) ? x : -1;
+    }
+};
+
 /**
  * Discrete logarithm modulo `m`; brute-force in O(m)
  *
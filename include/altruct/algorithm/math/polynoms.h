@@ -102,5 +102,44 @@ polynom<T> polynom_sum(const polynom<T>& p) {
     return s;
 }
 
+/**
+ * Resultant of the polynomials `p` and `q`; O(M(l) log l)
+ *
+ * Follows the Euclidean sequence `r[0] = p, r[1] = q, r[i+1] = r[i-1] % r[i]`
+ * with degrees `n[i]` and leading coefficients `c[i]` by using:
+ * res(r[i-1], r[i]) = (-1)^(n[i-1] n[i]) c[i]^(n[i-1] - n[i+1]) res(r[i], r[i+1])
+ * The sequence is obtained from the quotients produced by the half-gcd:
+ * n[i+1] = n[i] - deg(qs[i]), c[i+1] = c[i] / lc(qs[i])
+ *
+ * Coefficients must form a field.
+ */
+template<typename T>
+T resultant(const polynom<T>& p, const polynom<T>& q) {
+    T e0 = p.ZERO_COEFF, e1 = p.id_coeff();
+    int np = polynom<T>::_deg(p), nq = polynom<T>::_deg(q);
+    if (np < 0 || nq < 0) return e0;
+    if (np < nq) {
+        T r = resultant(q, p);
+        return (np % 2 == 1 && nq % 2 == 1) ? -r : r;
+    }
+    std::vector<polynom<T>> qs;
+    polynom<T> r0 = p, r1 = q;
+    polynom<T>::gcd_matrix(r0, r1, &qs);
+    if (r0.deg() > 0) return e0;
+    T res = e1;
+    // n0 = n[i-1], n1 = n[i], c1 = c[i]; qs[i] = r[i] / r[i+1]
+    int n0 = np, n1 = nq;
+    T c1 = q.leading_coeff();
+    for (int i = 1; i < (int)qs.size(); i++) {
+        int n2 = n1 - qs[i].deg();
+        if (n0 % 2 == 1 && n1 % 2 == 1) res = -res;
+        res *= powT(c1, n0 - n2);
+        c1 /= qs[i].leading_coeff();
+        n0 = n1, n1 = n2;
+    }
+    // res(r[last-1], r[last]) with r[last] being a non-zero constant
+    return res * powT(c1, n0);
+}
+
 } // math
 } // altruct
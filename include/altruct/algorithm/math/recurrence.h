@@ -134,13 +134,15 @@ std::vector<T> bernoulli_b(int n, T id = T(1)) {
  * Works for an arbitrary field. The field requirement means that all non-zero
  * elements need to have a multiplicative inverse.
  *
+ * Performs the extended Euclidean algorithm step by step in O(L^2).
+ *
  * @param a - the first 2L elements (or more) of the sequence,
  *            where L is the degree of the polynomial
  *
  * TODO: doesn't work for arbitrary ring A, see Reeds and Sloane's extension to handle a ring.
  */
 template<typename A, typename T = A>
-polynom<T> berlekamp_massey_poly(const std::vector<A>& a, T id = T(1)) {
+polynom<T> berlekamp_massey_poly_long(const std::vector<A>& a, T id = T(1)) {
     T e0 = zeroOf(id), e1 = identityOf(id);
     int n = (int)a.size() / 2;
     int m = 2 * n - 1;
@@ -162,6 +164,52 @@ polynom<T> berlekamp_massey_poly(const std::vector<A>& a, T id = T(1)) {
     return V1 / V1[V1.deg()];
 }
 
+/**
+ * Finds the characteristic polynomial of a linearly recurrent sequence
+ *
+ * Same as `berlekamp_massey_poly_long`, but the Euclidean steps are performed
+ * by the half-gcd in O(M(L) log L), where M(L) is the cost of multiplying two
+ * polynomials of degree L. Only pays off with a fast `polynom_mul<A>`.
+ */
+template<typename A, typename T = A>
+polynom<T> berlekamp_massey_poly_half_gcd(const std::vector<A>& a, T id = T(1)) {
+    T e0 = zeroOf(id);
+    int n = (int)a.size() / 2;
+    int m = 2 * n - 1;
+    polynom<A> R0, R1;
+    R0[m + 1] = identityOf(a[0]);
+    for (int i = 0; i <= m; i++) {
+        R1[i] = a[m - i];
+    }
+    // deg(R0) = 2n, so the half-gcd stops at the first remainder of degree less than n
+    auto M = polynom<A>::half_gcd(R0, R1);
+    const polynom<A>& V1 = M[3];
+    int l = V1.deg();
+    polynom<T> V(std::vector<T>(l + 1, e0));
+    for (int i = 0; i <= l; i++) {
+        V[i] = castOf(id, V1[i]);
+    }
+    return V / V[l];
+}
+
+/**
+ * Finds the characteristic polynomial of a linearly recurrent sequence
+ *
+ * Dispatches to `berlekamp_massey_poly_long` for short sequences
+ * and to `berlekamp_massey_poly_half_gcd` for long ones.
+ *
+ * @param a - the first 2L elements (or more) of the sequence,
+ *            where L is the degree of the polynomial
+ */
+template<typename A, typename T = A>
+polynom<T> berlekamp_massey_poly(const std::vector<A>& a, T id = T(1)) {
+    if (a.size() < 256) {
+        return berlekamp_massey_poly_long(a, id);
+    } else {
+        return berlekamp_massey_poly_half_gcd(a, id);
+    }
+}
+
 /**
  * Finds the coefficients of a linearly recurrent sequence
  *
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "altruct/algorithm/math/intrinsic.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace altruct {
+namespace random {
+
+/**
+ * Jump-ahead for the pseudo-random number generators that are linear over GF(2).
+ *
+ * The state transition `T` of such a generator is a linear map on the state bits.
+ * If `q` is a polynomial for which `q(T) = 0` (e.g. the characteristic polynomial of `T`),
+ * then `T^n = r(T)`, where `r = x^n mod q`. The state after `n` steps is then the sum (xor)
+ * of the states after `i` steps, for each `i < deg(q)` for which `r` has the coefficient `x^i`.
+ * This takes `deg(q)` steps of the generator regardless of `n`, see the generators' `jump`.
+ *
+ * The characteristic polynomial is obtained by Berlekamp-Massey from a bit of the generated
+ * sequence, and `x^n mod q` by repeated squaring, both with the packed representation below.
+ * This is the same as `berlekamp_massey_poly` and `powT` over `polynom<galois_field_2<>>`,
+ * but with 64 coefficients per word, which is needed for the polynomials of degree ~20000.
+ */
+
+/**
+ * A polynomial over GF(2); the coefficient of `x^i` is the bit `i % 64` of the word `i / 64`.
+ */
+typedef std::vector<uint64_t> gf2_poly;
+
+// the coefficient of `x^i`
+inline bool gf2_coeff(const gf2_poly& p, int i) {
+    return (size_t(i >> 6) < p.size()) && ((p[i >> 6] >> (i & 63)) & 1);
+}
+
+// the degree; -1 for the zero polynomial
+inline int gf2_degree(const gf2_poly& p) {
+    for (int k = int(p.size()) - 1; k >= 0; k--) {
+        if (p[k]) return k * 64 + math::ilog2_64(p[k]);
+    }
+    return -1;
+}
+
+/**
+ * Finds the characteristic polynomial of a linearly recurrent sequence of bits
+ *
+ * Berlekamp-Massey in `O(n L / 64)`; the sequence is stored reversed, so that the discrepancy
+ * of each step is the parity of a word-wise product of the connection polynomial with it.
+ *
+ * @param s - the first 2L elements (or more) of the sequence, each 0 or 1,
+ *            where L is the degree of the polynomial
+ * @return the monic polynomial `x^L + c1 x^(L-1) + ... + cL`, where `s[n] = c1 s[n-1] + ... + cL s[n-L]`
+ */
+inline gf2_poly gf2_minimal_polynomial(const std::vector<uint8_t>& s) {
+    int n = int(s.size()), w = n / 64 + 2;
+    std::vector<uint64_t> rs(w + 1); // the bit `j` is `s[n - 1 - j]`
+    for (int j = 0; j < n; j++) {
+        if (s[n - 1 - j]) rs[j >> 6] |= uint64_t(1) << (j & 63);
+    }
+    // the connection polynomials `1 + c1 x + ... + cL x^L`
+    gf2_poly c(w), b(w), t;
+    c[0] = b[0] = 1;
+    int l = 0, m = 1;
+    for (int i = 0; i < n; i++) {
+        // the discrepancy `s[i] + c1 s[i-1] + ... + cL s[i-L]`; the bit `off + k` of `rs` is `s[i - k]`
+        int off = n - 1 - i, o = off >> 6, sh = off & 63;
+        uint64_t acc = 0;
+        for (int k = 0; k <= (l >> 6); k++) {
+            uint64_t r = rs[o + k] >> sh;
+            if (sh) r |= rs[o + k + 1] << (64 - sh);
+            acc ^= c[k] & r;
+        }
+        if ((math::popcount64(acc) & 1) == 0) {
+            m++;
+            continue;
+        }
+        if (2 * l <= i) t = c;
+        // c ^= b << m
+        int mo = m >> 6, ms = m & 63;
+        for (int k = w - 1; k >= mo; k--) {
+            uint64_t r = b[k - mo] << ms;
+            if (ms && k - mo - 1 >= 0) r |= b[k - mo - 1] >> (64 - ms);
+            c[k] ^= r;
+        }
+        if (2 * l <= i) {
+            l = i + 1 - l;
+            b.swap(t);
+            m = 1;
+        } else {
+            m++;
+        }
+    }
+    // the characteristic polynomial is the reversed connection polynomial
+    gf2_poly p(l / 64 + 1);
+    for (int k = 0; k <= l; k++) {
+        if (gf2_coeff(c, k)) p[(l - k) >> 6] |= uint64_t(1) << ((l - k) & 63);
+    }
+    return p;
+}
+
+/**
+ * Arithmetic modulo a fixed polynomial `q` over GF(2), of degree `d >= 1`.
+ *
+ * The reduction xors the copies of `q` shifted by `0..63` bits, precomputed,
+ * so each term of the quotient takes `d / 64` word operations.
+ * The residues are kept in `d / 64 + 1` words.
+ */
+class gf2_poly_modulus {
+    int d;
+    std::vector<gf2_poly> qs; // `q << s` for `s` in `[0, 64)`
+
+public:
+    gf2_poly_modulus(const gf2_poly& q) : d(gf2_degree(q)), qs(64, gf2_poly(d / 64 + 2)) {
+        for (int s = 0; s < 64; s++) {
+            for (int i = 0; i <= d; i++) {
+                if (gf2_coeff(q, i)) qs[s][(i + s) >> 6] |= uint64_t(1) << ((i + s) & 63);
+            }
+        }
+    }
+
+    int degree() const { return d; }
+    size_t words() const { return size_t(d / 64 + 1); }
+
+    // reduces `r` modulo `q`; the words of `r` above `words()` are cleared
+    void reduce(gf2_poly& r) const {
+        for (int k = int(r.size()) - 1; k >= (d >> 6); k--) {
+            for (;;) {
+                uint64_t v = r[k];
+                if (k == (d >> 6)) v &= ~((uint64_t(1) << (d & 63)) - 1);
+                if (!v) break;
+                int s = k * 64 + math::ilog2_64(v) - d;
+                const gf2_poly& qsh = qs[s & 63];
+                for (size_t j = 0; j < qsh.size() && (s >> 6) + j < r.size(); j++) {
+                    r[(s >> 6) + j] ^= qsh[j];
+                }
+            }
+        }
+        r.resize(words());
+    }
+
+    // `r^2 mod q`; squaring over GF(2) spreads the bits apart
+    gf2_poly sqr(const gf2_poly& r) const {
+        gf2_poly t(2 * r.size());
+        for (size_t k = 0; k < r.size(); k++) {
+            t[2 * k] = spread(uint32_t(r[k]));
+            t[2 * k + 1] = spread(uint32_t(r[k] >> 32));
+        }
+        reduce(t);
+        return t;
+    }
+
+    // `r x mod q`
+    gf2_poly mul_x(const gf2_poly& r) const {
+        gf2_poly t(words() + 1);
+        for (size_t k = 0; k < r.size(); k++) {
+            t[k] |= r[k] << 1;
+            t[k + 1] |= r[k] >> 63;
+        }
+        reduce(t);
+        return t;
+    }
+
+    // `x^n mod q`
+    gf2_poly x_pow(uint64_t n) const {
+        gf2_poly r(words());
+        r[0] = 1;
+        reduce(r);
+        for (int i = n ? math::ilog2_64(n) : -1; i >= 0; i--) {
+            r = sqr(r);
+            if ((n >> i) & 1) r = mul_x(r);
+        }
+        return r;
+    }
+
+    // `x^(2^e) mod q`
+    gf2_poly x_pow2(int e) const {
+        gf2_poly r(words());
+        r[0] = 1;
+        r = mul_x(r);
+        for (int i = 0; i < e; i++) {
+            r = sqr(r);
+        }
+        return r;
+    }
+
+private:
+    static uint64_t spread(uint32_t x32) {
+        uint64_t x = x32;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+};
+
+} // random
+} // altruct
@@ -55,11 +55,17 @@
 
 #pragma once
 
+#include <climits>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <limits>
 #include <time.h>
+#include <vector>
+
+#include "random.h"
+#include "jump_ahead.h"
 
 namespace altruct {
 namespace random {
@@ -106,9 +112,21 @@ public:
     uint32 randInt(const uint32& n);        // integer in [0,n] for n < 2^32
     double operator()() { return rand(); }  // same as rand()
 
+    // Block access; the same values as `n` calls to randInt() or rand()
+    void fill(uint32* out, size_t n);       // integers in [0,2^32-1]
+    void fill_0_1(double* out, size_t n);   // real numbers in [0,1]
+
     // Access to 53-bit random numbers (capacity of IEEE double precision)
     double rand53();  // real number in [0,1)
 
+    // Jumping ahead; see jump_ahead.h
+    // The state is taken as the next N untempered words, which one step shifts by one word
+    static const gf2_poly& characteristicPolynomial();  // of degree 19938
+    static gf2_poly jumpPolynomial(uint64_t n);          // for advancing by n steps
+    static gf2_poly jumpPolynomialPow2(int e);           // for advancing by 2^e steps
+    void jump(const gf2_poly& r);                        // advance by a jump polynomial
+    void discard(uint64_t n);                            // same as n calls to randInt()
+
     // Access to nonuniform random number distributions
     double randNorm(const double& mean = 0.0, const double& variance = 0.0);
 
@@ -125,6 +143,7 @@ public:
 
 protected:
     void initialize(const uint32 oneSeed);
+    uint32 randRaw();
     void reload();
     uint32 hiBit(const uint32& u) const { return u & 0x80000000UL; }
     uint32 loBit(const uint32& u) const { return u & 0x00000001UL; }
@@ -133,6 +152,12 @@ protected:
     uint32 twist(const uint32& m, const uint32& s0, const uint32& s1) const {
         return m ^ (mixBits(s0, s1) >> 1) ^ ((uint32(0) - loBit(s1)) & 0x9908b0dfUL);
     }
+    static uint32 temper(uint32 s1) {
+        s1 ^= (s1 >> 11);
+        s1 ^= (s1 << 7) & 0x9d2c5680UL;
+        s1 ^= (s1 << 15) & 0xefc60000UL;
+        return (s1 ^ (s1 >> 18));
+    }
     uint32 orDown(uint32 u) const {
         u |= u >> 1;
         u |= u >> 2;
@@ -198,15 +223,84 @@ inline mtrand::uint32 mtrand::randInt() {
     // Pull a 32-bit integer from the generator state
     // Every other access function simply transforms the numbers extracted here
 
+    return temper(randRaw());
+}
+
+inline mtrand::uint32 mtrand::randRaw() {
+    // Pull the next untempered word from the generator state
     if (left == 0) reload();
     --left;
+    return *pNext++;
+}
+
+inline const gf2_poly& mtrand::characteristicPolynomial() {
+    // The top bit of the state words only depends on the 19937 bits that carry over
+    // between the steps, so its minimal polynomial is the one of degree 19937 of those.
+    // The lower 31 bits of the first word are dropped by a step, hence the extra factor x.
+    static const gf2_poly p = []() {
+        mtrand rng(5489UL);
+        std::vector<uint8_t> bits(2 * 19937 + 64);
+        for (auto& b : bits) b = uint8_t(rng.randRaw() >> 31);
+        gf2_poly q = gf2_minimal_polynomial(bits);
+        gf2_poly r(q.size() + 1);
+        for (size_t k = 0; k < q.size(); k++) {
+            r[k] |= q[k] << 1;
+            r[k + 1] |= q[k] >> 63;
+        }
+        return r;
+    }();
+    return p;
+}
+
+inline gf2_poly mtrand::jumpPolynomial(uint64_t n) {
+    return gf2_poly_modulus(characteristicPolynomial()).x_pow(n);
+}
+
+inline gf2_poly mtrand::jumpPolynomialPow2(int e) {
+    return gf2_poly_modulus(characteristicPolynomial()).x_pow2(e);
+}
+
+inline void mtrand::jump(const gf2_poly& r) {
+    // Sum the states after i steps for the coefficients of x^i in r
+    uint32 w[N], t[N] = {};
+    for (int k = 0; k < N; k++) w[k] = randRaw();
+    int deg = gf2_degree(characteristicPolynomial());
+    for (int i = 0, j = 0; i < deg; i++) {
+        if (gf2_coeff(r, i)) {
+            for (int k = 0; k < N - j; k++) t[k] ^= w[j + k];
+            for (int k = N - j; k < N; k++) t[k] ^= w[j + k - N];
+        }
+        // one step: w[j..] becomes w[j+1..]
+        w[j] = twist(w[(j + M) % N], w[j], w[(j + 1) % N]);
+        if (++j == N) j = 0;
+    }
+    for (int k = 0; k < N; k++) state[k] = t[k];
+    left = N, pNext = state;
+}
+
+inline void mtrand::discard(uint64_t n) {
+    // Stepping is cheaper than computing the jump polynomial for the short distances
+    if (n < (uint64_t(1) << 24)) {
+        for (; n > 0; n--) randRaw();
+    } else {
+        jump(jumpPolynomial(n));
+    }
+}
+
+inline void mtrand::fill(uint32* out, size_t n) {
+    // Temper the remaining state words in bulk, reloading as needed
+    while (n > 0) {
+        if (left == 0) reload();
+        size_t k = (n < size_t(left)) ? n : size_t(left);
+        for (size_t i = 0; i < k; i++)
+            out[i] = temper(pNext[i]);
+        pNext += k;  left -= int(k);
+        out += k;  n -= k;
+    }
+}
 
-    uint32 s1;
-    s1 = *pNext++;
-    s1 ^= (s1 >> 11);
-    s1 ^= (s1 << 7) & 0x9d2c5680UL;
-    s1 ^= (s1 << 15) & 0xefc60000UL;
-    return (s1 ^ (s1 >> 18));
+inline void mtrand::fill_0_1(double* out, size_t n) {
+    random::fill_0_1<uint32>(out, n, [&](uint32* buf, size_t k) { fill(buf, k); });
 }
 
 inline mtrand::uint32 mtrand::randInt(const uint32& n) {
@@ -297,13 +391,15 @@ inline void mtrand::initialize(const uint32 seed) {
 inline void mtrand::reload() {
     // Generate N new values in state
     // Made clearer and faster by Matthew Bellew (matthew.bellew@home.com)
-    uint32 *p = state;
-    int i;
-    for (i = N - M; i--; ++p)
-        *p = twist(p[M], p[0], p[1]);
-    for (i = M; --i; ++p)
-        *p = twist(p[M - N], p[0], p[1]);
-    *p = twist(p[M - N], p[0], state[0]);
+    // Indexed form, so that the compiler can vectorize the loops: the first loop
+    // only reads the words ahead of the one being written, and the second one
+    // reads the words N - M behind it, which is more than any vector width
+    int i = 0;
+    for (; i < N - M; ++i)
+        state[i] = twist(state[i + M], state[i], state[i + 1]);
+    for (; i < N - 1; ++i)
+        state[i] = twist(state[i + M - N], state[i], state[i + 1]);
+    state[N - 1] = twist(state[M - 1], state[N - 1], state[0]);
 
     left = N, pNext = state;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <functional>
@@ -17,6 +19,25 @@ double integer_to_double_0_1(U val) {
     return val * (1.0 / (double)std::numeric_limits<U>::max());
 }
 
+/**
+ * Fills `out` with `n` doubles in the `[0, 1]` range, both inclusive.
+ *
+ * The unsigned integers are taken from `fill(U* buf, size_t k)` in blocks,
+ * and mapped with `integer_to_double_0_1`. A generator's `fill_0_1` uses this
+ * with its own `fill`, so that it gives the same values as its `next_0_1`.
+ */
+template<typename U, typename F>
+void fill_0_1(double* out, size_t n, F fill) {
+    U buf[64];
+    for (size_t i = 0; i < n; i += 64) {
+        size_t k = std::min(n - i, size_t(64));
+        fill(buf, k);
+        for (size_t j = 0; j < k; j++) {
+            out[i + j] = integer_to_double_0_1<U>(buf[j]);
+        }
+    }
+}
+
 /**
  * Maps unsigned integer to an integer in the `[min, max]` range, both inclusive.
  *
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 #include "random.h"
+#include "jump_ahead.h"
 
 namespace altruct {
 namespace random {
@@ -71,6 +75,79 @@ public:
         return integer_to_double_0_1<uint64_t>(next());
     }
 
+    /**
+     * Fills `out` with the next `n` random numbers.
+     * Produces the same values as `n` calls to {@code next}, with the state kept in a register.
+     */
+    void fill(uint64_t* out, size_t n) {
+        uint64_t x = x_;
+        for (size_t i = 0; i < n; i++) {
+            x ^= x >> 12; // a
+            x ^= x << 25; // b
+            x ^= x >> 27; // c
+            out[i] = x * 2685821657736338717ULL;
+        }
+        x_ = x;
+    }
+
+    /**
+     * Fills `out` with the next `n` random numbers as doubles in [0, 1] range, both inclusive.
+     * Produces the same values as `n` calls to {@code next_0_1}.
+     */
+    void fill_0_1(double* out, size_t n) {
+        random::fill_0_1<uint64_t>(out, n, [&](uint64_t* buf, size_t k) { fill(buf, k); });
+    }
+
+    /**
+     * The characteristic polynomial of the state transition, of degree 64.
+     */
+    static const gf2_poly& characteristic_polynomial() {
+        static const gf2_poly p = []() {
+            xorshift_64star rng;
+            std::vector<uint8_t> bits(2 * 64);
+            for (auto& b : bits) {
+                rng.next();
+                b = uint8_t(rng.x_ & 1);
+            }
+            return gf2_minimal_polynomial(bits);
+        }();
+        return p;
+    }
+
+    /**
+     * The polynomial for {@code jump} that advances the state by `n` steps.
+     * Jumping with the same polynomial repeatedly gives non-overlapping streams `n` values apart.
+     */
+    static gf2_poly jump_polynomial(uint64_t n) {
+        return gf2_poly_modulus(characteristic_polynomial()).x_pow(n);
+    }
+
+    /**
+     * The polynomial for {@code jump} that advances the state by `2^e` steps.
+     */
+    static gf2_poly jump_polynomial_pow2(int e) {
+        return gf2_poly_modulus(characteristic_polynomial()).x_pow2(e);
+    }
+
+    /**
+     * Advances the state by the number of steps given by the polynomial from {@code jump_polynomial}.
+     */
+    void jump(const gf2_poly& r) {
+        uint64_t t = 0;
+        for (int i = 0; i < 64; i++) {
+            if (gf2_coeff(r, i)) t ^= x_;
+            next();
+        }
+        x_ = t;
+    }
+
+    /**
+     * Advances the state by `n` steps; the same as `n` calls to {@code next}, in `O(log n)`.
+     */
+    void discard(uint64_t n) {
+        jump(jump_polynomial(n));
+    }
+
 private:
     /* The state. Must be seeded with a nonzero value. */
     uint64_t x_;
@@ -173,6 +250,105 @@ public:
         return integer_to_double_0_1<uint64_t>(next());
     }
 
+    /**
+     * Fills `out` with the next `n` random numbers.
+     * Produces the same values as `n` calls to {@code next}.
+     *
+     * The values are generated in rounds of 16, after which `p_` is back where it started.
+     * Within a round, the `s1` part of each step depends only on the state before the round,
+     * so it is computed for all the 16 steps at once (and vectorized by the compiler);
+     * only the cheap `s0` part remains a serial dependency chain.
+     */
+    void fill(uint64_t* out, size_t n) {
+        // single steps up to the start of the state, so that the rounds use fixed indices
+        for (; n > 0 && p_ != 0; n--) {
+            *out++ = next();
+        }
+        for (; n >= 16; n -= 16, out += 16) {
+            uint64_t t[16];
+            for (int j = 0; j < 16; j++) {
+                uint64_t s1 = s_[(j + 1) & 15];
+                s1 ^= s1 << 31; // a
+                t[j] = s1 ^ (s1 >> 11); // b
+            }
+            uint64_t s0 = s_[0];
+            for (int j = 0; j < 16; j++) {
+                s0 = s0 ^ (s0 >> 30) ^ t[j]; // c
+                s_[(j + 1) & 15] = s0;
+                out[j] = s0 * 1181783497276652981ULL;
+            }
+        }
+        for (; n > 0; n--) {
+            *out++ = next();
+        }
+    }
+
+    /**
+     * Fills `out` with the next `n` random numbers as doubles in [0, 1] range, both inclusive.
+     * Produces the same values as `n` calls to {@code next_0_1}.
+     */
+    void fill_0_1(double* out, size_t n) {
+        random::fill_0_1<uint64_t>(out, n, [&](uint64_t* buf, size_t k) { fill(buf, k); });
+    }
+
+    /**
+     * The characteristic polynomial of the state transition, of degree 1024.
+     */
+    static const gf2_poly& characteristic_polynomial() {
+        static const gf2_poly p = []() {
+            xorshift_1024star rng;
+            std::vector<uint8_t> bits(2 * 1024);
+            for (auto& b : bits) {
+                rng.next();
+                b = uint8_t(rng.s_[rng.p_] & 1);
+            }
+            return gf2_minimal_polynomial(bits);
+        }();
+        return p;
+    }
+
+    /**
+     * The polynomial for {@code jump} that advances the state by `n` steps.
+     * Jumping with the same polynomial repeatedly gives non-overlapping streams `n` values apart.
+     */
+    static gf2_poly jump_polynomial(uint64_t n) {
+        return gf2_poly_modulus(characteristic_polynomial()).x_pow(n);
+    }
+
+    /**
+     * The polynomial for {@code jump} that advances the state by `2^e` steps.
+     * E.g. `e = 512` gives 2^512 non-overlapping streams of 2^512 values each.
+     */
+    static gf2_poly jump_polynomial_pow2(int e) {
+        return gf2_poly_modulus(characteristic_polynomial()).x_pow2(e);
+    }
+
+    /**
+     * Advances the state by the number of steps given by the polynomial from {@code jump_polynomial}.
+     * The state is taken relative to `p_`, which is where a step leaves it.
+     */
+    void jump(const gf2_poly& r) {
+        uint64_t t[16] = {};
+        for (int i = 0; i < 1024; i++) {
+            if (gf2_coeff(r, i)) {
+                for (int j = 0; j < 16; j++) {
+                    t[j] ^= s_[(j + p_) & 15];
+                }
+            }
+            next();
+        }
+        for (int j = 0; j < 16; j++) {
+            s_[(j + p_) & 15] = t[j];
+        }
+    }
+
+    /**
+     * Advances the state by `n` steps; the same as `n` calls to {@code next}, in `O(log n)`.
+     */
+    void discard(uint64_t n) {
+        jump(jump_polynomial(n));
+    }
+
 private:
     /**
      * The state must be seeded so that it is not everywhere zero. If you have
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "altruct/concurrency/executor.h"
+
 #include <algorithm>
 #include <thread>
 #include <mutex>
@@ -102,6 +104,47 @@ struct range_job_provider {
     std::pair<I, I> next_job() { begin += len; return{ begin - len, std::min(begin, end) }; }
 };
 
+/**
+ * Parallelly executes `f(b, e)` over the consecutive subranges of `[begin, end)`.
+ *
+ * The range is split into `num_threads` subranges of roughly equal length.
+ * There is exactly one call to `f` per subrange.
+ */
+template<typename I, typename F>
+void parallel_for_range(I begin, I end, F f, int num_threads) {
+    if (begin >= end) return;
+    if (num_threads <= 1 || end - begin < 2) {
+        f(begin, end);
+        return;
+    }
+    struct range_worker_provider {
+        F& f;
+        struct range_worker {
+            F& f;
+            int execute_job(const std::pair<I, I>& job) { f(job.first, job.second); return 0; }
+        };
+        range_worker create_worker() { return range_worker{ f }; }
+    };
+    I len = (end - begin + num_threads - 1) / num_threads;
+    add_result_collector<int> rc;
+    range_job_provider<I> jp(begin, end, len);
+    range_worker_provider wp{ f };
+    parallel_execute(rc, jp, wp, num_threads);
+}
+
+/**
+ * A range executor that splits the range among `num_threads` threads.
+ * See `serial_range_executor`.
+ */
+struct parallel_range_executor {
+    int num_threads;
+    parallel_range_executor(int num_threads) : num_threads(num_threads) {}
+    template<typename F>
+    void operator () (int begin, int end, F f) const {
+        parallel_for_range(begin, end, f, num_threads);
+    }
+};
+
 
 } // concurrency
 } // altruct
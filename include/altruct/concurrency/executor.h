@@ -0,0 +1,22 @@
+#pragma once
+
+namespace altruct {
+namespace concurrency {
+
+/**
+ * A range executor that executes `f(begin, end)` over the whole range at once.
+ *
+ * Bulk operations (e.g. matrix row operations, or segment tree levels)
+ * are dispatched through a range executor, so that a parallel one can be
+ * provided instead to split the range `[begin, end)` among multiple threads.
+ * See `parallel_range_executor` in `concurrency.h`.
+ */
+struct serial_range_executor {
+    template<typename F>
+    void operator () (int begin, int end, F f) const {
+        if (begin < end) f(begin, end);
+    }
+};
+
+} // concurrency
+} // altruct
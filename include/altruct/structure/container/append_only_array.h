@@ -0,0 +1,84 @@
+#pragma once
+
+#include "altruct/algorithm/math/intrinsic.h"
+
+#include <atomic>
+#include <stddef.h>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Append-only array with lock-free concurrent readers.
+ *
+ * The elements are stored in chunks of doubling sizes, so growing never moves
+ * the existing elements, and references to them stay valid for the lifetime of the array.
+ * The writer first makes room with `reserve`, then writes the new elements,
+ * and finally publishes them with `resize`. The size is published with the release
+ * semantics, so a reader that observes `size() > i` also observes the element `i`,
+ * without any locking, while the writer keeps growing the array.
+ *
+ * Important: there can be only one writer at a time; concurrent writers have to be
+ * serialized externally (e.g. by a mutex).
+ *
+ * Space complexity: `O(n)`, at most twice the size plus `2^FIRST_LOG`.
+ * Time complexities:
+ *   access: `O(1)`
+ *   grow:   `O(1)` amortized per element
+ *
+ * param T         - element type, default-constructible
+ * param FIRST_LOG - log2 of the size of the first chunk
+ */
+template<typename T, int FIRST_LOG = 6>
+class append_only_array {
+public:
+    static const int MAX_CHUNKS = 64 - FIRST_LOG;
+
+protected:
+    T* chunks[MAX_CHUNKS]; // chunk `c` holds the elements `[(2^c - 1) 2^FIRST_LOG, (2^(c+1) - 1) 2^FIRST_LOG)`
+    int num_chunks;
+    std::atomic<size_t> sz;
+
+public:
+    append_only_array() : num_chunks(0), sz(0) {}
+
+    append_only_array(const append_only_array&) = delete;
+    append_only_array& operator=(const append_only_array&) = delete;
+
+    ~append_only_array() {
+        for (int c = 0; c < num_chunks; c++) delete[] chunks[c];
+    }
+
+    // the number of the published elements; safe to call concurrently with the writer
+    size_t size() const { return sz.load(std::memory_order_acquire); }
+
+    // the number of the elements that fit without allocating; writer only
+    size_t capacity() const { return ((size_t(1) << num_chunks) - 1) << FIRST_LOG; }
+
+    // readers may only access the published elements; the writer may access any element below `capacity()`
+    const T& operator[](size_t i) const { return locate(i); }
+    T& operator[](size_t i) { return const_cast<T&>(locate(i)); }
+
+    // makes room for at least `n` elements, without publishing them; writer only
+    void reserve(size_t n) {
+        while (capacity() < n) {
+            chunks[num_chunks] = new T[size_t(1) << (num_chunks + FIRST_LOG)]();
+            num_chunks++;
+        }
+    }
+
+    // publishes the elements `[0, n)`, which must have been written already; writer only
+    void resize(size_t n) {
+        reserve(n);
+        sz.store(n, std::memory_order_release);
+    }
+
+private:
+    const T& locate(size_t i) const {
+        int c = math::ilog2_64((i >> FIRST_LOG) + 1);
+        return chunks[c][i + (size_t(1) << FIRST_LOG) - (size_t(1) << (c + FIRST_LOG))];
+    }
+};
+
+} // container
+} // altruct
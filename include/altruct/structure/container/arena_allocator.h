@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace altruct {
+namespace container {
+
+/**
+ * The slabs behind `arena_allocator`, shared by all of its copies and rebinds.
+ *
+ * There is a pool of equally sized slots per distinct slot size (and alignment),
+ * so that the allocators rebound to different types (e.g. a container's node types)
+ * share the arena without sharing the slots.
+ */
+class allocator_arena {
+public:
+    class pool {
+        struct slot { slot* next; };
+        std::vector<char*> slabs;
+        slot* free_list;
+        char* cur; // next slot of the last slab that was never allocated
+        char* end;
+        size_t slot_size;
+        size_t slab_size;
+        size_t first_slab_size;
+        size_t max_slab_size;
+        size_t size_;
+        size_t capacity_;
+
+        void grow() {
+            char* s = static_cast<char*>(::operator new(slab_size * slot_size));
+            slabs.push_back(s);
+            cur = s, end = s + slab_size * slot_size;
+            capacity_ += slab_size;
+            slab_size = std::min(slab_size * 2, max_slab_size);
+        }
+
+    public:
+        const size_t size_key;
+        const size_t align_key;
+
+        pool(size_t size, size_t align, size_t slab_size, size_t max_slab_size) :
+            free_list(nullptr), cur(nullptr), end(nullptr),
+            slot_size((std::max(size, sizeof(slot)) + align - 1) / align * align),
+            slab_size(slab_size), first_slab_size(slab_size), max_slab_size(max_slab_size),
+            size_(0), capacity_(0), size_key(size), align_key(align) {}
+
+        ~pool() {
+            release();
+        }
+
+        // the number of slots currently allocated
+        size_t size() const { return size_; }
+        // the number of slots all the slabs can hold
+        size_t capacity() const { return capacity_; }
+
+        void* allocate() {
+            void* p;
+            if (free_list) {
+                p = free_list;
+                free_list = free_list->next;
+            } else {
+                if (cur == end) grow();
+                p = cur;
+                cur += slot_size;
+            }
+            size_++;
+            return p;
+        }
+
+        void deallocate(void* ptr) {
+            slot* s = static_cast<slot*>(ptr);
+            s->next = free_list;
+            free_list = s;
+            size_--;
+        }
+
+        // Returns all the slabs to the system at once; no destructors get called.
+        void release() {
+            for (char* s : slabs) ::operator delete(s);
+            slabs.clear();
+            free_list = nullptr;
+            cur = end = nullptr;
+            slab_size = first_slab_size;
+            size_ = capacity_ = 0;
+        }
+    };
+
+private:
+    std::vector<std::unique_ptr<pool>> pools;
+    size_t slab_size;
+    size_t max_slab_size;
+
+public:
+    allocator_arena(size_t slab_size, size_t max_slab_size) :
+        slab_size(slab_size), max_slab_size(max_slab_size) {}
+
+    // the pool for the slots of the given size and alignment; created on the first use
+    pool* get_pool(size_t size, size_t align) {
+        for (auto& p : pools) {
+            if (p->size_key == size && p->align_key == align) return p.get();
+        }
+        pools.emplace_back(new pool(size, align, slab_size, max_slab_size));
+        return pools.back().get();
+    }
+
+    // Returns the slabs of all the pools to the system at once; no destructors get called.
+    // Any previously allocated element must not be used afterwards.
+    void release() {
+        for (auto& p : pools) p->release();
+    }
+};
+
+/**
+ * Allocator that provides elements from growable contiguous slabs.
+ *
+ * Intended for node based containers such as `binary_search_tree`, `treap`,
+ * `lazy_treap`, `rope` and `link_cut_tree`. Deallocated elements are recycled
+ * through an intrusive free list, and the slabs are only returned to the
+ * system all at once, when the last copy of the allocator gets destroyed
+ * or on `release`. Copies of the allocator, as well as the rebound allocators
+ * (e.g. for a different node type), share the same arena and compare equal;
+ * each element size gets its own pool of slots within the arena.
+ *
+ * Important: allocator is stateful and hence requires C++11
+ * Important: only 1 element can be allocated at time
+ * Important: allocator is not thread-safe
+ *
+ * @param slab_size - number of elements in the first slab;
+ *                    each next slab is twice as big, up to `max_slab_size`.
+ */
+template <class T>
+struct arena_allocator {
+    typedef T value_type;
+    typedef allocator_arena::pool pool;
+
+    std::shared_ptr<allocator_arena> arena_;
+    pool* pool_;
+
+    arena_allocator(size_t slab_size = 64, size_t max_slab_size = 65536)
+        : arena_(std::make_shared<allocator_arena>(slab_size, max_slab_size)),
+        pool_(arena_->get_pool(sizeof(T), alignof(T))) {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& allocator)
+        : arena_(allocator.arena_),
+        pool_(arena_->get_pool(sizeof(T), alignof(T))) {
+    }
+
+    // the number of elements of this type currently allocated
+    size_t size() const { return pool_->size(); }
+    // the number of elements of this type all the slabs can hold
+    size_t capacity() const { return pool_->capacity(); }
+    // releases the slabs of all the types
+    void release() { arena_->release(); }
+
+    T* allocate(size_t n) {
+        if (n != 1) throw std::bad_alloc();
+        return static_cast<T*>(pool_->allocate());
+    }
+
+    void deallocate(T* ptr, size_t) {
+        pool_->deallocate(ptr);
+    }
+
+    template<class U, class... Args>
+    void construct(U* ptr, Args&&... args) {
+        ::new((void*)ptr) U(std::forward<Args>(args)...);
+    }
+
+    template<class U>
+    void destroy(U* ptr) {
+        ptr->~U();
+    }
+};
+
+} // container
+} // altruct
+
+template <class T, class U>
+bool operator== (const altruct::container::arena_allocator<T>& lhs,
+                 const altruct::container::arena_allocator<U>& rhs) {
+    return (const void*)lhs.arena_.get() == (const void*)rhs.arena_.get();
+}
+
+template <class T, class U>
+bool operator!= (const altruct::container::arena_allocator<T>& lhs,
+                 const altruct::container::arena_allocator<U>& rhs) {
+    return !(lhs == rhs);
+}
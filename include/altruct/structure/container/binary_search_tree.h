@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <iterator>
 #include <type_traits>
 #include <algorithm>
+#include <vector>
 
 namespace altruct {
 namespace container {
@@ -43,7 +45,7 @@ struct bst_key<K, std::pair<const K, V>> {
  * random number for treap, etc.
  *
  * A node whose parent points to itself is a special `nil` node as described in
- * `binary_search_tree` class.
+ * `binary_search_tree` class. All the `nil` nodes are equivalent for the iterators.
  */
 template<typename T>
 struct bst_node {
@@ -100,7 +102,8 @@ struct bst_iterator_util {
     static const_node_ptr inorder_add(const_node_ptr ptr, int off) {
         const_node_ptr nil;
         int pos = bst_iterator_util<T>::inorder_pos(ptr, &nil);
-        return bst_iterator_util<T>::inorder_kth(nil->left, pos + off);
+        const_node_ptr res = bst_iterator_util<T>::inorder_kth(nil->left, pos + off);
+        return res->is_nil() ? nil : res;
     }
     static node_ptr inorder_add(node_ptr ptr, int off) {
         return remove_const(inorder_add(const_node_ptr(ptr), off));
@@ -120,7 +123,8 @@ struct bst_iterator_util {
         return inorder_pos(const_node_ptr(ptr), (const_node_ptr*)out_nil);
     }
 
-    // node pointer at k-th position within the subtree rooted at ptr
+    // node pointer at k-th position within the subtree rooted at ptr;
+    // for the positions out of range this returns a leaf nil
     static const_node_ptr inorder_kth(const_node_ptr ptr, int k) {
         while (!ptr->is_nil()) {
             if (k < ptr->left->size) {
@@ -154,11 +158,13 @@ struct bst_iterator : public std::iterator<std::bidirectional_iterator_tag, T> {
 
     int count() const { return ptr->count(); }
     int size() const { return ptr->size; }
+    // whether this is `end()` or a leaf nil; use this rather than `== end()` for the children
+    bool is_nil() const { return ptr->is_nil(); }
     int& balance() { return ptr->balance; }
     T& operator * () { return ptr->val; }
     T* operator -> () { return &ptr->val; }
     bool operator == (const bst_iterator& rhs) const { return ptr == rhs.ptr; }
-    bool operator != (const bst_iterator& rhs) const { return ptr != rhs.ptr; }
+    bool operator != (const bst_iterator& rhs) const { return !(*this == rhs); }
     bst_iterator& operator--() { ptr = bst_iterator_util<T>::inorder_prev(ptr); return *this; }
     bst_iterator operator--(int) { auto old = *this; --*this; return old; }
     bst_iterator& operator++() { ptr = bst_iterator_util<T>::inorder_next(ptr); return *this; }
@@ -187,11 +193,12 @@ struct bst_const_iterator : public std::iterator<std::bidirectional_iterator_tag
 
     int count() const { return ptr->count(); }
     int size() const { return ptr->size; }
+    bool is_nil() const { return ptr->is_nil(); }
     int& balance() { return *const_cast<int*>(&ptr->balance); }
     const T& operator * () const { return ptr->val; }
     const T* operator -> () const { return &ptr->val; }
     bool operator == (const bst_const_iterator& rhs) const { return ptr == rhs.ptr; }
-    bool operator != (const bst_const_iterator& rhs) const { return ptr != rhs.ptr; }
+    bool operator != (const bst_const_iterator& rhs) const { return !(*this == rhs); }
     bst_const_iterator& operator--() { ptr = bst_iterator_util<T>::inorder_prev(ptr); return *this; }
     bst_const_iterator operator--(int) { auto old = *this; --*this; return old; }
     bst_const_iterator& operator++() { ptr = bst_iterator_util<T>::inorder_next(ptr); return *this; }
@@ -218,6 +225,43 @@ namespace bst_duplicate_handling {
     };
 }
 
+/**
+ * Default random generator for the randomized trees (e.g. treap).
+ *
+ * A small xorshift generator that gets inlined into the balancing code,
+ * as opposed to a type-erased `std::function` wrapping `rand`.
+ * Returns non-negative values.
+ */
+struct bst_random {
+    uint32_t s;
+    bst_random(uint32_t seed = 2463534242U) : s(seed) {}
+    int operator () () {
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        return int(s >> 1);
+    }
+};
+
+/**
+ * The default value for the random generator of type `RAND`.
+ * Type-erased generators (e.g. `std::function<int()>`) wrap `bst_random`.
+ */
+template<typename RAND>
+typename std::enable_if<std::is_constructible<RAND, bst_random>::value, RAND>::type bst_default_random() {
+    return RAND(bst_random());
+}
+template<typename RAND>
+typename std::enable_if<!std::is_constructible<RAND, bst_random>::value, RAND>::type bst_default_random() {
+    return RAND();
+}
+
+/**
+ * A no-op hook for the bulk operations (e.g. `assign_sorted`, `split`, `join`).
+ */
+struct bst_no_hook {
+    template<typename IT>
+    void operator () (IT) const {}
+};
+
 /**
  * Binary search tree.
  *
@@ -275,8 +319,18 @@ protected: // member variables
     // *   begin == inorder_next(nil)
     // *   nil == inorder_prev(begin)
     // *   nil == inorder_next(last)
+    // The leaves however point to `leaf_nil()`, a `nil` node shared by all the trees
+    // of this type and never written to. This way the nodes can be moved between
+    // the trees (see `split` and `join`) without relinking their leaves.
+    // So a missing child is not `end()`; check it with `is_nil()` instead.
     node_ptr nil;
 
+    static node_ptr leaf_nil() {
+        static typename std::aligned_storage<sizeof(bst_node<T>), alignof(bst_node<T>)>::type storage;
+        static node_ptr leaf = _init_nil(reinterpret_cast<node_ptr>(&storage));
+        return leaf;
+    }
+
     node_ptr root_ptr() {
         return nil->left;
     }
@@ -335,7 +389,7 @@ public: // constructor & size
     }
 
     void clear() {
-        _free(root_ptr());
+        _free_all(root_ptr());
         nil->left = nil;
         nil->right = nil;
     }
@@ -424,7 +478,8 @@ public: // query & update
     }
 
     const_iterator find_kth(int k) const {
-        return bst_iterator_util<T>::inorder_kth(root_ptr(), k);
+        const_node_ptr ptr = bst_iterator_util<T>::inorder_kth(root_ptr(), k);
+        return ptr->is_nil() ? nil : ptr;
     }
 
     iterator find_kth(int k) {
@@ -550,6 +605,88 @@ public: // query & update
         // for treap like trees: `ptr` needs to be retraced down before erase
     }
 
+public: // bulk operations
+    // whether the range is sorted; always false for single-pass iterators
+    template<typename It>
+    bool is_sorted(It begin, It end) const {
+        return _is_sorted(begin, end, typename std::iterator_traits<It>::iterator_category());
+    }
+
+    // Replaces the content with the elements of the sorted range in `O(n)`.
+    // The tree is built as a Cartesian tree with respect to the balance,
+    // i.e. each node's balance is not greater than the balance of its children.
+    // `f_balance()` provides the balance for each new node.
+    // `f_finish(it)` gets called for each node once its subtree is complete.
+    // important: this call is unchecked and the sort order may be violated
+    template<typename It, typename F_BALANCE, typename F_FINISH = bst_no_hook>
+    void assign_sorted(It begin, It end, F_BALANCE f_balance, F_FINISH f_finish = F_FINISH()) {
+        clear();
+        std::vector<node_ptr> spine; // the right spine of the tree built so far
+        auto finish = [&](node_ptr ptr) {
+            ptr->size += ptr->left->size + ptr->right->size;
+            f_finish(iterator(ptr));
+        };
+        for (It it = begin; it != end; ++it) {
+            const T& val = *it;
+            if (DUP != bst_duplicate_handling::STORE && !spine.empty() && !cmp(_key(spine.back()->val), _key(val))) {
+                // the last node is always on top of the spine
+                if (DUP == bst_duplicate_handling::COUNT) spine.back()->size++;
+                continue;
+            }
+            node_ptr ptr = _buy(val);
+            ptr->parent = nil;
+            ptr->left = leaf_nil();
+            ptr->right = leaf_nil();
+            ptr->balance = f_balance();
+            ptr->size = 1;
+            node_ptr ch = leaf_nil();
+            while (!spine.empty() && spine.back()->balance > ptr->balance) {
+                ch = spine.back(); spine.pop_back();
+                finish(ch);
+            }
+            make_link(ptr, ch, true);
+            if (!spine.empty()) make_link(spine.back(), ptr, false);
+            spine.push_back(ptr);
+        }
+        if (spine.empty()) return;
+        node_ptr root = spine.front();
+        while (!spine.empty()) {
+            finish(spine.back()); spine.pop_back();
+        }
+        make_link(nil, root, true);
+    }
+
+    // Moves the elements whose keys are not less than `key` to `rhs`, replacing its content.
+    // The nodes are moved between the trees, so the allocators need to be interchangeable.
+    // `f_down(it)` gets called before visiting a node, `f_up(it)` after its children change.
+    // Complexity: `O(h)`.
+    template<typename F_DOWN = bst_no_hook, typename F_UP = bst_no_hook>
+    void split(const K& key, binary_search_tree& rhs, F_DOWN f_down = F_DOWN(), F_UP f_up = F_UP()) {
+        node_ptr l, r;
+        _split_key(root_ptr(), key, l, r, f_down, f_up);
+        _distribute(l, r, rhs);
+    }
+
+    // Moves the elements at positions `k` and above to `rhs`, replacing its content.
+    // `split_kth` is not suitable when duplicate mode is set to COUNT
+    template<typename F_DOWN = bst_no_hook, typename F_UP = bst_no_hook>
+    void split_kth(int k, binary_search_tree& rhs, F_DOWN f_down = F_DOWN(), F_UP f_up = F_UP()) {
+        node_ptr l, r;
+        _split_kth(root_ptr(), k, l, r, f_down, f_up);
+        _distribute(l, r, rhs);
+    }
+
+    // Moves all the elements of `rhs` after the elements of this tree.
+    // The node with the smaller balance ends up higher in the tree.
+    // Complexity: `O(h)`, where `h` is the height of the taller tree.
+    // important: this call is unchecked and the sort order may be violated
+    template<typename F_DOWN = bst_no_hook, typename F_UP = bst_no_hook>
+    void join(binary_search_tree& rhs, F_DOWN f_down = F_DOWN(), F_UP f_up = F_UP()) {
+        if (rhs.empty()) return;
+        make_link(nil, _join(root_ptr(), rhs.root_ptr(), f_down, f_up), true);
+        make_link(rhs.nil, rhs.nil, true);
+    }
+
 public: // const casting logic
     iterator remove_const(const_iterator it) {
         // the iterator itself is const, but this method is not so this is safe
@@ -567,8 +704,8 @@ protected: // insert & erase
         if (ptr->is_nil()) {
             ptr = _buy(val);
             ptr->parent = par;
-            ptr->left = nil;
-            ptr->right = nil;
+            ptr->left = leaf_nil();
+            ptr->right = leaf_nil();
             ptr->size = 0;
             make_link(par, ptr, go_left);
         }
@@ -602,10 +739,77 @@ protected: // insert & erase
         return par;
     }
 
+    template<typename F_DOWN, typename F_UP>
+    void _split_key(node_ptr ptr, const K& key, node_ptr& l, node_ptr& r, F_DOWN& f_down, F_UP& f_up) {
+        if (ptr->is_nil()) { l = r = leaf_nil(); return; }
+        f_down(iterator(ptr));
+        int cnt = ptr->count();
+        if (cmp(_key(ptr->val), key)) {
+            _split_key(ptr->right, key, ptr->right, r, f_down, f_up);
+            l = ptr;
+        } else {
+            _split_key(ptr->left, key, l, ptr->left, f_down, f_up);
+            r = ptr;
+        }
+        update_children(ptr, cnt);
+        f_up(iterator(ptr));
+    }
+
+    template<typename F_DOWN, typename F_UP>
+    void _split_kth(node_ptr ptr, int k, node_ptr& l, node_ptr& r, F_DOWN& f_down, F_UP& f_up) {
+        if (ptr->is_nil()) { l = r = leaf_nil(); return; }
+        f_down(iterator(ptr));
+        int cnt = ptr->count();
+        int k_right = k - ptr->left->size - cnt;
+        if (k_right >= 0) {
+            _split_kth(ptr->right, k_right, ptr->right, r, f_down, f_up);
+            l = ptr;
+        } else {
+            _split_kth(ptr->left, k, l, ptr->left, f_down, f_up);
+            r = ptr;
+        }
+        update_children(ptr, cnt);
+        f_up(iterator(ptr));
+    }
+
+    template<typename F_DOWN, typename F_UP>
+    node_ptr _join(node_ptr l, node_ptr r, F_DOWN& f_down, F_UP& f_up) {
+        if (l->is_nil()) return r;
+        if (r->is_nil()) return l;
+        node_ptr ptr = (l->balance <= r->balance) ? l : r;
+        f_down(iterator(ptr));
+        int cnt = ptr->count();
+        if (ptr == l) {
+            l->right = _join(l->right, r, f_down, f_up);
+        } else {
+            r->left = _join(l, r->left, f_down, f_up);
+        }
+        update_children(ptr, cnt);
+        f_up(iterator(ptr));
+        return ptr;
+    }
+
+    // the left part stays in this tree, the right part goes to `rhs`
+    void _distribute(node_ptr l, node_ptr r, binary_search_tree& rhs) {
+        rhs.clear();
+        make_link(nil, l, true);
+        make_link(rhs.nil, r, true);
+    }
+
+    template<typename It>
+    bool _is_sorted(It begin, It end, std::input_iterator_tag) const {
+        return false;
+    }
+
+    template<typename It>
+    bool _is_sorted(It begin, It end, std::forward_iterator_tag) const {
+        return std::is_sorted(begin, end, [&](const T& v1, const T& v2){ return compare(v1, v2); });
+    }
+
     node_ptr clone_subtree(const_node_ptr src) {
         // note this method gets called from copy-constructor;
         // this means that src may come from another tree
-        if (src->is_nil()) return nil;
+        if (src->is_nil()) return leaf_nil();
         auto ptr = _buy(src->val);
         ptr->parent = nil;
         make_link(ptr, clone_subtree(src->left), true);
@@ -660,6 +864,8 @@ protected:
     }
 
     static void make_link(node_ptr par, node_ptr ch, bool go_left) {
+        // an empty tree is denoted by its `nil` being the root
+        if (par->is_nil() && ch->is_nil()) ch = par;
         if (par->is_nil() || go_left) par->left = ch;
         if (par->is_nil() || !go_left) par->right = ch;
         if (!ch->is_nil()) ch->parent = par;
@@ -667,11 +873,18 @@ protected:
 
     static void make_link(node_ptr par, node_ptr ch, node_ptr old_ch) {
         // knowing what the old child was allows for simpler checks
+        if (par->is_nil() && ch->is_nil()) ch = par;
         if (par->right == old_ch) par->right = ch;
         if (par->left == old_ch) par->left = ch;
         if (!ch->is_nil()) ch->parent = par;
     }
 
+    static void update_children(node_ptr ptr, int cnt) {
+        ptr->size = cnt + ptr->left->size + ptr->right->size;
+        if (!ptr->left->is_nil()) ptr->left->parent = ptr;
+        if (!ptr->right->is_nil()) ptr->right->parent = ptr;
+    }
+
     static void propagate_size(node_ptr ptr, node_ptr end, int cnt) {
         if (cnt == 0) return;
         for (node_ptr tmp = ptr; tmp != end; tmp = tmp->parent) {
@@ -685,12 +898,16 @@ private: // allocation logic
     }
 
     void _init() {
-        nil = alloc.allocate(1); // no construct
-        nil->parent = nil; // self-loop indicates that this is the nil node
-        nil->left = nil;   // always points to the root (which is now nil)
-        nil->right = nil;  // always points to the root (which is now nil)
-        nil->balance = 0;
-        nil->size = 0;
+        nil = _init_nil(alloc.allocate(1)); // no construct
+    }
+
+    static node_ptr _init_nil(node_ptr ptr) {
+        ptr->parent = ptr; // self-loop indicates that this is the nil node
+        ptr->left = ptr;   // always points to the root (which is now nil)
+        ptr->right = ptr;  // always points to the root (which is now nil)
+        ptr->balance = 0;
+        ptr->size = 0;
+        return ptr;
     }
 
     void _destroy() {
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "altruct/algorithm/math/intrinsic.h"
+#include "altruct/structure/container/bit_vector.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Rank/select index over a `bit_vector`.
+ *
+ * The bits are split into blocks of 2048 bits, and each block into four
+ * sub-blocks of 512 bits. For each block a single 64-bit entry interleaves
+ * the number of ones preceding it (relative to the enclosing 2^32 bits) with
+ * the number of ones in its first three sub-blocks (10 bits each).
+ * Rank then takes one entry lookup and at most 7 word popcounts.
+ * Select is guided by sampling the block of every 8192-th one (and zero),
+ * followed by a binary search over the entries, and popcounts within the block.
+ *
+ * Space overhead: about 3.2% for rank, plus up to 0.8% for select samples.
+ * Time complexities:
+ *   build:  `O(n)`
+ *   rank:   `O(1)`
+ *   select: `O(log n)` worst case, `O(1)` for evenly distributed bits
+ *
+ * Important: the index must be rebuilt once the bit-vector gets modified
+ *
+ * param W - word type of the bit-vector
+ */
+template<typename W = uint64_t>
+class bit_vector_rank_select {
+public:
+    typedef bit_vector<W> bit_vector_t;
+    static const int L = bit_vector_t::L;
+    static const int BLOCK = 2048;      // bits per block
+    static const int SUB_BLOCK = 512;   // bits per sub-block
+    static const int SAMPLE = 8192;     // ones (zeros) between select samples
+    static const int UPPER_LOG = 21;    // log2 of blocks per 2^32 bits
+
+    const bit_vector_t* bv;
+    std::vector<uint64_t> upper;        // number of ones preceding each 2^32 bits
+    std::vector<uint64_t> blocks;       // relative rank (hi 32 bits) and sub-block counts (lo 30 bits)
+    std::vector<uint32_t> samples1;     // block containing each `SAMPLE`-th one; plus the last block
+    std::vector<uint32_t> samples0;     // block containing each `SAMPLE`-th zero; plus the last block
+    size_t ones;
+
+    bit_vector_rank_select() : bv(nullptr), ones(0) {}
+
+    bit_vector_rank_select(const bit_vector_t& bv) {
+        build(bv);
+    }
+
+    void build(const bit_vector_t& bv) {
+        this->bv = &bv;
+        size_t n = bv.size(), nb = n / BLOCK + 1;
+        upper.assign((nb >> UPPER_LOG) + 1, 0);
+        blocks.assign(nb, 0);
+        samples1.clear();
+        samples0.clear();
+        size_t r = 0;
+        for (size_t b = 0; b < nb; b++) {
+            if ((b & ((size_t(1) << UPPER_LOG) - 1)) == 0) upper[b >> UPPER_LOG] = r;
+            uint64_t e = uint64_t(r - upper[b >> UPPER_LOG]) << 32;
+            size_t rb = r;
+            for (int j = 0; j < 4; j++) {
+                uint64_t c = sub_block_count1(b * BLOCK + j * SUB_BLOCK);
+                if (j < 3) e |= c << (10 * j);
+                r += c;
+            }
+            blocks[b] = e;
+            size_t z = std::min(n, (b + 1) * BLOCK) - r, zb = b * BLOCK - rb;
+            for (size_t k = (rb + SAMPLE - 1) / SAMPLE * SAMPLE; k < r; k += SAMPLE) samples1.push_back(uint32_t(b));
+            for (size_t k = (zb + SAMPLE - 1) / SAMPLE * SAMPLE; k < z; k += SAMPLE) samples0.push_back(uint32_t(b));
+        }
+        samples1.push_back(uint32_t(nb - 1));
+        samples0.push_back(uint32_t(nb - 1));
+        ones = r;
+    }
+
+    // returns the number of bits in the underlying bit-vector
+    size_t size() const { return bv ? bv->size() : 0; }
+
+    // returns the total number of ones (zeros)
+    size_t count1() const { return ones; }
+    size_t count0() const { return size() - ones; }
+
+    // returns the number of ones (zeros) in `[0, pos)`; `0 <= pos <= size()`
+    size_t rank1(size_t pos) const {
+        size_t b = pos / BLOCK;
+        uint64_t e = blocks[b];
+        size_t r = block_rank1(b);
+        int s = int(pos % BLOCK) / SUB_BLOCK;
+        for (int j = 0; j < s; j++) r += (e >> (10 * j)) & 1023;
+        const W* w = bv->words.data();
+        for (size_t i = (b * BLOCK + s * SUB_BLOCK) / L; i < pos / L; i++) r += popcount(w[i]);
+        if (pos % L) r += popcount(W(w[pos / L] & bit_vector_t::first_bits(pos % L)));
+        return r;
+    }
+    size_t rank0(size_t pos) const {
+        return pos - rank1(pos);
+    }
+
+    // returns the position of the `k`-th (0-based) one (zero); `0 <= k < count1()` (`count0()`)
+    size_t select1(size_t k) const { return select<1>(k); }
+    size_t select0(size_t k) const { return select<0>(k); }
+
+private:
+    // the number of ones (zeros) preceding the block `b`
+    size_t block_rank1(size_t b) const {
+        return size_t(upper[b >> UPPER_LOG] + (blocks[b] >> 32));
+    }
+    template<int B>
+    size_t block_rank(size_t b) const {
+        return B ? block_rank1(b) : b * BLOCK - block_rank1(b);
+    }
+
+    template<int B>
+    size_t select(size_t k) const {
+        const std::vector<uint32_t>& samples = B ? samples1 : samples0;
+        // the last block with the rank not exceeding `k`
+        size_t lo = samples[k / SAMPLE], hi = samples[k / SAMPLE + 1];
+        while (lo < hi) {
+            size_t mid = (lo + hi + 1) / 2;
+            if (block_rank<B>(mid) <= k) lo = mid; else hi = mid - 1;
+        }
+        k -= block_rank<B>(lo);
+        uint64_t e = blocks[lo];
+        size_t pos = lo * BLOCK;
+        for (int j = 0; j < 3; j++) {
+            size_t c = (e >> (10 * j)) & 1023;
+            if (!B) c = SUB_BLOCK - c;
+            if (k < c) break;
+            k -= c, pos += SUB_BLOCK;
+        }
+        const W* w = bv->words.data();
+        for (size_t i = pos / L; ; i++) {
+            W wi = B ? w[i] : W(~w[i]);
+            size_t c = popcount(wi);
+            if (k < c) return i * L + math::select64(uint64_t(wi), int(k));
+            k -= c;
+        }
+    }
+
+    // the number of ones in the sub-block starting at `pos`
+    uint64_t sub_block_count1(size_t pos) const {
+        const std::vector<W>& w = bv->words;
+        size_t ib = std::min(pos / L, w.size()), ie = std::min((pos + SUB_BLOCK) / L, w.size());
+        uint64_t c = 0;
+        for (size_t i = ib; i < ie; i++) c += popcount(w[i]);
+        return c;
+    }
+
+    static int popcount(W w) {
+        return math::popcount64(uint64_t(w));
+    }
+};
+
+} // container
+} // altruct
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "altruct/concurrency/executor.h"
+
+#include <algorithm>
 #include <vector>
 #include <iterator>
 #include <functional>
@@ -17,6 +20,8 @@ namespace container {
  *   build:  `O(n)`
  *   update: `O(log n)`
  *   get:    `O(log n)`
+ *   update_many: `O(k log k + k log(n / k))` for `k` elements
+ *   get_many:    `O(k log n)` for `k` queries
  *
  * param T      - node type
  * param f_up   - associative functor for upward propagation; commutativity is not required.
@@ -49,15 +54,28 @@ public:
 
     T get(size_t begin, size_t end) {
         propagate_down(begin, end);
-        T tl = v[0], tr = v[0]; // id
-        size_t b = begin, e = end, i = size();
-        while (b < e) {
-            if (b & 1) f_up(tl, tl, v[i + b++]);
-            if (e & 1) f_up(tr, v[i + --e], tr);
-            b /= 2, e /= 2, i /= 2;
+        return get_propagated(begin, end);
+    }
+
+    // Performs multiple range queries at once.
+    // `[begin, end)` is a range of `(begin, end)` index pairs.
+    // Pending updates get propagated down exactly once per affected node, level by level.
+    // `exec` runs each level and the queries, see `concurrency::serial_range_executor`.
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    std::vector<T> get_many(It begin, It end, const EXEC& exec = EXEC()) {
+        std::vector<size_t> vi;
+        for (It it = begin; it != end; ++it) {
+            if (it->first >= it->second) continue;
+            vi.push_back(it->first + size());
+            vi.push_back(it->second - 1 + size());
         }
-        f_up(tl, tl, tr);
-        return tl;
+        propagate_down_many(vi, exec);
+        std::vector<T> r(std::distance(begin, end), v[0]);
+        exec(0, (int)r.size(), [&](int k0, int k1) {
+            It it = begin; std::advance(it, k0);
+            for (int k = k0; k < k1; k++, ++it) r[k] = get_propagated(it->first, it->second);
+        });
+        return r;
     }
 
     // if `f` returns false, meaning that the segment cannot be updated as a whole,
@@ -73,6 +91,27 @@ public:
         }
         propagate_up(begin, end);
     }
+
+    // Updates multiple elements at once.
+    // `f(element, value)` gets called for each `(index, value)` pair in `[begin, end)`, in order.
+    // Each affected ancestor gets propagated down and rebuilt exactly once, level by level.
+    // `exec` runs each level, see `concurrency::serial_range_executor`.
+    template<typename It, typename F_UPDATE, typename EXEC = concurrency::serial_range_executor> // void(T& element, const V& value)
+    void update_many(It begin, It end, const F_UPDATE& f, const EXEC& exec = EXEC()) {
+        std::vector<size_t> vi;
+        for (It it = begin; it != end; ++it) {
+            vi.push_back(it->first + size());
+        }
+        auto levels = propagate_down_many(vi, exec);
+        for (It it = begin; it != end; ++it) {
+            f(v[it->first + size()], it->second);
+        }
+        for (const auto& level : levels) {
+            exec(0, (int)level.size(), [&](int j0, int j1) {
+                for (int j = j0; j < j1; j++) update_up(level[j]);
+            });
+        }
+    }
 
     // `rebuild` must be called after all modifications are made.
     T& operator[] (size_t index) {
@@ -111,6 +150,42 @@ public:
     }
 
 private:
+    T get_propagated(size_t begin, size_t end) const {
+        T tl = v[0], tr = v[0]; // id
+        size_t b = begin, e = end, i = v.size() / 2;
+        while (b < e) {
+            if (b & 1) f_up(tl, tl, v[i + b++]);
+            if (e & 1) f_up(tr, v[i + --e], tr);
+            b /= 2, e /= 2, i /= 2;
+        }
+        f_up(tl, tl, tr);
+        return tl;
+    }
+
+    // propagates down to the given leaves; each ancestor exactly once, level by level
+    // returns the distinct ancestors grouped by level, from the bottom level up
+    template<typename EXEC>
+    std::vector<std::vector<size_t>> propagate_down_many(std::vector<size_t>& vi, const EXEC& exec) {
+        std::vector<std::vector<size_t>> levels;
+        std::sort(vi.begin(), vi.end());
+        vi.erase(std::unique(vi.begin(), vi.end()), vi.end());
+        while (!vi.empty() && vi[0] > 1) {
+            levels.emplace_back();
+            auto& level = levels.back();
+            for (size_t i : vi) {
+                if (level.empty() || level.back() != i / 2) level.push_back(i / 2);
+            }
+            vi = level;
+        }
+        for (auto it = levels.rbegin(); it != levels.rend(); ++it) {
+            const auto& level = *it;
+            exec(0, (int)level.size(), [&](int j0, int j1) {
+                for (int j = j0; j < j1; j++) update_down(level[j]);
+            });
+        }
+        return levels;
+    }
+
     template<typename F>
     void update_segment(size_t i, const F& f) {
         // Compilers may not optimize the recursive implementation well enough.
@@ -184,5 +259,17 @@ private:
     }
 };
 
+/**
+ * Creates a lazy segment tree with the functor types deduced, so that they don't get type-erased.
+ */
+template<typename T, typename F_UP, typename F_DOWN>
+lazy_segment_tree<T, F_UP, F_DOWN> make_lazy_segment_tree(size_t sz, const F_UP& f_up, const F_DOWN& f_down, T id = T()) {
+    return lazy_segment_tree<T, F_UP, F_DOWN>(sz, f_up, f_down, id);
+}
+template<typename It, typename F_UP, typename F_DOWN, typename T = typename std::iterator_traits<It>::value_type>
+lazy_segment_tree<T, F_UP, F_DOWN> make_lazy_segment_tree(It begin, It end, const F_UP& f_up, const F_DOWN& f_down, T id = T()) {
+    return lazy_segment_tree<T, F_UP, F_DOWN>(begin, end, f_up, f_down, id);
+}
+
 } // container
 } // altruct
@@ -20,6 +20,7 @@ struct lazy_treap_iterator : public std::iterator<std::bidirectional_iterator_ta
     lazy_treap_iterator(IT it) : it(it) { }
     int count() const { return it.count(); }
     int size() const { return it.size(); }
+    bool is_nil() const { return it.is_nil(); }
     T& operator * () { return *it; }
     T* operator -> () { return &*it; }
     bool operator == (const lazy_treap_iterator& rhs) const { return it == rhs.it; }
@@ -52,6 +53,7 @@ struct lazy_treap_const_iterator : public std::iterator<std::bidirectional_itera
     lazy_treap_const_iterator(lazy_treap_iterator<T, IT> it) : it(it.it) { }
     int count() const { return it.count(); }
     int size() const { return it.size(); }
+    bool is_nil() const { return it.is_nil(); }
     const T& operator * () const { return *it; }
     const T* operator -> () const { return &*it; }
     bool operator == (const lazy_treap_const_iterator& rhs) const { return it == rhs.it; }
@@ -95,7 +97,7 @@ template<
     typename CMP = std::less<T>,
     typename F_UP = std::function<void(T& parent, const T& left, const T& right)>,
     typename F_DOWN = std::function<void(T& parent, T& left, T& right)>,
-    typename RAND = std::function<int()>,
+    typename RAND = bst_random,
     typename ALLOC = std::allocator<bst_node<T>>>
 class lazy_treap {
 protected:
@@ -114,15 +116,19 @@ public:
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    lazy_treap(const F_UP& f_up, const F_DOWN& f_down, const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    lazy_treap(const F_UP& f_up, const F_DOWN& f_down, const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         tree(cmp, alloc), rnd(rnd), f_up(f_up), f_down(f_down) {
     }
 
     template<typename It>
-    lazy_treap(It begin, It end, const F_UP& f_up, const F_DOWN& f_down, const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    lazy_treap(It begin, It end, const F_UP& f_up, const F_DOWN& f_down, const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         lazy_treap(f_up, f_down, cmp, rnd, alloc) {
-        for (It it = begin; it != end; ++it) {
-            insert(*it);
+        if (tree.is_sorted(begin, end)) {
+            assign_sorted(begin, end);
+        } else {
+            for (It it = begin; it != end; ++it) {
+                insert(*it);
+            }
         }
     }
 
@@ -221,7 +227,7 @@ public: // query & update
 
     iterator find(const key_type& key) {
         iterator res = end();
-        for (iterator it = root(); it != end();) {
+        for (iterator it = root(); !it.is_nil();) {
             propagate_down(it);
             if (tree.compare(*it, key)) {
                 it = it.right();
@@ -237,7 +243,7 @@ public: // query & update
 
     iterator lower_bound(const key_type& key) {
         iterator res = end();
-        for (iterator it = root(); it != end();) {
+        for (iterator it = root(); !it.is_nil();) {
             propagate_down(it);
             if (tree.compare(*it, key)) {
                 it = it.right();
@@ -251,7 +257,7 @@ public: // query & update
 
     iterator upper_bound(const key_type& key) {
         iterator res = end();
-        for (iterator it = root(); it != end();) {
+        for (iterator it = root(); !it.is_nil();) {
             propagate_down(it);
             if (tree.compare(key, *it)) {
                 res = it;
@@ -324,8 +330,26 @@ public: // query & update
         f(*a), f_down(*a, dummy, dummy); // update a
     }
 
+    // Replaces the content with the elements of the sorted range in `O(n)`.
+    // important: this call is unchecked and the sort order may be violated
+    template<typename It>
+    void assign_sorted(It begin, It end) {
+        tree.assign_sorted(begin, end, [this](){ return rnd(); }, [this](typename bst_t::iterator it){ update_node(it); });
+    }
+
+    // Moves the elements not less than `key` to `rhs`.
+    void split(const key_type& key, lazy_treap& rhs) {
+        tree.split(key, rhs.tree, [this](typename bst_t::iterator it){ propagate_down(it); }, [this](typename bst_t::iterator it){ update_node(it); });
+    }
+
+    // Moves all the elements of `rhs` after the elements of this treap.
+    // important: this call is unchecked and the sort order may be violated
+    void merge(lazy_treap& rhs) {
+        tree.join(rhs.tree, [this](typename bst_t::iterator it){ propagate_down(it); }, [this](typename bst_t::iterator it){ update_node(it); });
+    }
+
     void propagate_down_to(const_iterator it) {
-        if (it == end()) return;
+        if (it.is_nil()) return;
         propagate_down_to(it.parent());
         propagate_down(it);
     }
@@ -359,23 +383,25 @@ protected: // lowest_common_ancestor
 protected: // balancing
     iterator retrace_up(const_iterator _it) {
         auto it = remove_const(_it).it;
-        if (it == tree.end()) return it;
+        if (it.is_nil()) return it;
         it.balance() = rnd();
         while (it.balance() < it.parent().balance()) {
-            if (it.parent().left() == it) {
-                tree.rotate_right(it.parent());
+            auto par = it.parent();
+            if (par.left() == it) {
+                tree.rotate_right(par);
             } else {
-                tree.rotate_left(it.parent());
+                tree.rotate_left(par);
             }
+            update_node(par); // now a child of `it`
         }
         return it;
     }
 
     iterator retrace_down(const_iterator _it) {
         auto it = remove_const(_it).it;
-        if (it == tree.end()) return it;
+        if (it.is_nil()) return it;
         propagate_down(it);
-        while (it.left() != tree.end() && it.right() != tree.end()) {
+        while (!it.left().is_nil() && !it.right().is_nil()) {
             if (it.left().balance() < it.right().balance()) {
                 propagate_down(it.left());
                 tree.rotate_right(it);
@@ -390,28 +416,42 @@ protected: // balancing
 public: // aggregation
     iterator propagate_up(const_iterator _it) {
         auto it = remove_const(_it);
-        for (auto it2 = it; it2 != tree.end(); it2 = it2.parent()) {
-            f_up(*it2, _val_or_id(it2.left()), _val_or_id(it2.right()));
+        for (auto it2 = it; !it2.is_nil(); it2 = it2.parent()) {
+            update_node(it2);
         }
         return it;
     }
 
+    iterator update_node(const_iterator _it) {
+        auto it = remove_const(_it);
+        f_up(*it, _val_or_id(it.left()), _val_or_id(it.right()));
+        return it;
+    }
+
     iterator propagate_down(const_iterator _it) {
         auto it = remove_const(_it);
-        if (it == tree.end()) return it;
+        if (it.is_nil()) return it;
         f_down(*it, _val_or_dummy(it.left()), _val_or_dummy(it.right()));
         return it;
     }
 
 private:
     const T& _val_or_id(iterator it) {
-        return (it != tree.end()) ? *it : id;
+        return !it.is_nil() ? *it : id;
     }
     
     T& _val_or_dummy(iterator it) {
-        return (it != tree.end()) ? *it : dummy;
+        return !it.is_nil() ? *it : dummy;
     }
 };
 
+/**
+ * Creates a lazy treap with the functor types deduced, so that they don't get type-erased.
+ */
+template<typename T, typename CMP = std::less<T>, typename F_UP, typename F_DOWN>
+lazy_treap<T, CMP, F_UP, F_DOWN> make_lazy_treap(const F_UP& f_up, const F_DOWN& f_down, const CMP& cmp = CMP()) {
+    return lazy_treap<T, CMP, F_UP, F_DOWN>(f_up, f_down, cmp);
+}
+
 } // container
 } // altruct
@@ -88,6 +88,12 @@ public: // constructor / destructor
         for (auto it = begin; it != end; ++it) make_tree(*it);
     }
 
+    link_cut_tree(link_cut_tree&& rhs)
+        : f_up(std::move(rhs.f_up)), alloc(rhs.alloc), nil(rhs.nil), nodes(std::move(rhs.nodes)) {
+        rhs.nodes.clear();
+        rhs.nil = nullptr;
+    }
+
 public: // index based methods
     // Returns the number of nodes.
     // Node indices are 1-based, 0 corresponds to nil.
@@ -292,5 +298,13 @@ private:
     }
 };
 
+/**
+ * Creates a link-cut tree with the functor type deduced, so that it doesn't get type-erased.
+ */
+template<typename T, typename F_UP>
+link_cut_tree<T, F_UP> make_link_cut_tree(size_t sz, const F_UP& f_up, T id = T()) {
+    return link_cut_tree<T, F_UP>(sz, f_up, id);
+}
+
 } // container
 } // altruct
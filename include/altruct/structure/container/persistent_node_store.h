@@ -0,0 +1,68 @@
+#pragma once
+
+#include <utility>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Node store for the persistent (path-copying) containers.
+ *
+ * Nodes are reference counted and shared among the versions of a container.
+ * A node gets copied on write only if it is shared; nodes referenced by just
+ * a single version get modified in place. A node gets deallocated once the
+ * last reference to it is released.
+ *
+ * `NODE` needs to be copy constructible and to have `left`, `right` and `refs` fields.
+ * Important: reference counting is not thread-safe
+ *
+ * param NODE - node type
+ * param ALLOC - allocator type
+ */
+template<typename NODE, typename ALLOC>
+struct persistent_node_store {
+    typedef NODE* node_ptr;
+    ALLOC alloc;
+
+    persistent_node_store(const ALLOC& alloc = ALLOC()) : alloc(alloc) {}
+
+    // creates a new node with the reference count of 1
+    template<typename... Args>
+    node_ptr create(Args&&... args) {
+        node_ptr ptr = alloc.allocate(1);
+        alloc.construct(ptr, std::forward<Args>(args)...);
+        ptr->refs = 1;
+        return ptr;
+    }
+
+    // creates a copy of the given node that shares its children
+    node_ptr copy(node_ptr src) {
+        node_ptr ptr = create(*src);
+        retain(ptr->left);
+        retain(ptr->right);
+        return ptr;
+    }
+
+    // takes over the given reference and returns a node that can be modified
+    node_ptr mut(node_ptr ptr) {
+        if (ptr->refs == 1) return ptr;
+        ptr->refs--;
+        return copy(ptr);
+    }
+
+    static node_ptr retain(node_ptr ptr) {
+        if (ptr) ptr->refs++;
+        return ptr;
+    }
+
+    void release(node_ptr ptr) {
+        if (!ptr || --ptr->refs > 0) return;
+        release(ptr->left);
+        release(ptr->right);
+        alloc.destroy(ptr);
+        alloc.deallocate(ptr, 1);
+    }
+};
+
+} // container
+} // altruct
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "altruct/structure/container/arena_allocator.h"
+#include "altruct/structure/container/persistent_node_store.h"
+
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Persistent segment tree node structure.
+ */
+template<typename T>
+struct persistent_segment_tree_node {
+    persistent_segment_tree_node* left;
+    persistent_segment_tree_node* right;
+    int refs; // number of references to this node
+    T val;
+
+    persistent_segment_tree_node(const T& val) : left(nullptr), right(nullptr), refs(0), val(val) {}
+};
+
+/**
+ * Persistent segment tree that supports range queries.
+ *
+ * Each instance is a version of the tree. Copying a version takes `O(1)`
+ * as the nodes are shared. Modifying a version does not affect the other
+ * versions: only the nodes on the path to the modified element get copied,
+ * and only if they are shared with another version.
+ * A node gets deallocated once the last version referencing it is gone.
+ * By default, nodes come from an `arena_allocator`, shared by all the versions
+ * that are copies of the same tree, making their reclamation cheap.
+ * The identity subtrees are shared as well, so a tree of `n` identity elements
+ * takes just `O(log n)` nodes.
+ *
+ * Space complexity: `O(n)` per tree, plus `O(log n)` per update.
+ * Time complexities:
+ *   copy:  `O(1)`
+ *   build: `O(n)`
+ *   set:   `O(log n)`
+ *   get:   `O(log n)`
+ *
+ * Important: versions that share nodes must not be used concurrently
+ *
+ * param T  - element type
+ * param f  - associative functor; i.e. `f(f(a, b), c) = f(a, f(b, c))`
+ *            commutativity is not required.
+ * param id - neutral element with respect to `f`; i.e. `f(e, id) = f(id, e) = e`.
+ * param ALLOC - allocator type
+ */
+template<typename T, typename F = std::function<T(T, T)>, typename ALLOC = arena_allocator<persistent_segment_tree_node<T>>>
+class persistent_segment_tree {
+protected:
+    typedef persistent_segment_tree_node<T> node_t;
+    typedef node_t* node_ptr;
+    typedef const node_t* const_node_ptr;
+    persistent_node_store<node_t, ALLOC> store;
+    node_ptr root;
+    size_t sz; // number of leaves, a power of two
+
+public:
+    F f;
+    T id;
+
+    ~persistent_segment_tree() {
+        store.release(root);
+    }
+
+    persistent_segment_tree(size_t sz, const F& f, T id = T(), const ALLOC& alloc = ALLOC()) :
+        store(alloc), root(nullptr), sz(calc_pow2(sz)), f(f), id(id) {
+        root = build_id(this->sz);
+    }
+
+    template<typename It>
+    persistent_segment_tree(It begin, It end, const F& f, T id = T(), const ALLOC& alloc = ALLOC()) :
+        store(alloc), root(nullptr), sz(calc_pow2(std::distance(begin, end))), f(f), id(id) {
+        std::vector<node_ptr> vid{ build_id(1) };
+        for (size_t w = 1; w < sz; w *= 2) vid.push_back(create(store.retain(vid.back()), store.retain(vid.back())));
+        root = build(begin, end, sz, vid);
+        for (node_ptr ptr : vid) store.release(ptr);
+    }
+
+    persistent_segment_tree(persistent_segment_tree&& rhs) :
+        store(rhs.store), root(nullptr), sz(rhs.sz), f(rhs.f), id(rhs.id) {
+        std::swap(root, rhs.root);
+    }
+
+    persistent_segment_tree(const persistent_segment_tree& rhs) :
+        store(rhs.store), root(store.retain(rhs.root)), sz(rhs.sz), f(rhs.f), id(rhs.id) {
+    }
+
+    persistent_segment_tree& operator=(persistent_segment_tree&& rhs) {
+        swap(rhs);
+        return *this;
+    }
+
+    persistent_segment_tree& operator=(const persistent_segment_tree& rhs) {
+        persistent_segment_tree rhs_copy(rhs);
+        swap(rhs_copy);
+        return *this;
+    }
+
+    void swap(persistent_segment_tree& rhs) {
+        std::swap(store, rhs.store);
+        std::swap(root, rhs.root);
+        std::swap(sz, rhs.sz);
+        std::swap(f, rhs.f);
+        std::swap(id, rhs.id);
+    }
+
+    size_t size() const {
+        return sz;
+    }
+
+    void set(size_t index, const T& t) {
+        // copy the path on the way down, and update it on the way back up
+        std::vector<node_ptr> path;
+        node_ptr* pptr = &root;
+        for (size_t w = sz; ; w /= 2) {
+            *pptr = store.mut(*pptr);
+            path.push_back(*pptr);
+            if (w == 1) break;
+            if (index & (w / 2)) {
+                pptr = &(*pptr)->right;
+            } else {
+                pptr = &(*pptr)->left;
+            }
+        }
+        path.back()->val = t;
+        path.pop_back();
+        while (!path.empty()) {
+            update(path.back());
+            path.pop_back();
+        }
+    }
+
+    const T& operator[] (size_t index) const {
+        const_node_ptr ptr = root;
+        for (size_t w = sz; w > 1; w /= 2) {
+            ptr = (index & (w / 2)) ? ptr->right : ptr->left;
+        }
+        return ptr->val;
+    }
+
+    T get(size_t index) const {
+        return (*this)[index];
+    }
+
+    T get(size_t begin, size_t end) const {
+        if (begin >= end) return id;
+        return get(root, 0, sz, begin, end);
+    }
+
+private:
+    // `[lo, lo + w)` is the range of the subtree rooted at `ptr`
+    T get(const_node_ptr ptr, size_t lo, size_t w, size_t begin, size_t end) const {
+        if (begin <= lo && lo + w <= end) return ptr->val;
+        size_t mid = lo + w / 2;
+        if (end <= mid) return get(ptr->left, lo, w / 2, begin, end);
+        if (mid <= begin) return get(ptr->right, mid, w / 2, begin, end);
+        return f(get(ptr->left, lo, w / 2, begin, end), get(ptr->right, mid, w / 2, begin, end));
+    }
+
+    node_ptr create(node_ptr left, node_ptr right) {
+        node_ptr ptr = store.create(id);
+        ptr->left = left, ptr->right = right;
+        update(ptr);
+        return ptr;
+    }
+
+    // builds a subtree of `w` identity elements, with a single node per level
+    node_ptr build_id(size_t w) {
+        if (w == 1) return store.create(id);
+        node_ptr ch = build_id(w / 2);
+        return create(ch, store.retain(ch));
+    }
+
+    // builds a subtree of `w` elements, with the missing ones taken from the identity subtrees `vid`
+    template<typename It>
+    node_ptr build(It& begin, It end, size_t w, const std::vector<node_ptr>& vid) {
+        if (begin == end) return store.retain(vid[log2(w)]);
+        if (w == 1) return store.create(*begin++);
+        node_ptr l = build(begin, end, w / 2, vid);
+        node_ptr r = build(begin, end, w / 2, vid);
+        return create(l, r);
+    }
+
+    void update(node_ptr ptr) {
+        ptr->val = f(ptr->left->val, ptr->right->val);
+    }
+
+    static size_t log2(size_t w) {
+        size_t l = 0; while (w > 1) w /= 2, l++;
+        return l;
+    }
+
+    static size_t calc_pow2(size_t sz) {
+        size_t w = 1; while (w < sz) w *= 2;
+        return w;
+    }
+};
+
+/**
+ * Creates a persistent segment tree with the functor type deduced, so that it doesn't get type-erased.
+ */
+template<typename T, typename F>
+persistent_segment_tree<T, F> make_persistent_segment_tree(size_t sz, const F& f, T id = T()) {
+    return persistent_segment_tree<T, F>(sz, f, id);
+}
+template<typename It, typename F, typename T = typename std::iterator_traits<It>::value_type>
+persistent_segment_tree<T, F> make_persistent_segment_tree(It begin, It end, const F& f, T id = T()) {
+    return persistent_segment_tree<T, F>(begin, end, f, id);
+}
+
+} // container
+} // altruct
@@ -0,0 +1,420 @@
+#pragma once
+
+#include "altruct/structure/container/arena_allocator.h"
+#include "altruct/structure/container/binary_search_tree.h"
+#include "altruct/structure/container/persistent_node_store.h"
+
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Persistent treap node structure.
+ *
+ * Unlike `bst_node`, there is no parent link, as a node may be shared
+ * among several versions of the tree. Empty subtrees are null pointers.
+ */
+template<typename T>
+struct persistent_treap_node {
+    persistent_treap_node* left;
+    persistent_treap_node* right;
+    int balance; // random priority
+    int size;    // size of a subtree rooted at this node
+    int refs;    // number of references to this node
+    T val;
+
+    persistent_treap_node(const T& val) : left(nullptr), right(nullptr), balance(0), size(0), refs(0), val(val) {}
+};
+
+/**
+ * Forward const iterator.
+ *
+ * As there are no parent links, the iterator keeps the stack of the
+ * ancestors that are yet to be visited, which takes `O(h)` space.
+ */
+template<typename T>
+struct persistent_treap_const_iterator : public std::iterator<std::forward_iterator_tag, const T> {
+    typedef const persistent_treap_node<T>* const_node_ptr;
+    std::vector<const_node_ptr> stk;
+    persistent_treap_const_iterator() { }
+
+    const T& operator * () const { return stk.back()->val; }
+    const T* operator -> () const { return &stk.back()->val; }
+    bool operator == (const persistent_treap_const_iterator& rhs) const { return stk.empty() ? rhs.stk.empty() : !rhs.stk.empty() && stk.back() == rhs.stk.back(); }
+    bool operator != (const persistent_treap_const_iterator& rhs) const { return !(*this == rhs); }
+    persistent_treap_const_iterator& operator++() { const_node_ptr ptr = stk.back(); stk.pop_back(); push_left(ptr->right); return *this; }
+    persistent_treap_const_iterator operator++(int) { auto old = *this; ++*this; return old; }
+    int count() const { const_node_ptr ptr = stk.back(); return ptr->size - size(ptr->left) - size(ptr->right); }
+
+    void push_left(const_node_ptr ptr) { for (; ptr; ptr = ptr->left) stk.push_back(ptr); }
+    static int size(const_node_ptr ptr) { return ptr ? ptr->size : 0; }
+};
+
+/**
+ * Persistent treap.
+ *
+ * Each instance is a version of the tree. Copying a version takes `O(1)`
+ * as the nodes are shared. Modifying a version does not affect the other
+ * versions: only the nodes on the modified paths get copied, and only if
+ * they are shared with another version, which is `O(log n)` memory per update.
+ * A node gets deallocated once the last version referencing it is gone.
+ * By default, nodes come from an `arena_allocator`, shared by all the versions
+ * that are copies of the same tree, making their reclamation cheap.
+ *
+ * Space complexity: `O(n)` per tree, plus `O(log n)` per update.
+ * Time complexities:
+ *   copy:   `O(1)`
+ *   find:   `O(h)`
+ *   insert: `O(h)`
+ *   erase:  `O(h)`
+ *   build from a sorted range: `O(n)`
+ * Where `h` is height that is proportional to `log(n)` with
+ * very high probability.
+ *
+ * Important: versions that share nodes must not be used concurrently
+ *
+ * param K   - key type
+ * param T   - value type (for maps this is going to be std::pair<const K, V>)
+ * param DUP - duplicate handling mode
+ * param CMP - comparison functor type
+ * param RAND - random generator type
+ * param ALLOC - allocator type
+ */
+template<typename K, typename T = K, int DUP = bst_duplicate_handling::IGNORE, typename CMP = std::less<K>, typename RAND = bst_random, typename ALLOC = arena_allocator<persistent_treap_node<T>>>
+class persistent_treap {
+protected:
+    typedef persistent_treap_node<T> node_t;
+    typedef node_t* node_ptr;
+    typedef const node_t* const_node_ptr;
+    persistent_node_store<node_t, ALLOC> store;
+    CMP cmp;
+    RAND rnd;
+    node_ptr root;
+
+public:
+    typedef K key_type;
+    typedef T value_type;
+    typedef persistent_treap_const_iterator<T> const_iterator;
+    typedef const_iterator iterator;
+
+    ~persistent_treap() {
+        store.release(root);
+    }
+
+    persistent_treap(const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
+        store(alloc), cmp(cmp), rnd(rnd), root(nullptr) {
+    }
+
+    template<typename It>
+    persistent_treap(It begin, It end, const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
+        persistent_treap(cmp, rnd, alloc) {
+        if (_is_sorted(begin, end, typename std::iterator_traits<It>::iterator_category())) {
+            assign_sorted(begin, end);
+        } else {
+            for (It it = begin; it != end; ++it) {
+                insert(*it);
+            }
+        }
+    }
+
+    persistent_treap(std::initializer_list<T> list) :
+        persistent_treap(list.begin(), list.end()) {
+    }
+
+    persistent_treap(persistent_treap&& rhs) :
+        persistent_treap(rhs.cmp, rhs.rnd, rhs.store.alloc) {
+        swap(rhs);
+    }
+
+    persistent_treap(const persistent_treap& rhs) :
+        store(rhs.store), cmp(rhs.cmp), rnd(rhs.rnd), root(store.retain(rhs.root)) {
+    }
+
+    persistent_treap& operator=(persistent_treap&& rhs) {
+        swap(rhs);
+        return *this;
+    }
+
+    persistent_treap& operator=(const persistent_treap& rhs) {
+        persistent_treap rhs_copy(rhs);
+        swap(rhs_copy);
+        return *this;
+    }
+
+    void swap(persistent_treap& rhs) {
+        std::swap(store, rhs.store);
+        std::swap(cmp, rhs.cmp);
+        std::swap(rnd, rhs.rnd);
+        std::swap(root, rhs.root);
+    }
+
+    void clear() {
+        store.release(root);
+        root = nullptr;
+    }
+
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    int size() const {
+        return _size(root);
+    }
+
+public: // iterators
+    const_iterator begin() const { const_iterator it; it.push_left(root); return it; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cend() const { return end(); }
+
+public: // relational operators
+    bool operator == (const persistent_treap& rhs) const {
+        if (root == rhs.root) return true;
+        auto b1 = cbegin(), e1 = cend(), b2 = rhs.cbegin(), e2 = rhs.cend();
+        for (; b1 != e1 && b2 != e2; ++b1, ++b2) {
+            if (cmp(_key(*b1), _key(*b2)) || cmp(_key(*b2), _key(*b1))) return false;
+            if (b1.count() != b2.count()) return false;
+        }
+        return b1 == e1 && b2 == e2;
+    }
+    bool operator != (const persistent_treap& rhs) const { return !(*this == rhs); }
+
+public: // query
+    int count_less_or_equal(const K& key) const {
+        int k = 0;
+        for (const_node_ptr ptr = root; ptr;) {
+            if (cmp(key, _key(ptr->val))) {
+                ptr = ptr->left;
+            } else {
+                k += ptr->size - _size(ptr->right);
+                ptr = ptr->right;
+            }
+        }
+        return k;
+    }
+
+    int count_less(const K& key) const {
+        int k = 0;
+        for (const_node_ptr ptr = root; ptr;) {
+            if (cmp(_key(ptr->val), key)) {
+                k += ptr->size - _size(ptr->right);
+                ptr = ptr->right;
+            } else {
+                ptr = ptr->left;
+            }
+        }
+        return k;
+    }
+
+    int count(const K& key) const {
+        return count_less_or_equal(key) - count_less(key);
+    }
+
+    const_iterator find_kth(int k) const {
+        const_iterator it;
+        for (const_node_ptr ptr = root; ptr;) {
+            if (k < _size(ptr->left)) {
+                it.stk.push_back(ptr);
+                ptr = ptr->left;
+            } else if ((k -= ptr->size - _size(ptr->right)) >= 0) {
+                ptr = ptr->right;
+            } else {
+                it.stk.push_back(ptr);
+                return it;
+            }
+        }
+        return end();
+    }
+
+    const_iterator find(const K& key) const {
+        const_iterator it = lower_bound(key);
+        return (it == end() || cmp(key, _key(*it))) ? end() : it;
+    }
+
+    const_iterator lower_bound(const K& key) const {
+        const_iterator it;
+        for (const_node_ptr ptr = root; ptr;) {
+            if (cmp(_key(ptr->val), key)) {
+                ptr = ptr->right;
+            } else {
+                it.stk.push_back(ptr);
+                ptr = ptr->left;
+            }
+        }
+        return it;
+    }
+
+    const_iterator upper_bound(const K& key) const {
+        const_iterator it;
+        for (const_node_ptr ptr = root; ptr;) {
+            if (cmp(key, _key(ptr->val))) {
+                it.stk.push_back(ptr);
+                ptr = ptr->left;
+            } else {
+                ptr = ptr->right;
+            }
+        }
+        return it;
+    }
+
+public: // update
+    void insert(const T& val, int cnt = 1) {
+        if (DUP != bst_duplicate_handling::COUNT) {
+            cnt = 1;
+        }
+        if (DUP != bst_duplicate_handling::STORE && find(_key(val)) != end()) {
+            if (DUP == bst_duplicate_handling::COUNT) {
+                root = _add_count(root, _key(val), cnt);
+            }
+            return;
+        }
+        node_ptr ptr = store.create(val);
+        ptr->balance = rnd();
+        root = _insert(root, ptr, cnt);
+    }
+
+    void erase(const K& key, int cnt = std::numeric_limits<int>::max()) {
+        auto it = find(key);
+        if (it == end()) return;
+        if (DUP == bst_duplicate_handling::COUNT && cnt < it.count()) {
+            root = _add_count(root, key, -cnt);
+            return;
+        }
+        node_ptr l, m, r;
+        _split(root, key, false, l, r);
+        _split(r, key, true, m, r);
+        store.release(m);
+        root = _merge(l, r);
+    }
+
+    // Replaces the content with the elements of the sorted range in `O(n)`.
+    // important: this call is unchecked and the sort order may be violated
+    template<typename It>
+    void assign_sorted(It begin, It end) {
+        clear();
+        std::vector<node_ptr> spine; // the right spine of the tree built so far
+        auto finish = [&](node_ptr ptr) {
+            ptr->size += _size(ptr->left) + _size(ptr->right);
+        };
+        for (It it = begin; it != end; ++it) {
+            const T& val = *it;
+            if (DUP != bst_duplicate_handling::STORE && !spine.empty() && !cmp(_key(spine.back()->val), _key(val))) {
+                if (DUP == bst_duplicate_handling::COUNT) spine.back()->size++;
+                continue;
+            }
+            node_ptr ptr = store.create(val);
+            ptr->balance = rnd();
+            ptr->size = 1;
+            while (!spine.empty() && spine.back()->balance > ptr->balance) {
+                ptr->left = spine.back(); spine.pop_back();
+                finish(ptr->left);
+            }
+            if (!spine.empty()) spine.back()->right = ptr;
+            spine.push_back(ptr);
+        }
+        if (spine.empty()) return;
+        root = spine.front();
+        while (!spine.empty()) {
+            finish(spine.back()); spine.pop_back();
+        }
+    }
+
+protected:
+    static const K& _key(const T& val) {
+        return bst_key<K, T>::of(val);
+    }
+
+    static int _size(const_node_ptr ptr) {
+        return ptr ? ptr->size : 0;
+    }
+
+    static int _count(const_node_ptr ptr) {
+        return ptr->size - _size(ptr->left) - _size(ptr->right);
+    }
+
+    static void _update(node_ptr ptr, int cnt) {
+        ptr->size = cnt + _size(ptr->left) + _size(ptr->right);
+    }
+
+    // the following methods take over the references passed in,
+    // and return the references to the resulting subtrees
+
+    node_ptr _insert(node_ptr ptr, node_ptr ins, int cnt) {
+        if (!ptr || ins->balance < ptr->balance) {
+            // equal keys stay to the left of the new node (insertion order)
+            _split(ptr, _key(ins->val), true, ins->left, ins->right);
+            _update(ins, cnt);
+            return ins;
+        }
+        ptr = store.mut(ptr);
+        int c = _count(ptr);
+        if (cmp(_key(ins->val), _key(ptr->val))) {
+            ptr->left = _insert(ptr->left, ins, cnt);
+        } else {
+            ptr->right = _insert(ptr->right, ins, cnt);
+        }
+        _update(ptr, c);
+        return ptr;
+    }
+
+    node_ptr _add_count(node_ptr ptr, const K& key, int cnt) {
+        ptr = store.mut(ptr);
+        ptr->size += cnt;
+        if (cmp(key, _key(ptr->val))) {
+            ptr->left = _add_count(ptr->left, key, cnt);
+        } else if (cmp(_key(ptr->val), key)) {
+            ptr->right = _add_count(ptr->right, key, cnt);
+        }
+        return ptr;
+    }
+
+    // keys less than `key` go to `l`, as well as the keys equal to `key` if `equal_to_left`
+    void _split(node_ptr ptr, const K& key, bool equal_to_left, node_ptr& l, node_ptr& r) {
+        if (!ptr) { l = r = nullptr; return; }
+        ptr = store.mut(ptr);
+        int c = _count(ptr);
+        if (equal_to_left ? !cmp(key, _key(ptr->val)) : cmp(_key(ptr->val), key)) {
+            _split(ptr->right, key, equal_to_left, ptr->right, r);
+            l = ptr;
+        } else {
+            _split(ptr->left, key, equal_to_left, l, ptr->left);
+            r = ptr;
+        }
+        _update(ptr, c);
+    }
+
+    node_ptr _merge(node_ptr l, node_ptr r) {
+        if (!l) return r;
+        if (!r) return l;
+        if (l->balance <= r->balance) {
+            l = store.mut(l);
+            int c = _count(l);
+            l->right = _merge(l->right, r);
+            _update(l, c);
+            return l;
+        } else {
+            r = store.mut(r);
+            int c = _count(r);
+            r->left = _merge(l, r->left);
+            _update(r, c);
+            return r;
+        }
+    }
+
+    template<typename It>
+    bool _is_sorted(It begin, It end, std::input_iterator_tag) const {
+        return false;
+    }
+
+    template<typename It>
+    bool _is_sorted(It begin, It end, std::forward_iterator_tag) const {
+        return std::is_sorted(begin, end, [&](const T& v1, const T& v2){ return cmp(_key(v1), _key(v2)); });
+    }
+};
+
+} // container
+} // altruct
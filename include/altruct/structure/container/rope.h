@@ -85,12 +85,15 @@ struct rope_const_iterator : public std::iterator<std::random_access_iterator_ta
  *   push_back is O(log n)
  *   insert    is O(log n)
  *   erase     is O(log n)
+ *   split     is O(log n)
+ *   merge     is O(log n)
+ * Construction from a range takes `O(n)`.
  *
  * param T   - value type
  * param RAND - random generator type
  * param ALLOC - allocator type
  */
-template<typename T, typename RAND = std::function<int()>, typename ALLOC = std::allocator<bst_node<T>>>
+template<typename T, typename RAND = bst_random, typename ALLOC = std::allocator<bst_node<T>>>
 class rope {
 protected:
     // comparator_t treats all the elements as equal so that the underlying tree doesn't reorder them
@@ -105,16 +108,14 @@ public:
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    rope(const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    rope(const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         tree(comparator_t(), rnd, alloc) {
     }
 
     template<typename It>
-    rope(It begin, It end, const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    rope(It begin, It end, const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         rope(rnd, alloc) {
-        for (It it = begin; it != end; ++it) {
-            push_back(*it);
-        }
+        tree.assign_sorted(begin, end);
     }
 
     rope(std::initializer_list<T> list) :
@@ -214,6 +215,16 @@ public: // query & update
         tree.erase(it.it, 1);
     }
 
+    // moves the elements at positions `pos` and above to `rhs`
+    void split(int pos, rope& rhs) {
+        tree.split_kth(pos, rhs.tree);
+    }
+
+    // moves all the elements of `rhs` to the end of this rope
+    void merge(rope& rhs) {
+        tree.merge(rhs.tree);
+    }
+
     const T& at(int pos) const {
         return *find_kth(pos);
     }
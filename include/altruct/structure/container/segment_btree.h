@@ -0,0 +1,156 @@
+#pragma once
+
+#include "altruct/structure/container/segment_tree.h"
+
+#include <vector>
+#include <iterator>
+#include <functional>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Segment B-tree that supports range queries.
+ *
+ * A drop-in alternative to `segment_tree` with a blocked `B`-ary layout.
+ * Each node stores the values of its `B` children contiguously, and the
+ * levels are stored bottom-up one after another. With `B * sizeof(T)` within
+ * a cache line, each level of a query touches only a few cache lines and
+ * there are only `log_B(n)` levels. The folds over contiguous blocks are
+ * also amenable to vectorization when `f` gets inlined (e.g. a functor
+ * such as `segment_tree_sum<T>` or `segment_tree_min<T>`).
+ *
+ * Space complexity: `O(n)`.
+ * Time complexities:
+ *   build: `O(n)`
+ *   set: `O(B log_B n)`
+ *   get: `O(B log_B n)`
+ *
+ * param T  - element type
+ * param f  - associative functor; i.e. `f(f(a, b), c) = f(a, f(b, c))`
+ *            commutativity is not required.
+ * param id - neutral element with respect to `f`; i.e. `f(e, id) = f(id, e) = e`.
+ *            e.g. `0` for addition, `1` for multiplication, `+inf` for minimum, etc.
+ * param B  - branching factor
+ */
+template<typename T, typename F = std::function<T(T, T)>, int B = 8>
+class segment_btree {
+public:
+    std::vector<T> v;        // all the levels, bottom-up; level `0` are the elements
+    std::vector<size_t> lvl; // `lvl[h]` is the offset of the level `h` in `v`
+    F f;
+    T id;
+
+    segment_btree() {}
+
+    segment_btree(size_t sz, const F& f, T id = T()) : f(f), id(id) {
+        init(sz);
+    }
+
+    template<typename It>
+    segment_btree(It begin, It end, const F& f, T id = T()) : f(f), id(id) {
+        init(std::distance(begin, end));
+        std::copy(begin, end, v.begin());
+        rebuild();
+    }
+
+    void set(size_t index, const T& t) {
+        v[index] = t;
+        rebuild(index);
+    }
+
+    // If the returned element is being modified,
+    // the index won't be updated automatically.
+    // Use `set` instead to update immediately,
+    // or `rebuild` after all modifications.
+    T& operator[] (size_t index) {
+        return v[index];
+    }
+
+    const T& operator[] (size_t index) const {
+        return v[index];
+    }
+
+    T get(size_t index) const {
+        return v[index];
+    }
+
+    T get(size_t begin, size_t end) const {
+        T tl = id, tr = id;
+        for (size_t h = 0; begin < end; h++) {
+            const T* p = v.data() + lvl[h];
+            size_t b = round_up(begin), e = end / B * B;
+            if (b > e || h + 2 == lvl.size()) {
+                tl = fold(tl, p + begin, p + end);
+                break;
+            }
+            tl = fold(tl, p + begin, p + b);
+            tr = f(fold(id, p + e, p + end), tr);
+            begin = b / B, end = e / B;
+        }
+        return f(tl, tr);
+    }
+
+    size_t size() const {
+        return lvl[1];
+    }
+
+    void rebuild() {
+        for (size_t h = 0; h + 2 < lvl.size(); h++) {
+            update(h, 0, (lvl[h + 1] - lvl[h]) / B);
+        }
+    }
+
+    void rebuild(size_t index) {
+        for (size_t h = 0; h + 2 < lvl.size(); h++) {
+            index /= B;
+            update(h, index, index + 1);
+        }
+    }
+
+    void rebuild(size_t begin, size_t end) {
+        if (begin >= end) return;
+        size_t b = begin, e = end - 1;
+        for (size_t h = 0; h + 2 < lvl.size(); h++) {
+            b /= B, e /= B;
+            update(h, b, e + 1);
+        }
+    }
+
+private:
+    // folds `[begin, end)` into `t` from left to right
+    T fold(T t, const T* begin, const T* end) const {
+        for (const T* p = begin; p != end; ++p) {
+            t = f(t, *p);
+        }
+        return t;
+    }
+
+    // updates the nodes `[begin, end)` of the level `h + 1` from their children
+    void update(size_t h, size_t begin, size_t end) {
+        const T* p = v.data() + lvl[h];
+        T* q = v.data() + lvl[h + 1];
+        for (size_t i = begin; i < end; i++) {
+            q[i] = fold(p[i * B], p + i * B + 1, p + i * B + B);
+        }
+    }
+
+    void init(size_t sz) {
+        size_t s = round_up(sz ? sz : 1), total = s;
+        lvl.assign(1, 0);
+        while (s > B) {
+            s = round_up(s / B);
+            lvl.push_back(total);
+            total += s;
+        }
+        lvl.push_back(total);
+        v.assign(total, id);
+    }
+
+    static size_t round_up(size_t sz) {
+        return (sz + B - 1) / B * B;
+    }
+};
+
+} // container
+} // altruct
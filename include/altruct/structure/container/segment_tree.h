@@ -1,5 +1,8 @@
 #pragma once
 
+#include "altruct/concurrency/executor.h"
+
+#include <algorithm>
 #include <vector>
 #include <iterator>
 #include <functional>
@@ -7,6 +10,25 @@
 namespace altruct {
 namespace container {
 
+/**
+ * Functors for the common segment tree operations.
+ *
+ * Unlike the default `std::function`, these can get inlined into the tree loops.
+ * E.g. `segment_tree<int, segment_tree_min<int>> st(n, {}, INT_MAX);`
+ */
+template<typename T>
+struct segment_tree_sum {
+    T operator () (const T& t1, const T& t2) const { return t1 + t2; }
+};
+template<typename T>
+struct segment_tree_min {
+    T operator () (const T& t1, const T& t2) const { return (t2 < t1) ? t2 : t1; }
+};
+template<typename T>
+struct segment_tree_max {
+    T operator () (const T& t1, const T& t2) const { return (t1 < t2) ? t2 : t1; }
+};
+
 /**
  * Segment tree that supports range queries.
  *
@@ -15,6 +37,8 @@ namespace container {
  *   build: `O(n)`
  *   set: `O(log n)`
  *   get: `O(log n)`, or more precisely `O(log dist)`
+ *   set_many: `O(k log k + k log(n / k))` for `k` elements
+ *   get_many: `O(k log n)` for `k` queries
  *
  * param T  - element type
  * param f  - associative functor; i.e. `f(f(a, b), c) = f(a, f(b, c))`
@@ -51,6 +75,32 @@ public:
         }
     }
 
+    // Sets multiple elements at once.
+    // `[begin, end)` is a range of `(index, value)` pairs, applied in order.
+    // Each affected ancestor gets rebuilt exactly once, level by level.
+    // `exec` runs the rebuilding of each level, see `concurrency::serial_range_executor`.
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    void set_many(It begin, It end, const EXEC& exec = EXEC()) {
+        std::vector<size_t> vi;
+        for (It it = begin; it != end; ++it) {
+            size_t index = it->first + size();
+            v[index] = it->second;
+            vi.push_back(index);
+        }
+        std::sort(vi.begin(), vi.end());
+        vi.erase(std::unique(vi.begin(), vi.end()), vi.end());
+        while (!vi.empty() && vi[0] > 1) {
+            size_t k = 0;
+            for (size_t j = 0; j < vi.size(); j++) {
+                if (k == 0 || vi[k - 1] != vi[j] / 2) vi[k++] = vi[j] / 2;
+            }
+            vi.resize(k);
+            exec(0, (int)k, [&](int j0, int j1) {
+                for (int j = j0; j < j1; j++) update(vi[j]);
+            });
+        }
+    }
+
     // If the returned element is being modified,
     // the index won't be updated automatically.
     // Use `set` instead to update immediately,
@@ -80,6 +130,19 @@ public:
         }
         return f(tl, tr);
     }
+
+    // Performs multiple range queries at once.
+    // `[begin, end)` is a range of `(begin, end)` index pairs.
+    // `exec` runs the queries, see `concurrency::serial_range_executor`.
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    std::vector<T> get_many(It begin, It end, const EXEC& exec = EXEC()) const {
+        std::vector<T> r(std::distance(begin, end), v[0]);
+        exec(0, (int)r.size(), [&](int k0, int k1) {
+            It it = begin; std::advance(it, k0);
+            for (int k = k0; k < k1; k++, ++it) r[k] = get(it->first, it->second);
+        });
+        return r;
+    }
 
     size_t size() const {
         return v.size() / 2;
@@ -118,5 +181,18 @@ private:
     }
 };
 
+/**
+ * Creates a segment tree with the functor type deduced, so that it doesn't get type-erased.
+ * E.g. `auto st = make_segment_tree(n, [](int a, int b){ return a + b; }, 0);`
+ */
+template<typename T, typename F>
+segment_tree<T, F> make_segment_tree(size_t sz, const F& f, T id = T()) {
+    return segment_tree<T, F>(sz, f, id);
+}
+template<typename It, typename F, typename T = typename std::iterator_traits<It>::value_type>
+segment_tree<T, F> make_segment_tree(It begin, It end, const F& f, T id = T()) {
+    return segment_tree<T, F>(begin, end, f, id);
+}
+
 } // container
 } // altruct
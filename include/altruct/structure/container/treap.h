@@ -20,6 +20,7 @@ struct treap_iterator : public std::iterator<std::bidirectional_iterator_tag, T>
     treap_iterator(IT it) : it(it) { }
     int count() const { return it.count(); }
     int size() const { return it.size(); }
+    bool is_nil() const { return it.is_nil(); }
     T& operator * () { return *it; }
     T* operator -> () { return &*it; }
     bool operator == (const treap_iterator& rhs) const { return it == rhs.it; }
@@ -51,6 +52,7 @@ struct treap_const_iterator : public std::iterator<std::bidirectional_iterator_t
     treap_const_iterator(treap_iterator<T, IT> it) : it(it.it) { }
     int count() const { return it.count(); }
     int size() const { return it.size(); }
+    bool is_nil() const { return it.is_nil(); }
     const T& operator * () const { return *it; }
     const T* operator -> () const { return &*it; }
     bool operator == (const treap_const_iterator& rhs) const { return it == rhs.it; }
@@ -89,7 +91,7 @@ struct treap_const_iterator : public std::iterator<std::bidirectional_iterator_t
  * param CMP - comparison functor type
  * param ALLOC - allocator type
  */
-template<typename K, typename T = K, int DUP = bst_duplicate_handling::IGNORE, typename CMP = std::less<K>, typename RAND = std::function<int()>, typename ALLOC = std::allocator<bst_node<T>>>
+template<typename K, typename T = K, int DUP = bst_duplicate_handling::IGNORE, typename CMP = std::less<K>, typename RAND = bst_random, typename ALLOC = std::allocator<bst_node<T>>>
 class treap {
 protected:
     typedef binary_search_tree<K, T, DUP, CMP, ALLOC> bst_t;
@@ -104,15 +106,19 @@ public:
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    treap(const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    treap(const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         tree(cmp, alloc), rnd(rnd) {
     }
 
     template<typename It>
-    treap(It begin, It end, const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+    treap(It begin, It end, const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
         treap(cmp, rnd, alloc) {
-        for (It it = begin; it != end; ++it) {
-            insert(*it);
+        if (tree.is_sorted(begin, end)) {
+            assign_sorted(begin, end);
+        } else {
+            for (It it = begin; it != end; ++it) {
+                insert(*it);
+            }
         }
     }
 
@@ -237,7 +243,11 @@ public: // query & update
     }
 
     iterator insert(const T& val, int cnt = 1) {
-        return retrace_up(tree.insert(val, cnt));
+        int old_size = size();
+        auto it = tree.insert(val, cnt);
+        // only a newly created node gets a new priority and retraced up
+        bool is_new = (DUP == bst_duplicate_handling::COUNT) ? (it.count() == cnt) : (size() != old_size);
+        return is_new ? retrace_up(it) : it;
     }
 
     iterator insert_before(const_iterator it, const T& val, int cnt = 1) {
@@ -259,12 +269,43 @@ public: // query & update
     }
 
     iterator erase(const_iterator it, int cnt = std::numeric_limits<int>::max()) {
+        if (DUP == bst_duplicate_handling::COUNT && !it.is_nil() && cnt < it.count()) {
+            // the node stays in the tree, so there is no need to retrace it down
+            return tree.erase(it.it, cnt);
+        }
         return tree.erase(retrace_down(it.it), cnt);
     }
 
+public: // bulk operations
+    // Replaces the content with the elements of the sorted range in `O(n)`.
+    // important: this call is unchecked and the sort order may be violated
+    template<typename It>
+    void assign_sorted(It begin, It end) {
+        tree.assign_sorted(begin, end, [this](){ return rnd(); });
+    }
+
+    // Moves the elements whose keys are not less than `key` to `rhs`.
+    // Complexity: `O(h)`.
+    void split(const K& key, treap& rhs) {
+        tree.split(key, rhs.tree);
+    }
+
+    // Moves the elements at positions `k` and above to `rhs`.
+    // `split_kth` is not suitable when duplicate mode is set to COUNT
+    void split_kth(int k, treap& rhs) {
+        tree.split_kth(k, rhs.tree);
+    }
+
+    // Moves all the elements of `rhs` after the elements of this treap.
+    // Complexity: `O(h)`.
+    // important: this call is unchecked and the sort order may be violated
+    void merge(treap& rhs) {
+        tree.join(rhs.tree);
+    }
+
 protected:
     typename bst_t::iterator retrace_up(typename bst_t::iterator it) {
-        if (it == tree.end()) return it;
+        if (it.is_nil()) return it;
         it.balance() = rnd();
         while (it.balance() < it.parent().balance()) {
             if (it.parent().left() == it) {
@@ -277,8 +318,8 @@ protected:
     }
 
     typename bst_t::const_iterator retrace_down(typename bst_t::const_iterator it) {
-        if (it == tree.end()) return it;
-        while (it.left() != tree.end() && it.right() != tree.end()) {
+        if (it.is_nil()) return it;
+        while (!it.left().is_nil() && !it.right().is_nil()) {
             if (it.left().balance() < it.right().balance()) {
                 tree.rotate_right(it);
             } else {
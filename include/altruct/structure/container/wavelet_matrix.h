@@ -0,0 +1,263 @@
+#pragma once
+
+#include "altruct/algorithm/math/intrinsic.h"
+#include "altruct/concurrency/executor.h"
+#include "altruct/structure/container/bit_vector.h"
+#include "altruct/structure/container/bit_vector_rank_select.h"
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace altruct {
+namespace container {
+
+/**
+ * Wavelet matrix over a sequence of unsigned integers.
+ *
+ * There is a bit-vector per bit of the values, from the most significant one.
+ * Each level holds the corresponding bit of the values, with the values
+ * stably partitioned by the bits of the previous levels (zeros first).
+ * Each bit-vector is indexed with `bit_vector_rank_select`.
+ *
+ * Space complexity: `O(n log sigma)` bits.
+ * Time complexities:
+ *   build:            `O(n log sigma)`
+ *   access:           `O(log sigma)`
+ *   rank, count_less: `O(log sigma)`
+ *   select:           `O(log sigma)` rank/select operations
+ *   kth, range_freq:  `O(log sigma)`
+ *   top_k:            best-first search; `O(log sigma)` per visited node
+ *
+ * param T - value type, an unsigned integer type
+ * param W - word type of the bit-vectors
+ */
+template<typename T = uint32_t, typename W = uint64_t>
+class wavelet_matrix {
+public:
+    typedef T value_type;
+    typedef bit_vector<W> bit_vector_t;
+    typedef bit_vector_rank_select<W> rank_select_t;
+    static const int CHUNK = 1 << 16; // elements per construction chunk, a multiple of the word size
+
+protected:
+    size_t sz;
+    int num_levels;
+    std::vector<bit_vector_t> bits;  // level `i` holds the bit `num_levels - 1 - i` of the values
+    std::vector<rank_select_t> rs;   // rank/select index of each level
+    std::vector<size_t> zeros;       // number of zeros in each level
+
+public:
+    wavelet_matrix() : sz(0), num_levels(0) {}
+
+    // builds the wavelet matrix of the given sequence;
+    // `exec` runs the partitioning of each level and the indexing of all the levels,
+    // see `concurrency::serial_range_executor`.
+    template<typename It, typename EXEC = concurrency::serial_range_executor>
+    wavelet_matrix(It begin, It end, const EXEC& exec = EXEC()) {
+        std::vector<T> cur(begin, end), nxt(cur.size());
+        sz = cur.size();
+        T max_val = cur.empty() ? T(0) : *std::max_element(cur.begin(), cur.end());
+        for (num_levels = 0; max_val > 0; max_val >>= 1) num_levels++;
+        bits.assign(num_levels, bit_vector_t(sz));
+        zeros.assign(num_levels, 0);
+        int chunks = int((sz + CHUNK - 1) / CHUNK);
+        std::vector<size_t> offsets(chunks + 1);
+        for (int i = 0; i < num_levels; i++) {
+            int bit = num_levels - 1 - i;
+            bit_vector_t& bv = bits[i];
+            // set the bits and count the zeros of each chunk
+            exec(0, chunks, [&](int c0, int c1) {
+                for (int c = c0; c < c1; c++) {
+                    size_t j1 = std::min(sz, size_t(c + 1) * CHUNK), ones = 0;
+                    for (size_t j = size_t(c) * CHUNK; j < j1; j += bv.L) {
+                        W w = 0;
+                        for (size_t l = 0; l < size_t(bv.L) && j + l < j1; l++) {
+                            w |= W((cur[j + l] >> bit) & 1) << l;
+                        }
+                        bv.words[j / bv.L] = w;
+                        ones += math::popcount64(uint64_t(w));
+                    }
+                    offsets[c + 1] = j1 - size_t(c) * CHUNK - ones;
+                }
+            });
+            for (int c = 0; c < chunks; c++) offsets[c + 1] += offsets[c];
+            zeros[i] = offsets[chunks];
+            // stably partition the values, zeros first
+            exec(0, chunks, [&](int c0, int c1) {
+                for (int c = c0; c < c1; c++) {
+                    size_t j0 = size_t(c) * CHUNK, j1 = std::min(sz, j0 + CHUNK);
+                    size_t k0 = offsets[c], k1 = zeros[i] + j0 - offsets[c];
+                    for (size_t j = j0; j < j1; j++) {
+                        size_t b = (cur[j] >> bit) & 1;
+                        nxt[b ? k1 : k0] = cur[j];
+                        k1 += b, k0 += b ^ 1;
+                    }
+                }
+            });
+            cur.swap(nxt);
+        }
+        rs.resize(num_levels);
+        exec(0, num_levels, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) rs[i].build(bits[i]);
+        });
+    }
+
+    wavelet_matrix(const wavelet_matrix& rhs) :
+        sz(rhs.sz), num_levels(rhs.num_levels), bits(rhs.bits), rs(rhs.rs), zeros(rhs.zeros) {
+        // the indexes of the copy have to refer to the copied bit-vectors
+        for (int i = 0; i < num_levels; i++) rs[i].bv = &bits[i];
+    }
+
+    wavelet_matrix(wavelet_matrix&& rhs) : sz(0), num_levels(0) {
+        swap(rhs);
+    }
+
+    wavelet_matrix& operator=(const wavelet_matrix& rhs) {
+        wavelet_matrix rhs_copy(rhs);
+        swap(rhs_copy);
+        return *this;
+    }
+
+    wavelet_matrix& operator=(wavelet_matrix&& rhs) {
+        swap(rhs);
+        return *this;
+    }
+
+    // swapping the vectors keeps the addresses of the bit-vectors
+    void swap(wavelet_matrix& rhs) {
+        std::swap(sz, rhs.sz);
+        std::swap(num_levels, rhs.num_levels);
+        bits.swap(rhs.bits);
+        rs.swap(rhs.rs);
+        zeros.swap(rhs.zeros);
+    }
+
+    size_t size() const { return sz; }
+    int levels() const { return num_levels; }
+
+    // returns the value at the given position
+    T operator[] (size_t pos) const {
+        return access(pos);
+    }
+    T access(size_t pos) const {
+        T x = 0;
+        for (int i = 0; i < num_levels; i++) {
+            if (bits[i].bit_at(pos)) {
+                x |= T(1) << (num_levels - 1 - i);
+                pos = zeros[i] + rs[i].rank1(pos);
+            } else {
+                pos = rs[i].rank0(pos);
+            }
+        }
+        return x;
+    }
+
+    // returns the number of occurrences of `x` in `[begin, end)`
+    size_t rank(size_t begin, size_t end, T x) const {
+        if (!in_range(x)) return 0;
+        descend(begin, end, x);
+        return end - begin;
+    }
+
+    // returns the position of the `k`-th (0-based) occurrence of `x`, or `size()` if there is no such
+    size_t select(T x, size_t k) const {
+        if (!in_range(x)) return sz;
+        size_t begin = 0, end = sz;
+        descend(begin, end, x);
+        if (k >= end - begin) return sz;
+        size_t pos = begin + k;
+        for (int i = num_levels - 1; i >= 0; i--) {
+            if ((x >> (num_levels - 1 - i)) & 1) {
+                pos = rs[i].select1(pos - zeros[i]);
+            } else {
+                pos = rs[i].select0(pos);
+            }
+        }
+        return pos;
+    }
+
+    // returns the `k`-th (0-based) smallest value in `[begin, end)`; `k < end - begin`
+    T kth(size_t begin, size_t end, size_t k) const {
+        T x = 0;
+        for (int i = 0; i < num_levels; i++) {
+            size_t b0 = rs[i].rank0(begin), e0 = rs[i].rank0(end);
+            if (k < e0 - b0) {
+                begin = b0, end = e0;
+            } else {
+                k -= e0 - b0;
+                x |= T(1) << (num_levels - 1 - i);
+                begin = zeros[i] + begin - b0, end = zeros[i] + end - e0;
+            }
+        }
+        return x;
+    }
+
+    // returns the number of values less than `x` in `[begin, end)`
+    size_t count_less(size_t begin, size_t end, T x) const {
+        if (!in_range(x)) return end - begin;
+        size_t cnt = 0;
+        for (int i = 0; i < num_levels; i++) {
+            size_t b0 = rs[i].rank0(begin), e0 = rs[i].rank0(end);
+            if ((x >> (num_levels - 1 - i)) & 1) {
+                cnt += e0 - b0;
+                begin = zeros[i] + begin - b0, end = zeros[i] + end - e0;
+            } else {
+                begin = b0, end = e0;
+            }
+        }
+        return cnt;
+    }
+
+    // returns the number of values in `[lo, hi)` in `[begin, end)`
+    size_t range_freq(size_t begin, size_t end, T lo, T hi) const {
+        if (lo >= hi) return 0;
+        return count_less(begin, end, hi) - count_less(begin, end, lo);
+    }
+
+    // returns up to `k` most frequent values in `[begin, end)` together with their counts;
+    // ordered by the count descending, and then by the value ascending
+    std::vector<std::pair<T, size_t>> top_k(size_t begin, size_t end, size_t k) const {
+        std::vector<std::pair<T, size_t>> r;
+        // the widest range first; for the equal widths the smallest value first
+        typedef std::pair<std::pair<size_t, T>, std::pair<int, size_t>> entry_t; // ((width, ~value), (level, begin))
+        std::priority_queue<entry_t> q;
+        if (begin < end) q.push({ { end - begin, T(~T(0)) }, { 0, begin } });
+        while (!q.empty() && r.size() < k) {
+            entry_t e = q.top(); q.pop();
+            size_t w = e.first.first, b = e.second.second;
+            T x = T(~e.first.second);
+            int i = e.second.first;
+            if (i == num_levels) {
+                r.push_back({ x, w });
+                continue;
+            }
+            size_t b0 = rs[i].rank0(b), e0 = rs[i].rank0(b + w);
+            if (e0 > b0) q.push({ { e0 - b0, T(~x) }, { i + 1, b0 } });
+            if (w > e0 - b0) q.push({ { w - (e0 - b0), T(~(x | (T(1) << (num_levels - 1 - i)))) }, { i + 1, zeros[i] + b - b0 } });
+        }
+        return r;
+    }
+
+private:
+    // whether `x` is representable with `num_levels` bits
+    bool in_range(T x) const {
+        return num_levels >= int(sizeof(T) * 8) || (x >> num_levels) == 0;
+    }
+
+    // maps the range `[begin, end)` to the range of the occurrences of `x` at the bottom level
+    void descend(size_t& begin, size_t& end, T x) const {
+        for (int i = 0; i < num_levels; i++) {
+            if ((x >> (num_levels - 1 - i)) & 1) {
+                begin = zeros[i] + rs[i].rank1(begin), end = zeros[i] + rs[i].rank1(end);
+            } else {
+                begin = rs[i].rank0(begin), end = rs[i].rank0(end);
+            }
+        }
+    }
+};
+
+} // container
+} // altruct
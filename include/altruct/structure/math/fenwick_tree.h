@@ -6,6 +6,25 @@
 namespace altruct {
 namespace math {
 
+/**
+ * Functors for the common Fenwick tree operations.
+ *
+ * Unlike the default `std::function`, these can get inlined into the tree loops.
+ * E.g. `fenwick_tree<int, fenwick_tree_max<int>> f(n, {}, INT_MIN);`
+ */
+template<typename T>
+struct fenwick_tree_sum {
+    T operator () (const T& t1, const T& t2) const { return t1 + t2; }
+};
+template<typename T>
+struct fenwick_tree_min {
+    T operator () (const T& t1, const T& t2) const { return (t2 < t1) ? t2 : t1; }
+};
+template<typename T>
+struct fenwick_tree_max {
+    T operator () (const T& t1, const T& t2) const { return (t1 < t2) ? t2 : t1; }
+};
+
 /**
  * Fenwick tree.
  */
@@ -36,5 +55,14 @@ struct fenwick_tree {
     }
 };
 
+/**
+ * Creates a Fenwick tree with the functor type deduced, so that it doesn't get type-erased.
+ * E.g. `auto f = make_fenwick_tree(n, [](int a, int b){ return a + b; }, 0);`
+ */
+template<typename T, typename F>
+fenwick_tree<T, F> make_fenwick_tree(size_t sz, const F& f, T id = 0) {
+    return fenwick_tree<T, F>(sz, f, id);
+}
+
 } // math
 } // altruct
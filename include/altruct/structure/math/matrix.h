@@ -1,12 +1,18 @@
 #pragma once
 
 #include "altruct/algorithm/math/base.h"
+#include "altruct/concurrency/executor.h"
 
+#include <algorithm>
+#include <climits>
+#include <type_traits>
 #include <vector>
 
 namespace altruct {
 namespace math {
 
+template<typename T, typename ENABLE = void> struct matrix_mul;
+
 template<typename T>
 class matrix {
 public:
@@ -97,20 +103,152 @@ public:
         return zeroOf(*this) -= *this;
     }
 
-    // lhs.cols() must be equal to rhs.rows()
-    matrix& operator *= (const matrix &rhs) {
-        T e0 = zeroOf(a[0][0]);
-        int n = rows(), m = cols(), p = rhs.cols();
-        matrix t(n, p);
+    // t = lhs * rhs; O(n * m * p)
+    // the naive i-j-k loop, used for small matrices
+    // `t` must be of dimensions `lhs.rows() x rhs.cols()`
+    static void _mul_long(matrix &t, const matrix &lhs, const matrix &rhs) {
+        T e0 = zeroOf(lhs[0][0]);
+        int n = lhs.rows(), m = lhs.cols(), p = rhs.cols();
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < p; j++) {
                 T s = e0;
                 for (int k = 0; k < m; k++) {
-                    s += a[i][k] * rhs[k][j];
+                    s += lhs[i][k] * rhs[k][j];
                 }
                 t[i][j] = s;
             }
         }
+    }
+
+    // pr = pa * pbt^T; O(n * m * p)
+    // `pa` is `n x m`, `pbt` is `p x m` (the right operand transposed) and `pr` is `n x p`;
+    // all are stored contiguously in row-major order, with row strides `sa`, `sb` and `sr`.
+    // Both operands are read row-wise, and the work is tiled so that the tiles stay in cache.
+    static void _mul_blocked(T* pr, int sr, const T* pa, int sa, const T* pbt, int sb, int n, int m, int p) {
+        T e0 = zeroOf(*pa);
+        const int BI = 32, BJ = 32, BK = 256;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) {
+                pr[i * sr + j] = e0;
+            }
+        }
+        for (int k0 = 0; k0 < m; k0 += BK) {
+            int k1 = std::min(m, k0 + BK);
+            for (int i0 = 0; i0 < n; i0 += BI) {
+                int i1 = std::min(n, i0 + BI);
+                for (int j0 = 0; j0 < p; j0 += BJ) {
+                    int j1 = std::min(p, j0 + BJ);
+                    for (int i = i0; i < i1; i++) {
+                        const T* ra = pa + i * sa;
+                        T* rr = pr + i * sr;
+                        for (int j = j0; j < j1; j++) {
+                            const T* rb = pbt + j * sb;
+                            rr[j] = dot_product<T>::impl(rr[j], ra + k0, 1, rb + k0, 1, k1 - k0);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // pr = p1 + p2 or pr = p1 - p2; for `n x m` blocks with the given row strides
+    static void _add(T* pr, int sr, const T* p1, int s1, const T* p2, int s2, int n, int m) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                pr[i * sr + j] = p1[i * s1 + j] + p2[i * s2 + j];
+            }
+        }
+    }
+    static void _sub(T* pr, int sr, const T* p1, int s1, const T* p2, int s2, int n, int m) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                pr[i * sr + j] = p1[i * s1 + j] - p2[i * s2 + j];
+            }
+        }
+    }
+
+    // pr = pa * pbt^T; O((n * m * p) ^ (log2(7) / 3))
+    // Strassen-Winograd with 7 multiplications and 15 additions per level;
+    // the layout is as in `_mul_blocked`; odd dimensions get padded with zeros.
+    // Recursion stops once any of the dimensions is below `threshold`.
+    static void _mul_strassen(T* pr, int sr, const T* pa, int sa, const T* pbt, int sb, int n, int m, int p, int threshold) {
+        if (std::min(std::min(n, m), p) < std::max(threshold, 2)) {
+            return _mul_blocked(pr, sr, pa, sa, pbt, sb, n, m, p);
+        }
+        T e0 = zeroOf(*pa);
+        if (n % 2 || m % 2 || p % 2) {
+            int n2 = n + n % 2, m2 = m + m % 2, p2 = p + p % 2;
+            std::vector<T> va(n2 * m2, e0), vb(p2 * m2, e0), vr(n2 * p2, e0);
+            for (int i = 0; i < n; i++) std::copy(pa + i * sa, pa + i * sa + m, va.begin() + i * m2);
+            for (int i = 0; i < p; i++) std::copy(pbt + i * sb, pbt + i * sb + m, vb.begin() + i * m2);
+            _mul_strassen(vr.data(), p2, va.data(), m2, vb.data(), m2, n2, m2, p2, threshold);
+            for (int i = 0; i < n; i++) std::copy(vr.begin() + i * p2, vr.begin() + i * p2 + p, pr + i * sr);
+            return;
+        }
+        int h = n / 2, w = m / 2, q = p / 2;
+        // quadrants; note that `bij` are the quadrants of the transposed right operand
+        const T *a11 = pa, *a12 = pa + w, *a21 = pa + h * sa, *a22 = a21 + w;
+        const T *b11 = pbt, *b12 = pbt + w, *b21 = pbt + q * sb, *b22 = b21 + w;
+        T *r11 = pr, *r12 = pr + q, *r21 = pr + h * sr, *r22 = r21 + q;
+        std::vector<T> vs(h * w, e0), vt(q * w, e0), vu(h * q, e0), vv(h * q, e0);
+        T *s = vs.data(), *t = vt.data(), *u = vu.data(), *v = vv.data();
+        // u = P6 = (A21 + A22 - A11) * (B22 - B12 + B11); r12 = P5 = (A21 + A22) * (B12 - B11)
+        _add(s, w, a21, sa, a22, sa, h, w);                 // s = S1
+        _sub(t, w, b21, sb, b11, sb, q, w);                 // t = T1
+        _mul_strassen(r12, sr, s, w, t, w, h, w, q, threshold);
+        _sub(s, w, s, w, a11, sa, h, w);                    // s = S2
+        _sub(t, w, b22, sb, t, w, q, w);                    // t = T2
+        _mul_strassen(u, q, s, w, t, w, h, w, q, threshold);
+        // r22 = P3 = (A12 - S2) * B22; r21 = P4 = A22 * (T2 - B21)
+        _sub(s, w, a12, sa, s, w, h, w);                    // s = S4
+        _mul_strassen(r22, sr, s, w, b22, sb, h, w, q, threshold);
+        _sub(t, w, t, w, b12, sb, q, w);                    // t = T4
+        _mul_strassen(r21, sr, a22, sa, t, w, h, w, q, threshold);
+        // v = P1 = A11 * B11; u = U2 = P1 + P6
+        _mul_strassen(v, q, a11, sa, b11, sb, h, w, q, threshold);
+        _add(u, q, u, q, v, q, h, q);
+        // r11 = U1 = P1 + P2
+        _mul_strassen(r11, sr, a12, sa, b12, sb, h, w, q, threshold);
+        _add(r11, sr, r11, sr, v, q, h, q);
+        // v = P7 = (A11 - A21) * (B22 - B21); v = U3 = U2 + P7
+        _sub(s, w, a11, sa, a21, sa, h, w);                 // s = S3
+        _sub(t, w, b22, sb, b21, sb, q, w);                 // t = T3
+        _mul_strassen(v, q, s, w, t, w, h, w, q, threshold);
+        _add(v, q, v, q, u, q, h, q);
+        // r21 = U6 = U3 - P4; u = U4 = U2 + P5
+        _sub(r21, sr, v, q, r21, sr, h, q);
+        _add(u, q, u, q, r12, sr, h, q);
+        // U5 = U4 + P3 and U7 = U3 + P5 are computed in place of each other, and then swapped
+        _add(r22, sr, u, q, r22, sr, h, q);
+        _add(r12, sr, v, q, r12, sr, h, q);
+        for (int i = 0; i < h; i++) {
+            std::swap_ranges(r12 + i * sr, r12 + i * sr + q, r22 + i * sr);
+        }
+    }
+
+    // lhs.cols() must be equal to rhs.rows()
+    matrix& operator *= (const matrix &rhs) {
+        int n = rows(), m = cols(), p = rhs.cols();
+        matrix t(n, p, zeroOf(a[0][0]));
+        if (std::min(std::min(n, m), p) < 16) {
+            _mul_long(t, *this, rhs);
+            return swap(t);
+        }
+        // pack both operands contiguously, the right one transposed
+        T e0 = zeroOf(a[0][0]);
+        std::vector<T> va(n * m, e0), vb(p * m, e0), vr(n * p, e0);
+        for (int i = 0; i < n; i++) {
+            std::copy(a[i].begin(), a[i].end(), va.begin() + i * m);
+        }
+        for (int k = 0; k < m; k++) {
+            for (int j = 0; j < p; j++) {
+                vb[j * m + k] = rhs[k][j];
+            }
+        }
+        matrix_mul<T>::impl(vr.data(), va.data(), vb.data(), n, m, p);
+        for (int i = 0; i < n; i++) {
+            std::copy(vr.begin() + i * p, vr.begin() + (i + 1) * p, t[i].begin());
+        }
         return swap(t);
     }
     matrix operator * (const matrix &rhs) const {
@@ -159,8 +297,26 @@ public:
         }
     }
 
-    // matrix must be a square matrix
-    static int gauss(matrix &mat, matrix &inv, T &det) {
+    // row operations helper for `gauss`; eliminates column `j` from rows `[i0, i1)` using row `r`
+    // columns of `mat` before `j` are assumed to be zero in both rows
+    static void _eliminate(matrix &mat, matrix &inv, int r, int j, int i0, int i1) {
+        T e0 = zeroOf(mat.a[r][j]);
+        int n = mat.rows();
+        const row_type &mr = mat.a[r], &vr = inv.a[r];
+        for (int i = i0; i < i1; i++) {
+            T p = mat.a[i][j]; if (p == e0) continue;
+            row_type &mi = mat.a[i], &vi = inv.a[i];
+            for (int k = j; k < n; k++) mi[k] -= mr[k] * p;
+            for (int k = 0; k < n; k++) vi[k] -= vr[k] * p;
+        }
+    }
+
+    // Gauss-Jordan elimination; matrix must be a square matrix
+    // `mat` gets reduced, `inv` is set to the inverse and `det` to the determinant
+    // `exec` runs the row operations, see `concurrency::serial_range_executor`
+    // returns the rank of the matrix
+    template<typename EXEC = concurrency::serial_range_executor>
+    static int gauss(matrix &mat, matrix &inv, T &det, const EXEC& exec = EXEC()) {
         T e0 = zeroOf(mat.a[0][0]), e1 = identityOf(mat.a[0][0]);
         int i, j, k, n = mat.rows();
         inv = identity(n, e1);
@@ -173,63 +329,186 @@ public:
                 det = e0;
                 continue;
             }
-            rank++;
+            int r = rank++;
             // rows transposition
-            if (i != j) {
-                std::swap(mat.a[i], mat.a[j]);
-                std::swap(inv.a[i], inv.a[j]);
+            if (i != r) {
+                std::swap(mat.a[i], mat.a[r]);
+                std::swap(inv.a[i], inv.a[r]);
                 det = -det;
             }
             // normalize row
-            T pi = e1 / mat.a[j][j];
-            det *= mat.a[j][j];
-            for (k = 0; k < n; k++) {
-                mat.a[j][k] *= pi;
-                inv.a[j][k] *= pi;
-            }
+            T pi = e1 / mat.a[r][j];
+            det *= mat.a[r][j];
+            for (k = j; k < n; k++) mat.a[r][k] *= pi;
+            for (k = 0; k < n; k++) inv.a[r][k] *= pi;
             // eliminate below
-            for (i = rank; i < n; i++) {
-                T p = mat.a[i][j]; if (p == e0) continue;
-                for (k = 0; k < n; k++) {
-                    mat.a[i][k] -= mat.a[j][k] * p;
-                    inv.a[i][k] -= inv.a[j][k] * p;
-                }
-            }
+            exec(rank, n, [&](int i0, int i1){ _eliminate(mat, inv, r, j, i0, i1); });
         }
         if (rank == n) {
             for (j = n - 1; j >= 0; j--) {
                 // eliminate above
-                for (i = j - 1; i >= 0; i--) {
-                    T p = mat.a[i][j]; if (p == e0) continue;
-                    for (k = 0; k < n; k++) {
-                        mat.a[i][k] -= mat.a[j][k] * p;
-                        inv.a[i][k] -= inv.a[j][k] * p;
-                    }
-                }
+                exec(0, j, [&](int i0, int i1){ _eliminate(mat, inv, j, j, i0, i1); });
             }
         }
         return rank;
     }
 
+    // reduces `mat` to a row echelon form; matrix can be of any dimensions
+    // returns the rank of the matrix
+    template<typename EXEC = concurrency::serial_range_executor>
+    static int echelon(matrix &mat, const EXEC& exec = EXEC()) {
+        int n = mat.rows(), m = mat.cols();
+        if (n == 0 || m == 0) return 0;
+        T e0 = zeroOf(mat.a[0][0]), e1 = identityOf(mat.a[0][0]);
+        int rank = 0;
+        for (int j = 0; j < m && rank < n; j++) {
+            int i;
+            for (i = rank; i < n && mat.a[i][j] == e0; i++);
+            if (i >= n) continue;
+            int r = rank++;
+            if (i != r) std::swap(mat.a[i], mat.a[r]);
+            T pi = e1 / mat.a[r][j];
+            exec(rank, n, [&](int i0, int i1) {
+                const row_type &mr = mat.a[r];
+                for (int i = i0; i < i1; i++) {
+                    row_type &mi = mat.a[i];
+                    if (mi[j] == e0) continue;
+                    T p = mi[j] * pi;
+                    mi[j] = e0;
+                    for (int k = j + 1; k < m; k++) mi[k] -= mr[k] * p;
+                }
+            });
+        }
+        return rank;
+    }
+
+    // Right-looking blocked LU decomposition with row pivoting: `P * mat = L * U`
+    // matrix must be a square matrix over a field
+    // both `L` (unit lower triangular) and `U` (upper triangular) are stored in `mat`
+    // `perm[i]` is set to the original index of the i-th row
+    // `exec` runs the trailing submatrix updates, see `concurrency::serial_range_executor`
+    // returns the number of row transpositions, or -1 if the matrix is singular
+    template<typename EXEC = concurrency::serial_range_executor>
+    static int lu(matrix &mat, std::vector<int> &perm, const EXEC& exec = EXEC(), int block_size = 64) {
+        T e0 = zeroOf(mat.a[0][0]), e1 = identityOf(mat.a[0][0]);
+        int n = mat.rows(), swaps = 0;
+        perm.resize(n);
+        for (int i = 0; i < n; i++) perm[i] = i;
+        std::vector<T> ut;
+        for (int k0 = 0; k0 < n; k0 += block_size) {
+            int k1 = std::min(k0 + block_size, n), b = k1 - k0;
+            // factorize the panel `[k0, n) x [k0, k1)`
+            for (int j = k0; j < k1; j++) {
+                int i;
+                for (i = j; i < n && mat.a[i][j] == e0; i++);
+                if (i >= n) return -1;
+                if (i != j) {
+                    std::swap(mat.a[i], mat.a[j]);
+                    std::swap(perm[i], perm[j]);
+                    swaps++;
+                }
+                const row_type &mj = mat.a[j];
+                T pi = e1 / mj[j];
+                for (i = j + 1; i < n; i++) {
+                    row_type &mi = mat.a[i];
+                    if (mi[j] == e0) continue;
+                    T l = mi[j] *= pi;
+                    for (int k = j + 1; k < k1; k++) mi[k] -= l * mj[k];
+                }
+            }
+            if (k1 == n) break;
+            // U12 = L11^-1 * A12
+            for (int j = k0 + 1; j < k1; j++) {
+                row_type &mj = mat.a[j];
+                for (int t = k0; t < j; t++) {
+                    T l = mj[t]; if (l == e0) continue;
+                    const row_type &mt = mat.a[t];
+                    for (int k = k1; k < n; k++) mj[k] -= l * mt[k];
+                }
+            }
+            // A22 -= L21 * U12; U12 is transposed so that both get accessed row-wise
+            ut.resize((n - k1) * b);
+            for (int t = k0; t < k1; t++) {
+                for (int k = k1; k < n; k++) {
+                    ut[(k - k1) * b + (t - k0)] = mat.a[t][k];
+                }
+            }
+            exec(k1, n, [&](int i0, int i1) {
+                for (int i = i0; i < i1; i++) {
+                    row_type &mi = mat.a[i];
+                    const T *pl = mi.data() + k0, *pu = ut.data();
+                    for (int k = k1; k < n; k++, pu += b) {
+                        mi[k] -= dot_product<T>::impl(e0, pl, 1, pu, 1, b);
+                    }
+                }
+            });
+        }
+        return swaps;
+    }
+
     // matrix must be a square matrix
-    matrix inverse() const {
+    template<typename EXEC = concurrency::serial_range_executor>
+    matrix inverse(const EXEC& exec = EXEC()) const {
         matrix mat(*this), inv; T det;
-        gauss(mat, inv, det);
+        gauss(mat, inv, det, exec);
         return inv;
     }
 
-    // matrix must be a square matrix
-    T det() const {
-        matrix mat(*this), inv; T det;
-        gauss(mat, inv, det);
-        return det;
+    // matrix must be a square matrix over a field
+    template<typename EXEC = concurrency::serial_range_executor>
+    T det(const EXEC& exec = EXEC()) const {
+        matrix mat(*this); std::vector<int> perm;
+        int swaps = lu(mat, perm, exec);
+        if (swaps < 0) return zeroOf(a[0][0]);
+        T det = identityOf(a[0][0]);
+        for (int i = 0; i < rows(); i++) {
+            det *= mat.a[i][i];
+        }
+        return (swaps % 2) ? -det : det;
     }
 
-    // matrix must be a square matrix
-    int rank() const {
-        matrix mat(*this), inv; T det;
-        int r = gauss(mat, inv, det);
-        return r;
+    // matrix can be of any dimensions
+    template<typename EXEC = concurrency::serial_range_executor>
+    int rank(const EXEC& exec = EXEC()) const {
+        matrix mat(*this);
+        return echelon(mat, exec);
+    }
+
+    // solves `*this * x = b` for `x`
+    // matrix must be a non-singular square matrix over a field
+    // `b` is an `n x m` matrix of `m` right-hand sides
+    // returns an empty matrix if the matrix is singular
+    template<typename EXEC = concurrency::serial_range_executor>
+    matrix solve(const matrix &b, const EXEC& exec = EXEC()) const {
+        matrix mat(*this); std::vector<int> perm;
+        if (lu(mat, perm, exec) < 0) return matrix();
+        T e0 = zeroOf(a[0][0]);
+        int n = rows(), m = b.cols();
+        matrix x(n, m, e0);
+        for (int i = 0; i < n; i++) {
+            x.a[i] = b.a[perm[i]];
+        }
+        exec(0, m, [&](int c0, int c1) {
+            // L * y = P * b
+            for (int i = 1; i < n; i++) {
+                row_type &xi = x.a[i];
+                for (int t = 0; t < i; t++) {
+                    T l = mat.a[i][t]; if (l == e0) continue;
+                    for (int c = c0; c < c1; c++) xi[c] -= l * x.a[t][c];
+                }
+            }
+            // U * x = y
+            for (int i = n - 1; i >= 0; i--) {
+                row_type &xi = x.a[i];
+                for (int t = i + 1; t < n; t++) {
+                    T u = mat.a[i][t]; if (u == e0) continue;
+                    for (int c = c0; c < c1; c++) xi[c] -= u * x.a[t][c];
+                }
+                T pi = identityOf(e0) / mat.a[i][i];
+                for (int c = c0; c < c1; c++) xi[c] *= pi;
+            }
+        });
+        return x;
     }
 
     matrix transpose() const {
@@ -252,6 +531,32 @@ public:
     }
 };
 
+/**
+ * `matrix<T>` multiplication implementation.
+ *
+ * Specialize this template for a custom or tweaked implementation.
+ *
+ * The operands are passed contiguously in row-major order, with the
+ * right operand transposed, so that both get accessed row-wise.
+ * You may call one of the already provided implementations:
+ * `matrix<T>::_mul_blocked` or `matrix<T>::_mul_strassen`.
+ */
+template<typename T, typename ENABLE>
+struct matrix_mul {
+    // Strassen-Winograd is used only when all the dimensions are at least this big;
+    // off by default for the floating point types, as its error bounds are weaker
+    static int strassen_threshold;
+
+    // @param pr - `n x p` result: `pr = pa * pbt^T`
+    // @param pa - `n x m` left operand
+    // @param pbt - `p x m` right operand, transposed
+    static void impl(T* pr, const T* pa, const T* pbt, int n, int m, int p) {
+        matrix<T>::_mul_strassen(pr, p, pa, m, pbt, m, n, m, p, strassen_threshold);
+    }
+};
+template<typename T, typename ENABLE>
+int matrix_mul<T, ENABLE>::strassen_threshold = std::is_floating_point<T>::value ? INT_MAX : 128;
+
 template<typename T, typename I>
 struct castT<matrix<T>, I> {
     static matrix<T> of(const I& x) {
@@ -276,6 +276,36 @@ struct hasherT<modulo<T, ID, STORAGE_TYPE>> {
     }
 };
 
+/**
+ * Dot product for `modulo<integral_type, ...>` with lazy reduction
+ *
+ * For `M <= 2^32`, each product fits in 64 bits. The products are summed up
+ * in 64 bits without reduction, counting the overflows, and the whole sum
+ * gets reduced only once at the end. Larger moduli use the generic loop.
+ */
+template<typename I, uint64_t ID, int STORAGE_TYPE>
+struct dot_product<modulo<I, ID, STORAGE_TYPE>, std::enable_if_t<std::is_integral<I>::value>> {
+    typedef modulo<I, ID, STORAGE_TYPE> mod;
+    static mod impl(mod s, const mod* a, int sa, const mod* b, int sb, int n) {
+        uint64_t M = uint64_t(s.M());
+        if (M == 0 || M > (uint64_t(1) << 32)) {
+            for (int i = 0; i < n; i++) {
+                s += a[i * sa] * b[i * sb];
+            }
+            return s;
+        }
+        uint64_t r = uint64_t(s.v), c = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t t = uint64_t(a[i * sa].v) * uint64_t(b[i * sb].v);
+            r += t; c += (r < t);
+        }
+        // c * 2^64 + r; both `c % M` and `2^64 % M` are below 2^32
+        uint64_t p64 = (uint64_t(0) - M) % M;
+        s.v = I(((c % M) * p64 % M + r % M) % M);
+        return s;
+    }
+};
+
 template<typename T>
 T modT(T v, const T& M) { return modulo_normalize(v, M); }
 
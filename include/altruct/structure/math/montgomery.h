@@ -0,0 +1,84 @@
+#pragma once
+
+#include "altruct/algorithm/math/intrinsic.h"
+
+#include <stdint.h>
+
+namespace altruct {
+namespace math {
+
+/**
+ * Montgomery multiplication modulo an odd modulus.
+ *
+ * Values in the Montgomery form are `x * 2^k mod n`, kept in `[0, n)`,
+ * where `k` is the number of bits of `W`.
+ * A modular multiplication then takes three full-width multiplications and no division,
+ * which makes it much faster than `modulo_mul` for the moduli above 2^(k/2).
+ * Addition, subtraction, equality and gcd with `n` are the same in both forms.
+ *
+ * Any odd `n < 2^k` is supported.
+ *
+ * param W - word type; `uint64_t`, or `unsigned __int128` where supported
+ */
+template<typename W>
+struct montgomery {
+    static const int BITS = int(sizeof(W) * 8);
+
+    W n;     // the modulus
+    W n_inv; // n^-1 mod 2^k
+    W r1;    // 2^k mod n; i.e. 1 in the Montgomery form
+    W r2;    // 2^2k mod n
+
+    montgomery(W n) : n(n) {
+        // Newton's iteration; each step doubles the number of the correct low bits
+        n_inv = n;
+        for (int bits = 3; bits < BITS; bits *= 2) n_inv *= 2 - n * n_inv;
+        r1 = (W(0) - n) % n;
+        r2 = r1;
+        for (int i = 0; i < BITS; i++) r2 = add(r2, r2);
+    }
+
+    // reduces `hi * 2^k + lo < n * 2^k` to `(hi * 2^k + lo) * 2^-k mod n`
+    W reduce(W hi, W lo) const {
+        W m = lo * n_inv, mh;
+        mul_full(m, n, &mh);
+        return (hi < mh) ? hi - mh + n : hi - mh;
+    }
+
+    W to(W x) const { return mul(x % n, r2); }
+    W from(W x) const { return reduce(0, x); }
+    W one() const { return r1; }
+
+    W mul(W x, W y) const {
+        W hi, lo = mul_full(x, y, &hi);
+        return reduce(hi, lo);
+    }
+    W add(W x, W y) const {
+        W r = x + y;
+        return (r < x || r >= n) ? r - n : r;
+    }
+    W sub(W x, W y) const {
+        return (x < y) ? x - y + n : x - y;
+    }
+    W pow(W x, W e) const {
+        W r = r1;
+        for (; e > 0; e >>= 1) {
+            if (e & 1) r = mul(r, x);
+            x = mul(x, x);
+        }
+        return r;
+    }
+
+    static uint64_t mul_full(uint64_t x, uint64_t y, uint64_t* hi) { return mul_128(x, y, hi); }
+#if defined(__SIZEOF_INT128__)
+    static unsigned __int128 mul_full(unsigned __int128 x, unsigned __int128 y, unsigned __int128* hi) { return mul_256(x, y, hi); }
+#endif
+};
+
+typedef montgomery<uint64_t> montgomery64;
+#if defined(__SIZEOF_INT128__)
+typedef montgomery<unsigned __int128> montgomery128;
+#endif
+
+} // math
+} // altruct
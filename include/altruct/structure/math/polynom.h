@@ -3,6 +3,7 @@
 #include "altruct/algorithm/math/base.h"
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <type_traits>
 #include <vector>
@@ -113,13 +114,10 @@ public:
     static void _mul_long(T* pr, int lr, const T* p1, int l1, const T* p2, int l2) {
         auto ZERO_COEFF = zeroOf(*p1);
         for (int i = lr; i >= 0; i--) {
-            T r = ZERO_COEFF;
             int jmax = std::min(i, l1);
             int jmin = std::max(0, i - l2);
-            for (int j = jmax; j >= jmin; j--) {
-                r += p1[j] * p2[i - j];
-            }
-            pr[i] = r;
+            // r = sum{p1[j] * p2[i - j], {j, jmax, jmin}}
+            pr[i] = dot_product<T>::impl(ZERO_COEFF, p1 + jmax, -1, p2 + i - jmax, 1, jmax - jmin + 1);
         }
     }
 
@@ -272,6 +270,128 @@ public:
         if (lr < l1) pr.resize(lr + 1);
     }
 
+    // q = p1 / p2, r = p1 % p2; O(M(l1 - l2, max(l2, l1 - l2)))
+    // `q`, `r`, `p1` and `p2` must all be different instances
+    static void div_mod(polynom &q, polynom &r, const polynom &p1, const polynom &p2) {
+        int l1 = p1.deg(), l2 = p2.deg(); int lq = l1 - l2;
+        if (lq < 0) { q = polynom(p1.ZERO_COEFF); r = p1; return; }
+        quot_rem(r, p1, p2);
+        q.c.assign(r.c.begin() + l2, r.c.begin() + l1 + 1);
+        q.ZERO_COEFF = p1.ZERO_COEFF;
+        r.resize(std::max(l2, 1));
+        if (l2 == 0) r[0] = p1.ZERO_COEFF;
+    }
+
+    // degree of `p`, or -1 if `p` is zero
+    static int _deg(const polynom &p) {
+        int l = p.deg();
+        return (l == 0 && p[0] == p.ZERO_COEFF) ? -1 : l;
+    }
+
+    // p / x^k, discarding the remainder; O(l)
+    static polynom _shr(const polynom &p, int k) {
+        if (k >= p.size()) return polynom(p.ZERO_COEFF);
+        return polynom(p.c.begin() + k, p.c.end());
+    }
+
+    // 2x2 polynomial matrix `{{m[0], m[1]}, {m[2], m[3]}}` used by the half-gcd
+    typedef std::array<polynom, 4> matrix2;
+
+    static matrix2 _mat_identity(const polynom &p) {
+        polynom e0(p.ZERO_COEFF), e1(p.id_coeff());
+        return matrix2{ { e1, e0, e0, e1 } };
+    }
+
+    // m1 * m2
+    static matrix2 _mat_mul(const matrix2 &m1, const matrix2 &m2) {
+        return matrix2{ {
+            m1[0] * m2[0] + m1[1] * m2[2], m1[0] * m2[1] + m1[1] * m2[3],
+            m1[2] * m2[0] + m1[3] * m2[2], m1[2] * m2[1] + m1[3] * m2[3] } };
+    }
+
+    // (r0, r1) = m * (p0, p1)
+    static void _mat_apply(polynom &r0, polynom &r1, const matrix2 &m, const polynom &p0, const polynom &p1) {
+        r0 = m[0] * p0 + m[1] * p1;
+        r1 = m[2] * p0 + m[3] * p1;
+    }
+
+    // m = {{0, 1}, {1, -q}} * m; a single step of the Euclidean algorithm
+    // if `qs` is given, `q` is appended to it
+    static void _mat_step(matrix2 &m, const polynom &q, std::vector<polynom>* qs = nullptr) {
+        m[0] -= q * m[2]; m[0].swap(m[2]);
+        m[1] -= q * m[3]; m[1].swap(m[3]);
+        if (qs) qs->push_back(q);
+    }
+
+    // half-gcd by performing the Euclidean steps one by one; O(l0 * (l0 - k))
+    // reduces `(r0, r1)` in place until `deg(r1) < k`
+    static matrix2 _half_gcd_long(polynom &r0, polynom &r1, int k, std::vector<polynom>* qs = nullptr) {
+        matrix2 m = _mat_identity(r0);
+        polynom q, r;
+        while (_deg(r1) >= k) {
+            div_mod(q, r, r0, r1);
+            _mat_step(m, q, qs);
+            r0.swap(r1); r1.swap(r);
+        }
+        return m;
+    }
+
+    // Half-GCD; O(M(l0) log l0)
+    //
+    // Returns the matrix `m` such that `(r0, r1) = m * (p0, p1)` are the two
+    // consecutive remainders in the Euclidean sequence of `p0` and `p1`, for which
+    // `deg(r0) >= k > deg(r1)` holds, where `k = ceil(deg(p0) / 2)`.
+    // `m[2]` and `m[3]` are then the Bezout cofactors of `r1`.
+    // If `qs` is given, the quotients of the performed steps are appended to it.
+    // `deg(p0) > deg(p1)` must hold; coefficients must form a field.
+    static matrix2 half_gcd(const polynom &p0, const polynom &p1, std::vector<polynom>* qs = nullptr) {
+        int l0 = _deg(p0), k = (l0 + 1) / 2;
+        if (_deg(p1) < k) return _mat_identity(p0);
+        if (l0 < 64) { polynom r0 = p0, r1 = p1; return _half_gcd_long(r0, r1, k, qs); }
+        // the leading `l0 - k` coefficients determine the first half of quotients
+        matrix2 m = half_gcd(_shr(p0, k), _shr(p1, k), qs);
+        polynom r0, r1, q, r;
+        _mat_apply(r0, r1, m, p0, p1);
+        if (_deg(r1) < k) return m;
+        div_mod(q, r, r0, r1);
+        _mat_step(m, q, qs);
+        r0.swap(r1); r1.swap(r);
+        if (_deg(r1) < k) return m;
+        // `k <= deg(r0) <= 2k`; reduce the remaining `deg(r0) - k` degrees
+        int j = 2 * k - _deg(r0);
+        return _mat_mul(half_gcd(_shr(r0, j), _shr(r1, j), qs), m);
+    }
+
+    // Runs the whole Euclidean algorithm on `(r0, r1)`; O(M(l) log l)
+    //
+    // Reduces `(r0, r1)` in place to `(g, 0)`, where `g` is the last non-zero remainder,
+    // and returns the matrix `m` such that `(g, 0) = m * (p0, p1)` for the original input.
+    // If `qs` is given, the quotients of all the steps are appended to it.
+    // Coefficients must form a field.
+    static matrix2 gcd_matrix(polynom &r0, polynom &r1, std::vector<polynom>* qs = nullptr) {
+        matrix2 m = _mat_identity(r0);
+        polynom q, r, t0, t1;
+        if (_deg(r1) >= 0 && _deg(r0) <= _deg(r1)) {
+            div_mod(q, r, r0, r1);
+            _mat_step(m, q, qs);
+            r0.swap(r1); r1.swap(r);
+        }
+        while (_deg(r1) >= 0) {
+            if (_deg(r0) < 64) {
+                return _mat_mul(_half_gcd_long(r0, r1, 0, qs), m);
+            }
+            matrix2 h = half_gcd(r0, r1, qs);
+            _mat_apply(t0, t1, h, r0, r1);
+            r0.swap(t0); r1.swap(t1);
+            m = _mat_mul(h, m);
+            if (_deg(r1) < 0) break;
+            div_mod(q, r, r0, r1);
+            _mat_step(m, q, qs);
+            r0.swap(r1); r1.swap(r);
+        }
+        return m;
+    }
+
     // pr = p1 * s; O(l1)
     // it is allowed for `p1` and `pr` to be the same instance
     static void mul(polynom &pr, const polynom &p1, const T &s) {
@@ -411,5 +531,40 @@ struct zeroT<polynom<T>> {
     }
 };
 
+/**
+ * Greatest Common Divisor of polynomials.
+ *
+ * Overloads the generic `gcd` so that the half-gcd gets used for high
+ * degrees, in which case coefficients must form a field.
+ */
+template<typename T>
+polynom<T> gcd(polynom<T> a, polynom<T> b) {
+    if (std::max(a.deg(), b.deg()) < 64) {
+        T e0 = a.ZERO_COEFF;
+        while (a != e0) { polynom<T> r = b % a; b = a; a = r; }
+        return b;
+    }
+    polynom<T>::gcd_matrix(b, a);
+    return b;
+}
+
+/**
+ * Extended Greatest Common Divisor of polynomials.
+ *
+ * Overloads the generic `gcd_ex` so that the half-gcd gets used for high
+ * degrees, in which case coefficients must form a field.
+ * The results are the same as those of the generic `gcd_ex`.
+ */
+template<typename T>
+polynom<T> gcd_ex(const polynom<T>& a, const polynom<T>& b, polynom<T> *x = nullptr, polynom<T> *y = nullptr, int *s = nullptr) {
+    polynom<T> g = a, h = b;
+    std::vector<polynom<T>> qs;
+    auto m = polynom<T>::gcd_matrix(g, h, s ? &qs : nullptr);
+    if (x) *x = m[0];
+    if (y) *y = m[1];
+    if (s) *s = (int)qs.size();
+    return g;
+}
+
 } // math
 } // altruct
@@ -190,17 +190,22 @@ public:
         for (int i = 2; i < K; i++) {
             tm[i] = tm[i - 1] * tm[1];
         }
+        // pt[k * K + j] = pm[j][k]; cs[i * K + j] = p[i * K + j]
+        std::vector<T> pt(N * K, p.ZERO_COEFF), cs(K * K, p.ZERO_COEFF);
+        for (int j = 0; j < K; j++) {
+            for (int k = 0; k < N; k++) {
+                pt[k * K + j] = pm[j][k];
+            }
+        }
+        for (int i = 0; i < K * K; i++) {
+            cs[i] = this->p[i];
+        }
         std::vector<series> qm(K); // O(N^2)
         for (int i = 0; i < K; i++) {
-            int iK = i * K;
             auto& qi = qm[i];
             qi = series(polynom<T>(p.ZERO_COEFF), N);
-            for (int j = 0; j < K; j++) {
-                auto& pj = pm[j];
-                auto ck = this->p[iK + j];
-                for (int k = 0; k < N; k++) {
-                    qi[k] += pj[k] * ck;
-                }
+            for (int k = 0; k < N; k++) {
+                qi[k] = dot_product<T>::impl(p.ZERO_COEFF, pt.data() + k * K, 1, cs.data() + i * K, 1, K);
             }
         }
         series s = qm[0]; // O(sqrt(N) * M(N))
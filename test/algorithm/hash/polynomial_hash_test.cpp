@@ -1,7 +1,10 @@
 #include "altruct/algorithm/hash/polynomial_hash.h"
+#include "altruct/structure/math/modulo.h"
+#include "altruct/concurrency/concurrency.h"
 
 #include "gtest/gtest.h"
 
+#include <ctime>
 #include <string>
 
 using namespace std;
@@ -19,6 +22,20 @@ template<> int32_t phash2::M[2] = { 758986603, 1000000007 };
 template<> int32_t phash2::B[2] = { 36759071, 32547971 };
 template<> int32_t phash2::BI[2] = { 366621061, 624567078 };
 
+// the largest moduli for which `h + M - rhs` fits in 31 bits
+typedef polynomial_hash<3> phash3;
+template<> int32_t phash3::M[3] = { 1073741789, 1073741783, 1073741741 };
+template<> int32_t phash3::B[3] = { 16807, 123456791, 1000000011 };
+template<> int32_t phash3::BI[3] = { 0, 0, 0 }; // computed in the test
+
+typedef polynomial_hash_m61<1000000000000000003ULL> phash61;
+
+// used only by `cumulative_hash_parallel`, so that its power tables start empty
+typedef polynomial_hash<4> phash4;
+template<> int32_t phash4::M[4] = { 758986603, 1000000007, 998244353, 1000000009 };
+template<> int32_t phash4::B[4] = { 36759071, 32547971, 3, 7 };
+template<> int32_t phash4::BI[4] = { 366621061, 624567078, 332748118, 857142865 };
+
 TEST(polynomial_hash_test, polynomial_hash_constructor) {
     phash2 h0;
     EXPECT_EQ(0, h0.h[0]);
@@ -244,3 +261,104 @@ TEST(polynomial_hash_test, polynomial_hash1) {
         }
     }
 }
+
+TEST(polynomial_hash_test, polynomial_hash_barrett) {
+    typedef altruct::math::moduloX<int64_t> modx;
+    for (int k = 0; k < 3; k++) {
+        phash3::BI[k] = int32_t((modx(1, phash3::M[k]) / modx(phash3::B[k], phash3::M[k])).v);
+    }
+    phash3::ensure(1000);
+    for (int k = 0; k < 3; k++) {
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_EQ(1, phash3::mul(phash3::W[k][i], phash3::WI[k][i], phash3::M[k])) << k << " " << i;
+        }
+        int64_t x = 12345;
+        for (int i = 0; i < 10000; i++) {
+            x = (x * 48271) % 2147483647;
+            int32_t a = int32_t(x % phash3::M[k]), b = int32_t((x * 31) % phash3::M[k]), s = int32_t(x % 1000);
+            EXPECT_EQ(phash3::mul(a, b, phash3::M[k]), phash3::mul_k(k, a, b));
+            EXPECT_EQ(phash3::mul(s, a, b, phash3::M[k]), phash3::mul_k(k, s, a, b));
+        }
+        // the largest operands, and the negative ones get reduced the same way as by `mul`
+        int32_t m1 = phash3::M[k] - 1;
+        EXPECT_EQ(phash3::mul(m1, m1, phash3::M[k]), phash3::mul_k(k, m1, m1));
+        EXPECT_EQ(phash3::mul(m1, -5, m1, phash3::M[k]), phash3::mul_k(k, m1, -5, m1));
+    }
+    string s = "mississippi";
+    cumulative_hash<phash3> ch(s.begin(), s.end());
+    EXPECT_EQ(ch.get(1, 4), ch.get(4, 7)); // "iss"
+    EXPECT_FALSE(ch.get(0, 4) == ch.get(4, 8));
+}
+
+TEST(polynomial_hash_test, polynomial_hash_m61) {
+    const uint64_t M = phash61::M, B = 1000000000000000003ULL % M;
+    EXPECT_EQ((uint64_t(1) << 61) - 1, M);
+    EXPECT_EQ(altruct::math::modulo_mul(M - 1, M - 1, M), phash61::mul(M - 1, M - 1));
+    EXPECT_EQ(altruct::math::modulo_mul(B, uint64_t(123456789012345ULL), M), phash61::mul(B, 123456789012345ULL));
+    phash61 h;
+    h.add(44, 0);
+    h.add(55, 1);
+    EXPECT_EQ(altruct::math::modulo_mul(uint64_t(55), B, M) + 44, h.hash());
+    phash61::ensure(100);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(1, phash61::mul(phash61::W[i], phash61::WI[i])) << i;
+    }
+    vector<int> v;
+    int x = 31;
+    for (int i = 0; i < 300; i++) {
+        v.push_back(x = x * int64_t(x) % 1009);
+    }
+    cumulative_hash<phash61> ch(v.begin(), v.end());
+    for (int e = 0; e <= v.size(); e++) {
+        for (int b = 0; b <= e; b++) {
+            // the hash of a range only depends on its contents
+            cumulative_hash<phash61> chr(v.begin() + b, v.begin() + e);
+            EXPECT_EQ(chr.get(0, e - b), ch.get(b, e)) << " b = " << b << ", e = " << e;
+        }
+    }
+    EXPECT_EQ(ch.get(10, 15).hash(), ((phash61(v[10]) + (phash61(v[14]) << 4)) + (ch.get(11, 14) << 1)).hash());
+    EXPECT_EQ(phash61(3), (phash61(3) << 7) >> 7);
+}
+
+TEST(polynomial_hash_test, cumulative_hash_parallel) {
+    // documents of increasing lengths, so that the shared power tables keep growing while being read
+    vector<vector<int>> docs(64);
+    uint64_t x = 1;
+    for (int d = 0; d < 64; d++) {
+        docs[d].resize(1000 * (d + 1));
+        for (auto& c : docs[d]) x = x * 6364136223846793005ULL + 1, c = int(x >> 40) & 255;
+    }
+    vector<phash4> vh(docs.size());
+    altruct::concurrency::parallel_for_range(0, int(docs.size()), [&](int d0, int d1) {
+        for (int d = d0; d < d1; d++) {
+            cumulative_hash<phash4> ch(docs[d].begin(), docs[d].end());
+            vh[d] = ch.get(10, docs[d].size());
+        }
+    }, 8);
+    for (int d = 0; d < 64; d++) {
+        phash4 h;
+        for (size_t i = 10; i < docs[d].size(); i++) h.add(docs[d][i], i - 10);
+        EXPECT_EQ(h, vh[d]) << d;
+    }
+}
+
+TEST(polynomial_hash_test, cumulative_hash_perf) {
+    return; // skip perf tests by default
+    vector<int> v(1 << 22);
+    uint64_t x = 1;
+    for (auto& c : v) x = x * 6364136223846793005ULL + 1, c = int(x >> 40) & 255;
+    vector<int> q(1 << 22);
+    for (auto& e : q) x = x * 6364136223846793005ULL + 1, e = int(x >> 40) % (v.size() - 100);
+    int64_t r = 0;
+    auto T0 = clock();
+    cumulative_hash<phash2> ch2(v.begin(), v.end());
+    auto T1 = clock();
+    for (int e : q) r += ch2.get(e, e + 77).hash();
+    auto T2 = clock();
+    cumulative_hash<phash61> ch61(v.begin(), v.end());
+    auto T3 = clock();
+    for (int e : q) r += ch61.get(e, e + 77).hash();
+    auto T4 = clock();
+    printf("2 x 31 bits: build %0.3lf s, get %0.3lf s; 61 bits: build %0.3lf s, get %0.3lf s    %d\n",
+        double(T1 - T0) / CLOCKS_PER_SEC, double(T2 - T1) / CLOCKS_PER_SEC, double(T3 - T2) / CLOCKS_PER_SEC, double(T4 - T3) / CLOCKS_PER_SEC, int(r & 1));
+}
@@ -0,0 +1,149 @@
+#include "altruct/algorithm/hash/substring_hash_index.h"
+#include "altruct/concurrency/concurrency.h"
+
+#include "gtest/gtest.h"
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace altruct::hash;
+
+namespace {
+typedef polynomial_hash_m61<1000000000000000003ULL> phash;
+typedef substring_hash_index<phash> index_t;
+
+string random_string(int n, int sigma, unsigned seed) {
+    srand(seed);
+    string s;
+    for (int i = 0; i < n; i++) s += char('a' + rand() % sigma);
+    return s;
+}
+
+map<string, vector<int>> brute_force_occurrences(const string& s, int len) {
+    map<string, vector<int>> m;
+    for (int i = 0; i + len <= int(s.size()); i++) m[s.substr(i, len)].push_back(i);
+    return m;
+}
+
+pair<int, int> brute_force_longest_repeat(const string& s) {
+    for (int len = int(s.size()) - 1; len > 0; len--) {
+        auto m = brute_force_occurrences(s, len);
+        for (int i = 0; i + len <= int(s.size()); i++) {
+            if (m[s.substr(i, len)].size() > 1) return{ len, i };
+        }
+    }
+    return{ 0, 0 };
+}
+}
+
+TEST(substring_hash_index_test, find) {
+    for (int sigma = 1; sigma <= 4; sigma++) {
+        string s = random_string(200, sigma, 10 + sigma);
+        vector<int> lengths{ 0, 1, 2, 3, 5, 8, 13, 200, 201 };
+        index_t index(s.begin(), s.end(), lengths);
+        EXPECT_EQ(200, index.size());
+        EXPECT_TRUE(index.has_length(13));
+        EXPECT_FALSE(index.has_length(4));
+        for (int len : lengths) {
+            for (const auto& e : brute_force_occurrences(s, len)) {
+                EXPECT_EQ(e.second, index.find(e.first.begin(), e.first.end())) << e.first;
+                EXPECT_EQ(e.second, index.find(index.hashes().get(e.second[0], e.second[0] + len), len));
+            }
+            if (len == 0) continue;
+            string absent(len, 'z');
+            EXPECT_EQ(vector<int>(), index.find(absent.begin(), absent.end()));
+        }
+    }
+}
+
+TEST(substring_hash_index_test, repeats) {
+    string s = random_string(300, 3, 42);
+    vector<int> lengths{ 1, 4, 7, 10, 20 };
+    index_t index(s.begin(), s.end(), lengths, altruct::concurrency::parallel_range_executor(4));
+    for (int len : lengths) {
+        vector<int> expected;
+        for (const auto& e : brute_force_occurrences(s, len)) {
+            if (e.second.size() > 1) expected.push_back(e.second[0]);
+        }
+        sort(expected.begin(), expected.end());
+        EXPECT_EQ(expected, index.repeats(len)) << len;
+        EXPECT_EQ(expected.empty() ? -1 : expected[0], index.first_repeat(len)) << len;
+        for (int i : index.repeats(len)) {
+            int cnt = 0;
+            for (int j = i; j >= 0; j = index.next_occurrence(j, len)) {
+                EXPECT_EQ(s.substr(i, len), s.substr(j, len));
+                cnt++;
+            }
+            EXPECT_EQ(brute_force_occurrences(s, len)[s.substr(i, len)].size(), cnt);
+        }
+    }
+}
+
+TEST(substring_hash_index_test, unindexed_length) {
+    string s = "abcabcabc";
+    index_t index(s.begin(), s.end(), { 1, 3 });
+    for (int len : { 0, 2, 4, 9, 10 }) {
+        EXPECT_FALSE(index.has_length(len));
+        EXPECT_EQ(-1, index.first_occurrence(index.hashes().get(0, min(len, 9)), len));
+        EXPECT_EQ(-1, index.next_occurrence(0, len));
+        EXPECT_EQ(vector<int>(), index.find(s.begin(), s.begin() + min(len, 9)));
+        EXPECT_EQ(vector<int>(), index.repeats(len));
+        EXPECT_EQ(-1, index.first_repeat(len));
+    }
+    EXPECT_EQ((vector<int>{ 0, 3, 6 }), index.find(s.begin(), s.begin() + 3));
+}
+
+TEST(substring_hash_index_test, cumulative_hash) {
+    string s = "abracadabra";
+    cumulative_hash<phash> ch(s.begin(), s.end());
+    index_t index(ch, { 4 });
+    // refers to the given cumulative hash instead of copying it
+    EXPECT_EQ(&ch, &index.hashes());
+    EXPECT_EQ(11, index.size());
+    EXPECT_EQ((vector<int>{ 0, 7 }), index.find(s.begin(), s.begin() + 4));
+    EXPECT_EQ((vector<int>{ 0 }), index.repeats(4));
+    // a copy of an index that owns its cumulative hash is independent of the original
+    unique_ptr<index_t> own(new index_t(s.begin(), s.end(), { 4 }));
+    index_t copy(*own);
+    own.reset();
+    EXPECT_EQ(11, copy.size());
+    EXPECT_EQ((vector<int>{ 0, 7 }), copy.find(s.begin(), s.begin() + 4));
+}
+
+TEST(substring_hash_index_test, longest_repeated_substring) {
+    string s0;
+    EXPECT_EQ(make_pair(0, 0), longest_repeated_substring<phash>(s0.begin(), s0.end()));
+    string s1 = "abcd";
+    EXPECT_EQ(make_pair(0, 0), longest_repeated_substring<phash>(s1.begin(), s1.end()));
+    string s2 = "aaaa";
+    EXPECT_EQ(make_pair(3, 0), longest_repeated_substring<phash>(s2.begin(), s2.end()));
+    string s3 = "xabcyabcz";
+    EXPECT_EQ(make_pair(3, 1), longest_repeated_substring<phash>(s3.begin(), s3.end()));
+    for (int sigma = 2; sigma <= 4; sigma++) {
+        for (int n = 1; n <= 60; n += 7) {
+            string s = random_string(n, sigma, n * 10 + sigma);
+            auto expected = brute_force_longest_repeat(s);
+            for (int probes = 1; probes <= 4; probes++) {
+                EXPECT_EQ(expected, longest_repeated_substring<phash>(s.begin(), s.end(), probes)) << s << " " << probes;
+            }
+            EXPECT_EQ(expected, longest_repeated_substring<phash>(s.begin(), s.end(), 3, altruct::concurrency::parallel_range_executor(3))) << s;
+        }
+    }
+}
+
+TEST(substring_hash_index_test, perf) {
+    return; // skip perf tests by default
+    string s = random_string(1000000, 4, 1);
+    cumulative_hash<phash> ch(s.begin(), s.end());
+    for (int threads = 1; threads <= 4; threads *= 2) {
+        for (int probes = 1; probes <= 4; probes *= 2) {
+            auto T0 = clock();
+            auto r = longest_repeated_substring<phash>(ch, probes, altruct::concurrency::parallel_range_executor(threads));
+            double dT = double(clock() - T0) / CLOCKS_PER_SEC;
+            printf("threads: %d, probes: %d, length: %d, position: %d, time: %.3f s\n", threads, probes, r.first, r.second, dT);
+        }
+    }
+}
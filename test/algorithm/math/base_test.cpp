@@ -173,6 +173,18 @@ TEST(base_test, powT) {
     }
 }
 
+TEST(base_test, dot_product) {
+    const int a[] = { 1, 2, 3, 4, 5 };
+    const int b[] = { 6, 7, 8, 9, 10 };
+    EXPECT_EQ(100, dot_product<int>::impl(100, a, 1, b, 1, 0));
+    EXPECT_EQ(130, dot_product<int>::impl(0, a, 1, b, 1, 5));
+    EXPECT_EQ(131, dot_product<int>::impl(1, a, 1, b, 1, 5));
+    EXPECT_EQ(1 * 10 + 2 * 9 + 3 * 8 + 4 * 7 + 5 * 6, dot_product<int>::impl(0, a, 1, b + 4, -1, 5));
+    EXPECT_EQ(1 * 6 + 3 * 7 + 5 * 8, dot_product<int>::impl(0, a, 2, b, 1, 3));
+    const double c[] = { 0.5, 1.5 };
+    EXPECT_EQ(3.5, dot_product<double>::impl(1.0, c, 1, c, 1, 2));
+}
+
 template<typename I>
 void test_sqT_uint() {
     EXPECT_EQ(I(0), sqT<I>(0));
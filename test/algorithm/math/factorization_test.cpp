@@ -1,8 +1,12 @@
 ﻿#include "altruct/algorithm/math/factorization.h"
 #include "altruct/algorithm/math/primes.h"
+#include "altruct/concurrency/concurrency.h"
 #include "altruct/structure/math/polynom.h"
+#include "altruct/algorithm/random/xorshift.h"
 
 #include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <vector>
 #include <map>
 
@@ -37,6 +41,93 @@ TEST(primes_test, pollard_rho) {
     EXPECT_EQ(int64_t(36947), pollard_rho_repeated(int64_t(27259) * 36947));
 }
 
+TEST(primes_test, miller_rabin_64bit) {
+    EXPECT_TRUE(miller_rabin(uint64_t(2305843009213693951ULL))); // 2^61-1
+    EXPECT_TRUE(miller_rabin(uint64_t(18446744073709551557ULL))); // the largest 64-bit prime
+    EXPECT_TRUE(miller_rabin(int64_t(988359650216386457LL)));
+    EXPECT_FALSE(miller_rabin(uint64_t(3825123056546413051ULL))); // strong pseudoprime to bases up to 23
+    EXPECT_FALSE(miller_rabin(uint64_t(4294967291ULL) * 4294967279ULL));
+    EXPECT_FALSE(miller_rabin(uint64_t(18446744073709551557ULL) - 2));
+}
+
+TEST(primes_test, pollard_rho_brent) {
+    EXPECT_EQ(1, pollard_rho_brent_repeated(1));
+    EXPECT_EQ(2, pollard_rho_brent_repeated(2 * 2 * 2 * 2 * 2 * 2));
+    int d = pollard_rho_brent_repeated(5 * 5 * 5 * 7 * 13 * 13);
+    EXPECT_TRUE(d > 1 && d < 5 * 5 * 5 * 7 * 13 * 13 && (5 * 5 * 5 * 7 * 13 * 13) % d == 0);
+    for (uint64_t p : { 1657ULL, 21859ULL, 87803ULL, 181153303ULL, 4294967291ULL }) {
+        for (uint64_t q : { 7027ULL, 45751ULL, 113903ULL, 558255521ULL, 4294967279ULL }) {
+            uint64_t d = pollard_rho_brent_repeated(p * q);
+            EXPECT_TRUE(d == p || d == q) << p << " * " << q << ": " << d;
+            int64_t ds = pollard_rho_brent_repeated(int64_t(p * q));
+            EXPECT_TRUE(uint64_t(ds) == p || uint64_t(ds) == q) << p << " * " << q << ": " << ds;
+        }
+    }
+}
+
+TEST(primes_test, trial_division) {
+    typedef vector<pair<uint64_t, int>> fact;
+    fact vf;
+    EXPECT_EQ(1, trial_division(uint64_t(438399070200ULL), vf));
+    EXPECT_EQ((fact{ { 2, 3 }, { 3, 5 }, { 5, 2 }, { 7, 4 }, { 13, 1 }, { 17, 2 } }), vf);
+    vf.clear();
+    EXPECT_EQ(1, trial_division(uint64_t(2 * 1021 * 1019), vf));
+    EXPECT_EQ((fact{ { 2, 1 }, { 1019, 1 }, { 1021, 1 } }), vf);
+    vf.clear();
+    EXPECT_EQ(1, trial_division(uint64_t(3 * 1048573), vf)); // the cofactor is a prime below 2^20
+    EXPECT_EQ((fact{ { 3, 1 }, { 1048573, 1 } }), vf);
+    vf.clear();
+    EXPECT_EQ(1031ULL * 1033, trial_division(uint64_t(1031ULL * 1033 * 1013 * 1013), vf));
+    EXPECT_EQ((fact{ { 1013, 2 } }), vf);
+    typedef vector<pair<int, int>> ifact;
+    ifact vi;
+    EXPECT_EQ(1031 * 1033, trial_division(1031 * 1033 * 4 * 9, vi));
+    EXPECT_EQ((ifact{ { 2, 2 }, { 3, 2 } }), vi);
+}
+
+TEST(primes_test, ecm) {
+    for (uint64_t p : { 1000003ULL, 10000019ULL }) {
+        uint64_t n = p * 1000000000039ULL;
+        uint64_t d = ecm(n, ecm_params::level(0));
+        EXPECT_TRUE(d == p || d == 1000000000039ULL) << n << ": " << d;
+    }
+    EXPECT_EQ(int64_t(1000003), ecm_repeated(int64_t(1000003) * 1000003));
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(primes_test, factor_integer_int128) {
+    typedef unsigned __int128 u128;
+    typedef vector<pair<u128, int>> fact;
+    u128 p = u128(10000000000037ULL), q = u128(1000000000000ULL) * 1000000000000ULL + 7; // 10^13 + 37, 10^24 + 7
+    u128 big = (u128(1) << 127) + 29;
+    EXPECT_TRUE(miller_rabin(q));
+    EXPECT_TRUE(miller_rabin(big));
+    EXPECT_FALSE(miller_rabin(p * q));
+    u128 d = ecm(p * q, ecm_params::level(0));
+    EXPECT_TRUE(d == p || d == q);
+    EXPECT_TRUE(factor_integer(big) == (fact{ { big, 1 } }));
+    EXPECT_TRUE(sorted(factor_integer(p * q * 12)) == (fact{ { 2, 2 }, { 3, 1 }, { p, 1 }, { q, 1 } }));
+}
+
+TEST(primes_test, ecm_perf) {
+    return; // skip perf tests by default
+    typedef unsigned __int128 u128;
+    altruct::random::xorshift_64star rng(12345);
+    int k = 20, found = 0;
+    auto T0 = clock();
+    for (int i = 0; i < k; i++) {
+        // semiprimes with two ~60-bit prime factors
+        uint64_t p, q;
+        do p = (rng.next() >> 4) | 1; while (!miller_rabin(p));
+        do q = (rng.next() >> 4) | 1; while (!miller_rabin(q));
+        u128 d = ecm_repeated(u128(p) * q);
+        found += (d == p || d == q);
+    }
+    auto T1 = clock();
+    printf("ecm: %0.3lf s per 120-bit semiprime, %d / %d found\n", double(T1 - T0) / CLOCKS_PER_SEC / k, found, k);
+}
+#endif
+
 TEST(primes_test, factor_integer_general_purpose) {
     typedef vector<pair<int64_t, int>> fact;
     // smooth
@@ -57,6 +148,100 @@ TEST(primes_test, factor_integer_general_purpose) {
     EXPECT_EQ((fact{ { 988359650216386457, 1 } }), sorted(factor_integer(int64_t(988359650216386457LL))));
 }
 
+TEST(primes_test, factor_integer_uint64) {
+    typedef vector<pair<uint64_t, int>> fact;
+    EXPECT_EQ((fact{ { 4294967279ULL, 1 }, { 4294967291ULL, 1 } }), sorted(factor_integer(uint64_t(4294967291ULL * 4294967279ULL))));
+    EXPECT_EQ((fact{ { 18446744073709551557ULL, 1 } }), sorted(factor_integer(uint64_t(18446744073709551557ULL))));
+    EXPECT_EQ((fact{ { 2, 63 } }), sorted(factor_integer(uint64_t(1) << 63)));
+    altruct::random::xorshift_64star rng(12345);
+    for (int i = 0; i < 1000; i++) {
+        uint64_t n = rng.next() >> (i % 40);
+        if (n == 0) continue;
+        uint64_t m = 1;
+        for (const auto& f : factor_integer(n)) {
+            EXPECT_TRUE(miller_rabin(f.first)) << n;
+            for (int e = 0; e < f.second; e++) m *= f.first;
+        }
+        EXPECT_EQ(n, m);
+    }
+}
+
+TEST(primes_test, is_prime_batch) {
+    altruct::random::xorshift_64star rng(12345);
+    vector<uint64_t> vn;
+    for (int i = 0; i < 10000; i++) vn.push_back(rng.next() >> (i % 64));
+    vector<char> ve;
+    for (auto n : vn) ve.push_back(miller_rabin(n));
+    EXPECT_EQ(ve, is_prime_batch(vn.begin(), vn.end()));
+    EXPECT_EQ(ve, is_prime_batch(vn.begin(), vn.end(), altruct::concurrency::parallel_range_executor(4)));
+    vector<int> vi{ 0, 1, 2, 3, 4, 5, 97, 561, 7919 };
+    EXPECT_EQ((vector<char>{ 0, 0, 1, 1, 0, 1, 1, 0, 1 }), is_prime_batch(vi.begin(), vi.end()));
+}
+
+TEST(primes_test, factor_integers) {
+    altruct::random::xorshift_64star rng(12345);
+    vector<uint64_t> vn;
+    for (int i = 0; i < 10000; i++) vn.push_back(rng.next() >> (i % 64));
+    auto fb = factor_integers(vn.begin(), vn.end());
+    auto fbp = factor_integers(vn.begin(), vn.end(), altruct::concurrency::parallel_range_executor(4));
+    EXPECT_EQ(vn.size(), fb.size());
+    EXPECT_EQ(fb.offsets, fbp.offsets);
+    EXPECT_EQ(fb.factors, fbp.factors);
+    EXPECT_EQ(fb.factors.size(), fb.offsets.back());
+    for (size_t i = 0; i < vn.size(); i++) {
+        EXPECT_EQ(factor_integer(vn[i]), fb[i]) << vn[i];
+    }
+    vector<int> vi{ 12, 1, 0, 97, 1024 };
+    auto fbi = factor_integers(vi.begin(), vi.end());
+    EXPECT_EQ((vector<size_t>{ 0, 2, 2, 2, 3, 4 }), fbi.offsets);
+    EXPECT_EQ((vector<pair<int, int>>{ { 2, 2 }, { 3, 1 }, { 97, 1 }, { 2, 10 } }), fbi.factors);
+    vector<int> ve;
+    EXPECT_EQ(0, factor_integers(ve.begin(), ve.end()).size());
+}
+
+TEST(primes_test, factor_integers_perf) {
+    return; // skip perf tests by default
+    typedef std::chrono::steady_clock clk;
+    auto secs = [](clk::duration d){ return std::chrono::duration<double>(d).count(); };
+    altruct::random::xorshift_64star rng(12345);
+    vector<uint64_t> vn;
+    for (int i = 0; i < 1000000; i++) vn.push_back(rng.next() >> 2);
+    auto T0 = clk::now();
+    auto vp = is_prime_batch(vn.begin(), vn.end());
+    auto T1 = clk::now();
+    auto fb = factor_integers(vn.begin(), vn.end());
+    auto T2 = clk::now();
+    auto fbp = factor_integers(vn.begin(), vn.end(), altruct::concurrency::parallel_range_executor(8));
+    auto T3 = clk::now();
+    printf("is_prime_batch: %0.3lf s, factor_integers: %0.3lf s, on 8 threads: %0.3lf s    %d\n",
+        secs(T1 - T0), secs(T2 - T1), secs(T3 - T2), int(fb.factors.size() + fbp.factors.size() + vp.size()) & 1);
+}
+
+TEST(primes_test, factor_integer_perf) {
+    return; // skip perf tests by default
+    altruct::random::xorshift_64star rng(12345);
+    int k = 100000;
+    vector<uint64_t> vs, vn;
+    for (int i = 0; i < 200; i++) {
+        // semiprimes with two ~30-bit prime factors
+        uint64_t p, q;
+        do p = (rng.next() >> 34) | 1; while (!miller_rabin(p));
+        do q = (rng.next() >> 34) | 1; while (!miller_rabin(q));
+        vs.push_back(p * q);
+    }
+    for (int i = 0; i < k; i++) vn.push_back(rng.next() >> 2);
+    uint64_t r = 0;
+    auto T0 = clock();
+    for (auto n : vs) r += pollard_rho_repeated(n);
+    auto T1 = clock();
+    for (auto n : vs) r += pollard_rho_brent_repeated(n);
+    auto T2 = clock();
+    for (auto n : vn) r += factor_integer(n).size();
+    auto T3 = clock();
+    double t1 = double(T1 - T0) / CLOCKS_PER_SEC, t2 = double(T2 - T1) / CLOCKS_PER_SEC, t3 = double(T3 - T2) / CLOCKS_PER_SEC;
+    printf("rho floyd: %0.3lf s, rho brent: %0.3lf s; factor_integer: %0.0lf / s    %d\n", t1, t2, k / t3, int(r & 1));
+}
+
 TEST(primes_test, factor_integer_general_purpose_first_1000) {
     typedef vector<pair<int, int>> fact;
 
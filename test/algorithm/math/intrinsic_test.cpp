@@ -1,5 +1,6 @@
 #include "altruct/algorithm/math/intrinsic.h"
 #include <limits>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -42,3 +43,70 @@ TEST(intrinsic_test, add_overflow_uint64) {
     test_impl<uint32_t>("uint32_t");
     test_impl<uint64_t>("uint64_t");
 }
+
+TEST(intrinsic_test, popcount64) {
+    EXPECT_EQ(0, popcount64(0));
+    EXPECT_EQ(1, popcount64(1));
+    EXPECT_EQ(64, popcount64(~uint64_t(0)));
+    EXPECT_EQ(32, popcount64(0xAAAAAAAAAAAAAAAAULL));
+    EXPECT_EQ(bit_cnt1(uint64_t(0x123456789ABCDEF0ULL)), popcount64(0x123456789ABCDEF0ULL));
+}
+
+TEST(intrinsic_test, ilog2_64) {
+    EXPECT_EQ(0, ilog2_64(0));
+    EXPECT_EQ(0, ilog2_64(1));
+    EXPECT_EQ(63, ilog2_64(~uint64_t(0)));
+    for (int i = 0; i < 64; i++) {
+        EXPECT_EQ(i, ilog2_64(uint64_t(1) << i));
+        EXPECT_EQ(ilog2(uint64_t(0x123456789ABCDEF0ULL >> i)), ilog2_64(0x123456789ABCDEF0ULL >> i));
+    }
+}
+
+TEST(intrinsic_test, tzc64) {
+    EXPECT_EQ(0, tzc64(1));
+    EXPECT_EQ(63, tzc64(uint64_t(1) << 63));
+    for (int i = 0; i < 64; i++) {
+        EXPECT_EQ(i, tzc64(uint64_t(1) << i));
+        EXPECT_EQ(i, tzc64(~uint64_t(0) << i));
+        EXPECT_EQ(tzc(uint64_t(0x923456789ABCDEF0ULL >> i)), tzc64(0x923456789ABCDEF0ULL >> i));
+    }
+}
+
+TEST(intrinsic_test, select64) {
+    EXPECT_EQ(0, select64(1, 0));
+    EXPECT_EQ(63, select64(uint64_t(1) << 63, 0));
+    for (int k = 0; k < 64; k++) {
+        EXPECT_EQ(k, select64(~uint64_t(0), k));
+    }
+    for (int k = 0; k < 32; k++) {
+        EXPECT_EQ(2 * k + 1, select64(0xAAAAAAAAAAAAAAAAULL, k));
+    }
+    uint64_t x = 0x8000F00100000110ULL;
+    vector<int> pos{ 4, 8, 32, 44, 45, 46, 47, 63 };
+    for (int k = 0; k < 8; k++) {
+        EXPECT_EQ(pos[k], select64(x, k));
+    }
+}
+
+TEST(intrinsic_test, mul_128) {
+    uint64_t hi = 1;
+    EXPECT_EQ(0, mul_128(0, 12345, &hi));
+    EXPECT_EQ(0, hi);
+    EXPECT_EQ(56088, mul_128(123, 456, &hi));
+    EXPECT_EQ(0, hi);
+    EXPECT_EQ(1, mul_128(~uint64_t(0), ~uint64_t(0), &hi));
+    EXPECT_EQ(~uint64_t(0) - 1, hi);
+    EXPECT_EQ(0x2236D88FE5618CF0ULL, mul_128(0x123456789ABCDEF0ULL, 0x0FEDCBA987654321ULL, &hi));
+    EXPECT_EQ(0x0121FA00AD77D742ULL, hi);
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(intrinsic_test, mul_256) {
+    typedef unsigned __int128 u128;
+    u128 hi = 1;
+    EXPECT_TRUE(mul_256(0, 12345, &hi) == 0 && hi == 0);
+    EXPECT_TRUE(mul_256(123, 456, &hi) == 56088 && hi == 0);
+    EXPECT_TRUE(mul_256(~u128(0), ~u128(0), &hi) == 1 && hi == ~u128(0) - 1);
+    EXPECT_TRUE(mul_256(u128(1) << 100, u128(1) << 100, &hi) == 0 && hi == u128(1) << 72);
+}
+#endif
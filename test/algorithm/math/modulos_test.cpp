@@ -1,9 +1,11 @@
 #include "altruct/algorithm/math/modulos.h"
 #include "altruct/algorithm/math/ranges.h"
 #include "altruct/algorithm/collections/collections.h"
+#include "altruct/concurrency/concurrency.h"
 
 #include "gtest/gtest.h"
 
+#include <ctime>
 #include <unordered_map>
 #include <vector>
 
@@ -266,6 +268,76 @@ TEST(modulos_test, discrete_log_baby_giant_g) {
     }
 }
 
+TEST(modulos_test, baby_step_table) {
+    for (int o = 1; o <= 120; o++) {
+        for (int v = 0; v < o; v++) {
+            cyclic a(v, o);
+            for (int m : { 0, 1, 5, o }) {
+                baby_step_table<cyclic, int> table(a, o, m);
+                cyclic a_x(0, o);
+                for (int x = 0; x < o; x++) {
+                    int xx = table.log(a_x);
+                    EXPECT_EQ(powT(a, xx), a_x) << o << " " << v << " " << m << " " << x;
+                    a_x *= a;
+                }
+            }
+        }
+    }
+    // not in the subgroup
+    EXPECT_EQ(-1, (baby_step_table<cyclic, int>(cyclic(2, 10), 10).log(cyclic(3, 10))));
+    // many queries against a single table
+    typedef moduloX<int64_t> modx;
+    int64_t p = 1000003, k = 1000;
+    baby_step_table<modx, int64_t> table(modx(2, p), p - 1, sqrtT(p * k));
+    modx b(1, p);
+    for (int i = 0; i < k; i++, b *= modx(7919, p)) {
+        int64_t x = table.log(b);
+        EXPECT_EQ(b, powT(modx(2, p), x)) << b.v;
+    }
+}
+
+TEST(modulos_test, discrete_log_pollard_rho_g) {
+    for (int o = 1; o <= 120; o++) {
+        for (int v = 1; v < o; v++) {
+            if (gcd(v, o) != 1) continue;
+            cyclic a(v, o);
+            cyclic a_x(0, o);
+            for (int x = 0; x < o; x++) {
+                int xx = discrete_log_pollard_rho_g(a, a_x, o);
+                EXPECT_EQ(powT(a, xx), a_x) << o << " " << v << " " << x;
+                a_x *= a;
+            }
+        }
+    }
+    typedef moduloX<int64_t> modx;
+    int64_t p = 1000000007; // 5 is a primitive root
+    for (int64_t x : { 0LL, 1LL, 2LL, 12345LL, 987654321LL, 1000000005LL }) {
+        modx b = powT(modx(5, p), x);
+        int64_t xx = discrete_log_pollard_rho_g(modx(5, p), b, p - 1);
+        EXPECT_EQ(b, powT(modx(5, p), xx)) << x;
+    }
+}
+
+TEST(modulos_test, baby_step_table_perf) {
+    return; // skip perf tests by default
+    typedef moduloX<int64_t> modx;
+    int64_t p = 1000000007, k = 10000;
+    modx g(5, p);
+    vector<modx> vb;
+    for (int i = 0; i < k; i++) vb.push_back(powT(g, int64_t(i) * 7919 + 1));
+    auto T0 = clock();
+    int64_t r = 0;
+    for (int i = 0; i < 100; i++) r += discrete_log_baby_giant_g(g, vb[i], p - 1);
+    auto T1 = clock();
+    baby_step_table<modx, int64_t> table(g, p - 1, sqrtT((p - 1) * k));
+    for (const auto& b : vb) r += table.log(b);
+    auto T2 = clock();
+    for (int i = 0; i < 100; i++) r += discrete_log_pollard_rho_g(g, vb[i], p - 1);
+    auto T3 = clock();
+    printf("per query: baby_giant: %0.3lf ms, shared table: %0.3lf ms, pollard rho: %0.3lf ms    %d\n",
+        double(T1 - T0) / CLOCKS_PER_SEC * 10, double(T2 - T1) / CLOCKS_PER_SEC / k * 1000, double(T3 - T2) / CLOCKS_PER_SEC * 10, int(r & 1));
+}
+
 TEST(modulos_test, discrete_log_order_pp_g) {
     int N = 300;
     prime_holder prim(N);
@@ -302,6 +374,101 @@ TEST(modulos_test, discrete_log_g) {
     }
 }
 
+TEST(modulos_test, discrete_log_g_parallel) {
+    typedef moduloX<int64_t> modx;
+    int64_t p = 1000000007; // p - 1 = 2 * 500000003
+    vector<int64_t> n_factors{ 2, 500000003 };
+    altruct::concurrency::parallel_range_executor exec(2);
+    for (int64_t x : { 0LL, 1LL, 12345LL, 999999999LL }) {
+        modx b = powT(modx(5, p), x);
+        int64_t o = 0;
+        EXPECT_EQ(x, discrete_log_g(modx(5, p), b, p - 1, n_factors, &o, exec));
+        EXPECT_EQ(p - 1, o);
+    }
+    int N = 100;
+    prime_holder prim(N);
+    for (int n = 1; n < N; n++) {
+        auto n_factors = prime_factors(prim.factor_integer(n));
+        for (int v = 0; v < n; v += 3) {
+            cyclic a(v, n);
+            cyclic a_x(0, n);
+            for (int x = 0; x < n; x++) {
+                int xx = discrete_log_g(a, a_x, n, n_factors, (int*)nullptr, exec);
+                EXPECT_EQ(powT(a, xx), a_x) << n << " " << v << " " << x;
+                a_x *= a;
+            }
+        }
+    }
+}
+
+TEST(modulos_test, discrete_log_table) {
+    int N = 200;
+    prime_holder prim(N);
+    for (int n = 1; n < N; n++) {
+        auto n_factors = prime_factors(prim.factor_integer(n));
+        for (int v = 0; v < n; v++) {
+            cyclic a(v, n);
+            discrete_log_table<cyclic, int> table(a, n, n_factors, n);
+            EXPECT_EQ(n / gcd(v, n), table.order());
+            vector<cyclic> vb;
+            for (int w = 0; w < n; w++) vb.push_back(cyclic(w, n));
+            auto vx = table.log_batch(vb.begin(), vb.end());
+            for (int w = 0; w < n; w++) {
+                int x = table.log(vb[w]);
+                EXPECT_EQ(x, vx[w]);
+                if (w % gcd(v, n) == 0) {
+                    // in the subgroup
+                    EXPECT_EQ(vb[w], powT(a, x)) << n << " " << v << " " << w;
+                    EXPECT_LE(0, x);
+                    EXPECT_GT(table.order(), x);
+                } else {
+                    EXPECT_EQ(-1, x) << n << " " << v << " " << w;
+                }
+            }
+        }
+    }
+    typedef moduloX<int64_t> modx;
+    int64_t p = 998244353; // p - 1 = 2^23 * 7 * 17, 3 is a primitive root
+    vector<int64_t> n_factors{ 2, 7, 17 };
+    altruct::concurrency::parallel_range_executor exec(4);
+    discrete_log_table<modx, int64_t> table(modx(3, p), p - 1, n_factors, 1000, exec);
+    vector<int64_t> vx;
+    vector<modx> vb;
+    for (int i = 0; i < 1000; i++) {
+        vx.push_back(int64_t(i) * 997651 % (p - 1));
+        vb.push_back(powT(modx(3, p), vx.back()));
+    }
+    EXPECT_EQ(vx, table.log_batch(vb.begin(), vb.end(), exec));
+    EXPECT_EQ(vx[123], table.log(vb[123], exec));
+    // 9 generates the subgroup of the quadratic residues
+    discrete_log_table<modx, int64_t> table9(modx(9, p), p - 1, n_factors);
+    EXPECT_EQ((p - 1) / 2, table9.order());
+    EXPECT_EQ(-1, table9.log(modx(3, p)));
+    EXPECT_EQ(2, table9.log(modx(81, p)));
+}
+
+TEST(modulos_test, discrete_log_table_perf) {
+    return; // skip perf tests by default
+    typedef moduloX<int64_t> modx;
+    int64_t p = 1000000007, k = 10000; // p - 1 = 2 * 500000003
+    vector<int64_t> n_factors{ 2, 500000003 };
+    modx g(5, p);
+    vector<modx> vb;
+    for (int i = 0; i < k; i++) vb.push_back(powT(g, int64_t(i) * 7919 + 1));
+    altruct::concurrency::parallel_range_executor exec(4);
+    auto T0 = clock();
+    int64_t r = 0;
+    for (int i = 0; i < 100; i++) r += discrete_log_g(g, vb[i], p - 1, n_factors);
+    auto T1 = clock();
+    discrete_log_table<modx, int64_t> table(g, p - 1, n_factors, k);
+    for (const auto& b : vb) r += table.log(b);
+    auto T2 = clock();
+    for (auto x : table.log_batch(vb.begin(), vb.end(), exec)) r += x;
+    auto T3 = clock();
+    printf("per query: discrete_log_g: %0.3lf ms, shared table with build: %0.3lf ms, parallel batch: %0.3lf ms    %d\n",
+        double(T1 - T0) / CLOCKS_PER_SEC * 10, double(T2 - T1) / CLOCKS_PER_SEC / k * 1000, double(T3 - T2) / CLOCKS_PER_SEC / k * 1000, int(r & 1));
+}
+
 TEST(modulos_test, discrete_log_brute_force) {
     for (int m = 2; m < 100; m++) {
         for (int a = 1; a < m; a++) {
@@ -1,5 +1,6 @@
 #include "altruct/algorithm/math/polynoms.h"
 #include "altruct/structure/math/fraction.h"
+#include "altruct/structure/math/modulo.h"
 
 #include "gtest/gtest.h"
 
@@ -43,3 +44,25 @@ TEST(polynoms_test, polynom_sum) {
     EXPECT_EQ((polynom<frac>{0, 1, 3, 2} / frac(6)), polynom_sum(polynom<frac>{ 0, 0, 1 }));
     EXPECT_EQ((polynom<frac>{0, 19, 15, 14} / frac(6)), polynom_sum(polynom<frac>{ 3, -2, 7 }));
 }
+
+TEST(polynoms_test, resultant) {
+    typedef modulo<int, 1000000007> mod;
+    typedef polynom<mod> poly;
+    EXPECT_EQ(mod(3), resultant(poly{ -1, 0, 1 }, poly{ -2, 1 }));
+    EXPECT_EQ(mod(3), resultant(poly{ -2, 1 }, poly{ -1, 0, 1 }));
+    EXPECT_EQ(mod(1), resultant(poly{ 0, 1 }, poly{ 1, 0, 0, 1 }));
+    EXPECT_EQ(mod(1), resultant(poly{ 0, 0, 0, 1 }, poly{ 1, 1 }));
+    EXPECT_EQ(mod(0), resultant(poly{ -1, 0, 1 }, poly{ -1, 1 }));
+    EXPECT_EQ(mod(0), resultant(poly{ -1, 0, 1 }, poly{}));
+    EXPECT_EQ(mod(8), resultant(poly{ 2 }, poly{ 1, 2, 3, 4 }));
+    EXPECT_EQ(mod(2), resultant(poly{ 1, 2 }, poly{ 3, 4 }));
+    // res(p, q) = lc(q)^deg(p) * prod{p(b_i)} over the roots `b_i` of `q`
+    poly p, q{ 1 };
+    for (int i = 0; i < 300; i++) p[i] = mod(i * i + 7);
+    for (int i = 0; i < 250; i++) q *= poly{ -mod(i * 3 + 1), 1 };
+    mod r = 1;
+    for (int i = 0; i < 250; i++) r *= p(mod(i * 3 + 1));
+    if (p.deg() % 2 == 1 && q.deg() % 2 == 1) r = -r;
+    EXPECT_EQ(r, resultant(p, q));
+    EXPECT_EQ(r * powT(mod(2), p.deg()), resultant(p, q * mod(2)));
+}
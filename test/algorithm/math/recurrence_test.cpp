@@ -1,5 +1,8 @@
 #include "altruct/algorithm/math/recurrence.h"
+#include "altruct/algorithm/math/polynom_mod.h"
+#include "altruct/algorithm/random/xorshift.h"
 #include "altruct/structure/math/matrix.h"
+#include "altruct/chrono/chrono.h"
 
 #include "gtest/gtest.h"
 
@@ -10,6 +13,19 @@ typedef long long ll;
 typedef modulo<int, 1000000007> mod;
 typedef matrix<int> mat;
 
+namespace {
+// random recurrence of order L, and its first `2 * L` terms
+std::vector<mod> random_recurrence(int L, polynom<mod>& p) {
+    altruct::random::xorshift_64star rng(L);
+    std::vector<mod> f_coeff, a;
+    for (int i = 0; i < L; i++) f_coeff.push_back(int(rng.next() % 1000000007));
+    for (int i = 0; i < L; i++) a.push_back(int(rng.next() % 1000000007));
+    while ((int)a.size() < 2 * L) a.push_back(linear_recurrence_next(f_coeff, a));
+    p = linear_recurrence_coeff_to_poly(f_coeff);
+    return a;
+}
+}
+
 TEST(recurrence_test, linear_recurrence_poly_coeff) {
     EXPECT_EQ((vector<int>{2}), linear_recurrence_poly_to_coeff(polynom<int>{-2, 1}));
     EXPECT_EQ((polynom<int>{-2, 1}), linear_recurrence_coeff_to_poly(vector<int>{2}));
@@ -130,3 +146,40 @@ TEST(recurrence_test, berlekamp_massey) {
     }
     EXPECT_EQ(a[100], r);
 }
+
+TEST(recurrence_test, berlekamp_massey_half_gcd) {
+    for (int L : { 1, 2, 5, 50, 100, 300, 1000 }) {
+        polynom<mod> p;
+        auto a = random_recurrence(L, p);
+        EXPECT_EQ(p, berlekamp_massey_poly_half_gcd<mod>(a)) << " L: " << L;
+        if (L <= 300) EXPECT_EQ(p, berlekamp_massey_poly_long<mod>(a)) << " L: " << L;
+        EXPECT_EQ(p, berlekamp_massey_poly<mod>(a)) << " L: " << L;
+    }
+    // sequence of a lower order than the available terms suggest
+    std::vector<mod> a;
+    for (int n = 0; n < 1000; n++) {
+        a.push_back(linear_recurrence<mod, mod>({ 17, -23, 13, 45, -58 }, { 2, 3, 5, 7, 11 }, n));
+    }
+    EXPECT_EQ((polynom<mod> { +58, -45, -13, +23, -17, 1 }), berlekamp_massey_poly_half_gcd<mod>(a));
+}
+
+TEST(recurrence_test, berlekamp_massey_perf) {
+    return; // do not test perf by default
+    using clk = altruct::chrono::rdtsc_clock<>;
+    for (int L = 250; L <= 100000; L *= 2) {
+        polynom<mod> p;
+        auto a = random_recurrence(L, p);
+        auto T0 = clk::now();
+        auto p1 = berlekamp_massey_poly_half_gcd<mod>(a);
+        double t1 = since(T0);
+        double t2 = 0;
+        if (L <= 16000) {
+            T0 = clk::now();
+            auto p2 = berlekamp_massey_poly_long<mod>(a);
+            t2 = since(T0);
+            EXPECT_EQ(p2, p1);
+        }
+        EXPECT_EQ(p, p1);
+        cout << "L: " << L << " half_gcd: " << t1 << " sec, long: " << t2 << " sec" << endl;
+    }
+}
@@ -0,0 +1,108 @@
+#include "altruct/algorithm/random/jump_ahead.h"
+#include "altruct/algorithm/math/recurrence.h"
+#include "altruct/structure/math/galois_field_2.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::math;
+using namespace altruct::random;
+
+namespace {
+gf2_poly to_gf2_poly(const vector<int>& coeffs) {
+    gf2_poly p;
+    for (int i = 0; i < int(coeffs.size()); i++) {
+        if (size_t(i >> 6) >= p.size()) p.resize((i >> 6) + 1);
+        if (coeffs[i]) p[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    return p;
+}
+
+vector<uint8_t> lfsr_sequence(const gf2_poly& p, const vector<uint8_t>& init, int n) {
+    int d = gf2_degree(p);
+    vector<uint8_t> s(init);
+    while (int(s.size()) < n) {
+        // x^d = sum_{i<d} p_i x^i
+        uint8_t b = 0;
+        for (int i = 0; i < d; i++) b ^= gf2_coeff(p, i) & s[s.size() - d + i];
+        s.push_back(b);
+    }
+    return s;
+}
+
+gf2_poly random_gf2_poly(int d, unsigned seed) {
+    srand(seed);
+    vector<int> c(d + 1);
+    for (int i = 0; i < d; i++) c[i] = rand() % 2;
+    c[0] = c[d] = 1;
+    return to_gf2_poly(c);
+}
+}
+
+TEST(jump_ahead_test, gf2_degree) {
+    EXPECT_EQ(-1, gf2_degree(gf2_poly{}));
+    EXPECT_EQ(-1, gf2_degree(gf2_poly{ 0, 0 }));
+    EXPECT_EQ(0, gf2_degree(gf2_poly{ 1 }));
+    EXPECT_EQ(63, gf2_degree(gf2_poly{ 1ULL << 63, 0 }));
+    EXPECT_EQ(64, gf2_degree(gf2_poly{ 5, 1 }));
+    EXPECT_TRUE(gf2_coeff(gf2_poly{ 5, 1 }, 2));
+    EXPECT_FALSE(gf2_coeff(gf2_poly{ 5, 1 }, 1));
+    EXPECT_FALSE(gf2_coeff(gf2_poly{ 5, 1 }, 1000));
+}
+
+TEST(jump_ahead_test, gf2_minimal_polynomial) {
+    // x^5 + x^2 + 1
+    gf2_poly p = to_gf2_poly({ 1, 0, 1, 0, 0, 1 });
+    EXPECT_EQ(p, gf2_minimal_polynomial(lfsr_sequence(p, { 1, 0, 0, 0, 0 }, 20)));
+    EXPECT_EQ(gf2_poly{ 1 }, gf2_minimal_polynomial(vector<uint8_t>(20, 0)));
+    EXPECT_EQ(to_gf2_poly({ 1, 1 }), gf2_minimal_polynomial(vector<uint8_t>(20, 1)));
+    for (int d : { 1, 10, 63, 64, 65, 200 }) {
+        gf2_poly p = random_gf2_poly(d, d);
+        vector<uint8_t> init(d);
+        init[d - 1] = 1;
+        auto s = lfsr_sequence(p, init, 2 * d + 10);
+        EXPECT_EQ(p, gf2_minimal_polynomial(s)) << d;
+        // the same as over `polynom<galois_field_2<>>`, with 0 and ~0 for the bits
+        typedef galois_field_2<uint8_t> gf2;
+        vector<gf2> a;
+        for (auto b : s) a.push_back(gf2(b ? 0xFF : 0));
+        auto q = berlekamp_massey_poly_long<gf2>(a, gf2(0xFF));
+        vector<int> c;
+        for (int i = 0; i <= q.deg(); i++) c.push_back(q[i].v ? 1 : 0);
+        EXPECT_EQ(p, to_gf2_poly(c)) << d;
+    }
+}
+
+TEST(jump_ahead_test, gf2_poly_modulus) {
+    for (int d : { 1, 5, 63, 64, 65, 130 }) {
+        gf2_poly q = random_gf2_poly(d, d + 1000);
+        gf2_poly_modulus m(q);
+        EXPECT_EQ(d, m.degree());
+        EXPECT_EQ(size_t(d / 64 + 1), m.words());
+        // x^n by repeated multiplication by x
+        gf2_poly r(m.words());
+        r[0] = 1;
+        m.reduce(r);
+        for (uint64_t n = 0; n < 300; n++) {
+            EXPECT_EQ(r, m.x_pow(n)) << d << " " << n;
+            EXPECT_EQ(m.sqr(r), m.x_pow(2 * n)) << d << " " << n;
+            r = m.mul_x(r);
+        }
+        for (int e = 0; e < 64; e++) {
+            EXPECT_EQ(m.x_pow(uint64_t(1) << e), m.x_pow2(e)) << d << " " << e;
+        }
+        // the sequence x^n (mod q) is periodic with the same period as the recurrence
+        vector<uint8_t> init(d);
+        init[d - 1] = 1;
+        auto s = lfsr_sequence(q, init, 1000);
+        for (uint64_t n : { 0, 1, 17, 500 }) {
+            // s[n + i] = sum_j (x^n mod q)_j s[j + i]
+            gf2_poly xn = m.x_pow(n);
+            uint8_t b = 0;
+            for (int j = 0; j < d; j++) b ^= gf2_coeff(xn, j) & s[j + 3];
+            EXPECT_EQ(s[n + 3], b) << d << " " << n;
+        }
+    }
+}
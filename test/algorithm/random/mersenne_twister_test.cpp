@@ -0,0 +1,43 @@
+#include "altruct/algorithm/random/mersenne_twister.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::random;
+
+TEST(mersenne_twister_test, mt19937) {
+    mtrand rng(5489);
+    std::mt19937 ref(5489);
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(ref(), rng.randInt());
+    }
+}
+
+TEST(mersenne_twister_test, jump) {
+    EXPECT_EQ(19938, gf2_degree(mtrand::characteristicPolynomial()));
+    for (uint64_t n : { 0, 1, 623, 624, 625, 5000, 100000 }) {
+        for (int skip : { 0, 1, 700 }) {
+            mtrand rng0(777), rng(777);
+            for (int k = 0; k < skip; k++) rng0.randInt(), rng.randInt();
+            for (uint64_t i = 0; i < n; i++) rng0.randInt();
+            rng.jump(mtrand::jumpPolynomial(n));
+            for (int i = 0; i < 1000; i++) {
+                EXPECT_EQ(rng0.randInt(), rng.randInt()) << n << " " << skip;
+            }
+        }
+    }
+    // past the stepping threshold of `discard`
+    uint64_t n = (uint64_t(1) << 24) + 3;
+    mtrand rng0(5), rng(5);
+    for (uint64_t i = 0; i < n; i++) rng0.randInt();
+    rng.discard(n);
+    EXPECT_EQ(rng0.randInt(), rng.randInt());
+    // 2^e steps by squaring, and by the binary powering
+    mtrand rng1(9), rng2(9);
+    rng1.jump(mtrand::jumpPolynomialPow2(40));
+    rng2.discard(uint64_t(1) << 40);
+    EXPECT_EQ(rng1.randInt(), rng2.randInt());
+}
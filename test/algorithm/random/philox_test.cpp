@@ -0,0 +1,75 @@
+#include "altruct/algorithm/random/philox.h"
+#include "altruct/concurrency/concurrency.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::random;
+
+TEST(philox_4x32_test, block) {
+    // known answers from the reference implementation
+    uint32_t c1[4] = { 0, 0, 0, 0 }, k1[2] = { 0, 0 };
+    philox_4x32::block(c1, k1);
+    EXPECT_EQ((vector<uint32_t>{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }), vector<uint32_t>(c1, c1 + 4));
+    uint32_t c2[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, k2[2] = { 0xffffffff, 0xffffffff };
+    philox_4x32::block(c2, k2);
+    EXPECT_EQ((vector<uint32_t>{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }), vector<uint32_t>(c2, c2 + 4));
+    uint32_t c3[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, k3[2] = { 0xa4093822, 0x299f31d0 };
+    philox_4x32::block(c3, k3);
+    EXPECT_EQ((vector<uint32_t>{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }), vector<uint32_t>(c3, c3 + 4));
+}
+
+TEST(philox_4x32_test, next) {
+    philox_4x32 rng;
+    EXPECT_EQ(0xe169c58d6627e8d5ULL, rng.next());
+    EXPECT_EQ(0x9b00dbd8bc57ac4cULL, rng.next());
+    EXPECT_EQ(2, rng.tell());
+    EXPECT_NE(philox_4x32(1).next(), philox_4x32(2).next());
+    EXPECT_NE(philox_4x32(1, 0).next(), philox_4x32(1, 1).next());
+}
+
+TEST(philox_4x32_test, seek) {
+    philox_4x32 rng0(12345, 7), rng(12345, 7);
+    vector<uint64_t> v(100);
+    for (auto& x : v) x = rng0.next();
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(v[i], rng.at(i));
+    }
+    for (int i : { 0, 1, 2, 5, 50, 99, 3 }) {
+        rng.seek(i);
+        EXPECT_EQ(v[i], rng.next());
+    }
+    rng.seek(10);
+    rng.discard(7);
+    EXPECT_EQ(17, rng.tell());
+    EXPECT_EQ(v[17], rng.next());
+    EXPECT_EQ(v[18], rng.next());
+}
+
+TEST(philox_4x32_test, parallel) {
+    // the same values regardless of the number of threads
+    const int n = 100000;
+    vector<uint64_t> expected(n);
+    philox_4x32(3).fill(expected.data(), n);
+    for (int threads : { 1, 2, 3, 8 }) {
+        vector<uint64_t> v(n);
+        altruct::concurrency::parallel_for_range(0, n, [&](int i0, int i1) {
+            philox_4x32 rng(3);
+            rng.seek(i0);
+            rng.fill(v.data() + i0, i1 - i0);
+        }, threads);
+        EXPECT_EQ(expected, v) << threads;
+    }
+}
+
+TEST(philox_4x32_test, Cpp17_UniformRandomBitGenerator) {
+    philox_4x32 rng(1);
+    vector<int> v{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    std::shuffle(v.begin(), v.end(), rng);
+    vector<int> s(v);
+    sort(s.begin(), s.end());
+    EXPECT_EQ((vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }), s);
+}
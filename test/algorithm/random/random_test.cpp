@@ -1,13 +1,27 @@
 #include "altruct/algorithm/random/random.h"
+#include "altruct/algorithm/random/mersenne_twister.h"
+#include "altruct/algorithm/random/philox.h"
+#include "altruct/algorithm/random/xorshift.h"
 
 #include <algorithm>
+#include <ctime>
 #include <map>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 using namespace altruct::random;
 
+namespace {
+    // the per-call generation, as mtrand has its own names for it
+    template<typename RNG> auto next_word(RNG& rng) -> decltype(rng.next()) { return rng.next(); }
+    uint32_t next_word(mtrand& rng) { return rng.randInt(); }
+    template<typename RNG> double next_0_1(RNG& rng) { return rng.next_0_1(); }
+    double next_0_1(mtrand& rng) { return rng.rand(); }
+}
+
 TEST(random_test, integer_to_double_0_1) {
     double eps = 1e-14;
     // 0 inclusive, 1 inclusive, 32bit
@@ -83,3 +97,68 @@ TEST(random_test, uniform_next) {
         EXPECT_EQ(10, entry.second);
     }
 }
+
+TEST(random_test, fill_0_1) {
+    uint32_t next = 0xFFFFFFF0U;
+    auto fill = [&](uint32_t* buf, size_t k) { for (size_t j = 0; j < k; j++) buf[j] = next++; };
+    std::vector<double> d(100);
+    fill_0_1<uint32_t>(d.data(), d.size(), fill);
+    for (size_t i = 0; i < d.size(); i++) {
+        EXPECT_EQ(integer_to_double_0_1<uint32_t>(uint32_t(0xFFFFFFF0U + i)), d[i]);
+    }
+}
+
+template<typename RNG>
+class random_fill_test : public ::testing::Test {};
+typedef ::testing::Types<xorshift_64star, xorshift_1024star, mtrand, philox_4x32> generators;
+TYPED_TEST_CASE(random_fill_test, generators);
+
+TYPED_TEST(random_fill_test, fill) {
+    typedef decltype(next_word(std::declval<TypeParam&>())) word_t;
+    // around the block sizes of the generators: 2, 16 and 624 words, and the 64 doubles of `fill_0_1`
+    for (size_t n : { 0, 1, 2, 3, 15, 16, 17, 33, 63, 64, 65, 623, 624, 625, 2000 }) {
+        // a few unaligned starting positions in the state
+        for (int skip : { 0, 1, 7, 100 }) {
+            TypeParam rng0(12345), rng(12345);
+            for (int k = 0; k < skip; k++) {
+                next_word(rng0), next_word(rng);
+            }
+            std::vector<word_t> v(n);
+            rng.fill(v.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_EQ(next_word(rng0), v[i]);
+            }
+            EXPECT_EQ(next_word(rng0), next_word(rng));
+            std::vector<double> d(n);
+            rng.fill_0_1(d.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_EQ(next_0_1(rng0), d[i]);
+            }
+            EXPECT_EQ(next_word(rng0), next_word(rng));
+        }
+    }
+}
+
+TYPED_TEST(random_fill_test, fill_perf) {
+    return; // skip perf tests by default
+    typedef decltype(next_word(std::declval<TypeParam&>())) word_t;
+    const size_t n = 1 << 16;
+    const int rounds = 1000;
+    std::vector<word_t> v(n);
+    TypeParam rng1(1), rng2(1);
+    uint64_t s1 = 0, s2 = 0;
+    auto T0 = clock();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) v[i] = next_word(rng1);
+        s1 += v[r];
+    }
+    double dT1 = double(clock() - T0) / CLOCKS_PER_SEC;
+    T0 = clock();
+    for (int r = 0; r < rounds; r++) {
+        rng2.fill(v.data(), n);
+        s2 += v[r];
+    }
+    double dT2 = double(clock() - T0) / CLOCKS_PER_SEC;
+    EXPECT_EQ(s1, s2);
+    printf("%s: next: %.3f s, fill: %.3f s (%d x %d values)\n", ::testing::UnitTest::GetInstance()->current_test_info()->type_param(), dT1, dT2, rounds, int(n));
+}
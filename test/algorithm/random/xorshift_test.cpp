@@ -258,3 +258,55 @@ TEST(xorshift_64star_test, Cpp17_UniformRandomBitGenerator) {
     std::shuffle(v.begin(), v.end(), rng);
     EXPECT_EQ((vector<int>{ 4, 7, 2, 1, 3, 5, 6, 8, 9, 0 }), v);
 }
+
+TEST(xorshift_64star_test, discard) {
+    EXPECT_EQ(64, gf2_degree(xorshift_64star::characteristic_polynomial()));
+    for (uint64_t n : { 0, 1, 2, 63, 64, 65, 1000, 12345 }) {
+        xorshift_64star rng0(kTest64_1_seed), rng(kTest64_1_seed);
+        for (uint64_t i = 0; i < n; i++) rng0.next();
+        rng.discard(n);
+        EXPECT_EQ(rng0.next(), rng.next()) << n;
+    }
+    // streams `n` values apart
+    xorshift_64star rng0(kTest64_2_seed), rng(kTest64_2_seed);
+    auto r = xorshift_64star::jump_polynomial(1000);
+    for (int k = 0; k < 3; k++) {
+        rng.jump(r);
+        for (int i = 0; i < 1000; i++) rng0.next();
+        EXPECT_EQ(rng0.next(), rng.next());
+        rng0.discard(uint64_t(-1)); // the period is 2^64 - 1
+    }
+    xorshift_64star rng1(kTest64_2_seed), rng2(kTest64_2_seed);
+    rng1.jump(xorshift_64star::jump_polynomial_pow2(40));
+    rng2.discard(uint64_t(1) << 40);
+    EXPECT_EQ(rng1.next(), rng2.next());
+}
+
+TEST(xorshift_1024star_test, discard) {
+    EXPECT_EQ(1024, gf2_degree(xorshift_1024star::characteristic_polynomial()));
+    for (uint64_t n : { 0, 1, 2, 15, 16, 17, 1023, 1024, 1025, 12345 }) {
+        for (int skip = 0; skip < 2; skip++) {
+            xorshift_1024star rng0(kTest1024_2_seed), rng(kTest1024_2_seed);
+            for (int k = 0; k < skip * 5; k++) rng0.next(), rng.next();
+            for (uint64_t i = 0; i < n; i++) rng0.next();
+            rng.discard(n);
+            for (int i = 0; i < 20; i++) {
+                EXPECT_EQ(rng0.next(), rng.next()) << n;
+            }
+        }
+    }
+    // 2^e steps by squaring, and by the binary powering
+    for (int e : { 0, 5, 20, 63 }) {
+        xorshift_1024star rng1(kTest1024_1_seed), rng2(kTest1024_1_seed);
+        rng1.jump(xorshift_1024star::jump_polynomial_pow2(e));
+        rng2.discard(uint64_t(1) << e);
+        EXPECT_EQ(rng1.next(), rng2.next()) << e;
+    }
+    // 2^512 is the standard jump; two jumps of 2^511 make one
+    xorshift_1024star rng1(kTest1024_1_seed), rng2(kTest1024_1_seed);
+    rng1.jump(xorshift_1024star::jump_polynomial_pow2(512));
+    auto r = xorshift_1024star::jump_polynomial_pow2(511);
+    rng2.jump(r);
+    rng2.jump(r);
+    EXPECT_EQ(rng1.next(), rng2.next());
+}
@@ -1,6 +1,9 @@
 ﻿#include "altruct/concurrency/concurrency.h"
 #include "altruct/algorithm/math/primes.h"
 #include "altruct/algorithm/math/reduce.h"
+#include "altruct/structure/math/matrix.h"
+#include "altruct/structure/math/modulo.h"
+#include "altruct/structure/container/segment_tree.h"
 
 #include "gtest/gtest.h"
 
@@ -50,4 +53,39 @@ TEST(concurrency_test, parallel_execute) {
     pi_worker_provider wp(N + 1);
     parallel_execute(rc, jp, wp, 4);
     EXPECT_EQ(1230, rc.result); // pi(10007) = 1230
-}
\ No newline at end of file
+}
+
+TEST(concurrency_test, parallel_for_range) {
+    vector<int> v(1000), c(1000);
+    parallel_for_range(0, 1000, [&](int b, int e) {
+        for (int i = b; i < e; i++) v[i] = i * i, c[i]++;
+    }, 4);
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(i * i, v[i]);
+        EXPECT_EQ(1, c[i]);
+    }
+}
+
+TEST(concurrency_test, parallel_range_executor) {
+    typedef altruct::math::modulo<int, 1000000007> mod;
+    int n = 200;
+    altruct::math::matrix<mod> m(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            m[i][j] = (i * 37 + j * j * 101 + 7) % 1009;
+        }
+    }
+    parallel_range_executor exec(4);
+    EXPECT_EQ(m.det(), m.det(exec));
+    EXPECT_EQ(m.rank(), m.rank(exec));
+    EXPECT_EQ(m.inverse(), m.inverse(exec));
+    EXPECT_EQ(m.solve(m), m.solve(m, exec));
+
+    auto f = [](int a, int b){ return a + b; };
+    altruct::container::segment_tree<int> st1(1000, f), st2(1000, f);
+    vector<pair<int, int>> ops;
+    for (int i = 0; i < 3000; i++) ops.push_back({ i * i % 1000, i });
+    for (const auto& op : ops) st1.set(op.first, op.second);
+    st2.set_many(ops.begin(), ops.end(), exec);
+    EXPECT_EQ(st1.v, st2.v);
+}
@@ -0,0 +1,159 @@
+#include "altruct/structure/container/aho_corasick_trie.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/io/reader.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+using namespace altruct::io;
+
+namespace {
+    typedef compact_aho_corasick_trie<> compact_trie;
+    typedef vector<pair<size_t, int>> matches_t;
+
+    // the number of occurrences of all the patterns, counting the duplicate patterns separately
+    int64_t naive_count(const string& s, const vector<string>& patterns) {
+        int64_t r = 0;
+        for (const auto& p : patterns) {
+            for (size_t i = 0; i + p.size() <= s.size(); i++) {
+                if (s.compare(i, p.size(), p) == 0) r++;
+            }
+        }
+        return r;
+    }
+
+    // the end position and the node of each occurrence of each distinct pattern
+    matches_t naive_matches(const compact_trie& t, const string& s, const vector<string>& patterns) {
+        matches_t r;
+        for (size_t j = 0; j < patterns.size(); j++) {
+            const auto& p = patterns[j];
+            for (size_t i = 0; i + p.size() <= s.size(); i++) {
+                if (s.compare(i, p.size(), p) == 0) r.push_back({ i + p.size(), t.pattern_node(int(j)) });
+            }
+        }
+        sort(r.begin(), r.end());
+        r.erase(unique(r.begin(), r.end()), r.end());
+        return r;
+    }
+
+    compact_trie make_compact_trie(const vector<string>& patterns) {
+        compact_trie t;
+        for (size_t j = 0; j < patterns.size(); j++) {
+            EXPECT_EQ(int(j), t.insert(patterns[j].begin(), patterns[j].end()));
+        }
+        t.build();
+        return t;
+    }
+
+    string random_string(altruct::random::xorshift_64star& rng, int len, const string& alphabet) {
+        string s(len, 0);
+        for (auto& c : s) c = alphabet[rng.next() % alphabet.size()];
+        return s;
+    }
+
+    vector<string> random_patterns(altruct::random::xorshift_64star& rng, int cnt, int max_len, const string& alphabet) {
+        vector<string> patterns;
+        for (int j = 0; j < cnt; j++) {
+            patterns.push_back(random_string(rng, 1 + int(rng.next() % max_len), alphabet));
+        }
+        return patterns;
+    }
+}
+
+TEST(aho_corasick_trie_test, count_matches) {
+    vector<string> patterns{ "he", "she", "his", "hers", "e", "she" };
+    aho_corasick_trie<26> t;
+    for (const auto& p : patterns) t.insert(p.begin(), p.end(), [](char c){ return c - 'a'; });
+    t.build();
+    altruct::random::xorshift_64star rng(1);
+    for (string s : { string(""), string("ushers"), string("hishershe"), random_string(rng, 1000, "ehrsiu") }) {
+        EXPECT_EQ(naive_count(s, patterns), t.count_matches(s.begin(), s.end(), [](char c){ return c - 'a'; })) << s;
+    }
+}
+
+TEST(aho_corasick_trie_test, dense_alphabets) {
+    // the letters of the 128 and the 256 letter alphabets do not fit into a signed `char` loop counter
+    altruct::random::xorshift_64star rng(2);
+    string bytes; for (int c = 0; c < 256; c++) bytes += char(c);
+    vector<string> patterns = random_patterns(rng, 30, 3, bytes.substr(0, 4) + bytes.substr(250));
+    string s = random_string(rng, 5000, bytes.substr(0, 4) + bytes.substr(250));
+    aho_corasick_trie<256, int, uint8_t> t256;
+    for (const auto& p : patterns) t256.insert(p.begin(), p.end());
+    t256.build();
+    EXPECT_EQ(naive_count(s, patterns), t256.count_matches(s.begin(), s.end()));
+
+    vector<string> patterns7 = random_patterns(rng, 30, 3, "abc\x7F");
+    string s7 = random_string(rng, 5000, "abc\x7F");
+    aho_corasick_trie<128, int, char> t128;
+    for (const auto& p : patterns7) t128.insert(p.begin(), p.end());
+    t128.build();
+    EXPECT_EQ(naive_count(s7, patterns7), t128.count_matches(s7.begin(), s7.end()));
+}
+
+TEST(aho_corasick_trie_test, compact) {
+    altruct::random::xorshift_64star rng(3);
+    string bytes; for (int c = 0; c < 256; c++) bytes += char(c);
+    for (string alphabet : { string("ab"), string("abcd"), string("a\x80\xFF"), bytes }) {
+        // many patterns, so that the insertion trie gets reallocated while being inserted into
+        vector<string> patterns = random_patterns(rng, 200, 6, alphabet);
+        patterns.push_back(patterns[0]); // a duplicate
+        compact_trie t = make_compact_trie(patterns);
+        EXPECT_EQ(t.pattern_node(0), t.pattern_node(int(patterns.size()) - 1));
+        for (int j = 0; j < (int)patterns.size(); j++) {
+            EXPECT_EQ(int(patterns[j].size()), t.depth(t.pattern_node(j)));
+            EXPECT_TRUE(t.is_word(t.pattern_node(j)));
+        }
+        string s = random_string(rng, 3000, alphabet);
+        EXPECT_EQ(naive_count(s, patterns), t.count_matches(s.begin(), s.end()));
+        matches_t expected = naive_matches(t, s, patterns);
+        matches_t actual;
+        t.for_each_match(s.begin(), s.end(), [&](size_t pos, int node){ actual.push_back({ pos, node }); });
+        sort(actual.begin(), actual.end());
+        EXPECT_EQ(expected, actual);
+        // the same, fed in chunks
+        for (size_t chunk : { 1, 3, 7, 1000 }) {
+            matches_t chunked;
+            int state = t.root();
+            for (size_t i = 0; i < s.size(); i += chunk) {
+                size_t e = min(s.size(), i + chunk);
+                state = t.scan(state, s.begin() + i, s.begin() + e, [&](size_t pos, int node){ chunked.push_back({ pos, node }); }, i);
+            }
+            sort(chunked.begin(), chunked.end());
+            EXPECT_EQ(expected, chunked) << chunk;
+        }
+        // the same, from a reader, with buffers smaller than the patterns
+        for (size_t buffer_size : { 1, 5, 1 << 16 }) {
+            string_reader in1(s.data(), s.size());
+            EXPECT_EQ(naive_count(s, patterns), t.count_matches(in1, buffer_size));
+            string_reader in2(s.data(), s.size());
+            matches_t streamed;
+            t.for_each_match(in2, [&](size_t pos, int node){ streamed.push_back({ pos, node }); }, buffer_size);
+            sort(streamed.begin(), streamed.end());
+            EXPECT_EQ(expected, streamed) << buffer_size;
+        }
+    }
+}
+
+TEST(aho_corasick_trie_test, count_matches_interleaved) {
+    altruct::random::xorshift_64star rng(4);
+    vector<string> patterns = random_patterns(rng, 50, 4, "abc");
+    compact_trie t = make_compact_trie(patterns);
+    // more ranges than the lanes, of different lengths, including the empty ones
+    vector<string> texts;
+    for (int i = 0; i < 3 * compact_trie::LANES + 3; i++) {
+        texts.push_back(random_string(rng, int(rng.next() % 300) * (i % 5 != 0), "abc"));
+    }
+    vector<pair<string::const_iterator, string::const_iterator>> ranges;
+    for (const auto& s : texts) ranges.push_back({ s.cbegin(), s.cend() });
+    vector<int64_t> counts = t.count_matches_interleaved(ranges);
+    ASSERT_EQ(texts.size(), counts.size());
+    for (size_t i = 0; i < texts.size(); i++) {
+        EXPECT_EQ(naive_count(texts[i], patterns), counts[i]) << i;
+    }
+}
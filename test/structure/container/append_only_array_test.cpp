@@ -0,0 +1,66 @@
+#include "altruct/structure/container/append_only_array.h"
+#include "altruct/concurrency/concurrency.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+TEST(append_only_array_test, empty) {
+    append_only_array<int> a;
+    EXPECT_EQ(0, a.size());
+    EXPECT_EQ(0, a.capacity());
+}
+
+TEST(append_only_array_test, grow) {
+    append_only_array<int, 2> a;
+    a.reserve(5);
+    EXPECT_EQ(0, a.size());
+    EXPECT_EQ(12, a.capacity()); // chunks of 4 and 8
+    for (int i = 0; i < 5; i++) a[i] = i * i;
+    a.resize(5);
+    EXPECT_EQ(5, a.size());
+    const int* p3 = &a[3];
+    for (int n : { 11, 12, 13, 100, 1000 }) {
+        a.reserve(n);
+        for (int i = int(a.size()); i < n; i++) a[i] = i * i;
+        a.resize(n);
+        EXPECT_EQ(n, a.size());
+        EXPECT_GE(a.capacity(), size_t(n));
+        EXPECT_EQ(p3, &a[3]); // the elements never move
+    }
+    const append_only_array<int, 2>& ca = a;
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(i * i, ca[i]) << i;
+    }
+    // contiguous within a chunk
+    EXPECT_EQ(&ca[4] + 7, &ca[11]);
+    EXPECT_EQ(&ca[12] + 15, &ca[27]);
+}
+
+TEST(append_only_array_test, concurrent_readers) {
+    append_only_array<int64_t> a;
+    const int64_t N = 1 << 20;
+    atomic<int> failures(0);
+    thread writer([&] {
+        for (int64_t n = 1; n <= N; n += n / 3 + 1) {
+            a.reserve(n);
+            for (int64_t i = a.size(); i < n; i++) a[i] = i * 7 + 1;
+            a.resize(n);
+        }
+    });
+    altruct::concurrency::parallel_for_range(0, 4, [&](int, int) {
+        for (int r = 0; r < 1000; r++) {
+            size_t n = a.size();
+            for (size_t i = (n > 100) ? n - 100 : 0; i < n; i++) {
+                if (a[i] != int64_t(i) * 7 + 1) failures++;
+            }
+        }
+    }, 4);
+    writer.join();
+    EXPECT_EQ(0, failures.load());
+}
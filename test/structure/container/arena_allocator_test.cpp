@@ -0,0 +1,138 @@
+#include "altruct/structure/container/arena_allocator.h"
+#include "altruct/structure/container/treap.h"
+#include "altruct/structure/container/rope.h"
+#include "altruct/structure/container/link_cut_tree.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace altruct::container;
+
+TEST(arena_allocator_test, allocate) {
+    arena_allocator<string> alloc(2, 4);
+    vector<string*> v;
+    for (int i = 0; i < 10; i++) {
+        v.push_back(alloc.allocate(1));
+        alloc.construct(v.back(), to_string(i));
+    }
+    EXPECT_EQ(10, alloc.size());
+    EXPECT_EQ(10, alloc.capacity()); // 2 + 4 + 4
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(to_string(i), *v[i]);
+    }
+    // deallocated elements get recycled
+    string* p3 = v[3];
+    alloc.destroy(p3);
+    alloc.deallocate(p3, 1);
+    EXPECT_EQ(9, alloc.size());
+    EXPECT_EQ(p3, alloc.allocate(1));
+    EXPECT_EQ(10, alloc.size());
+    EXPECT_EQ(10, alloc.capacity());
+    alloc.construct(p3, "x");
+    EXPECT_EQ("x", *v[3]);
+    for (auto p : v) alloc.destroy(p);
+    alloc.release();
+    EXPECT_EQ(0, alloc.size());
+    EXPECT_EQ(0, alloc.capacity());
+    EXPECT_THROW(alloc.allocate(2), std::bad_alloc);
+}
+
+TEST(arena_allocator_test, copy) {
+    arena_allocator<int> a1;
+    arena_allocator<int> a2(a1);
+    arena_allocator<double> a3(a1);
+    arena_allocator<int> a4(a3);
+    EXPECT_TRUE(a1 == a2);
+    EXPECT_FALSE(a1 != a2);
+    // rebinding shares the arena
+    EXPECT_TRUE(a1 == a3);
+    EXPECT_FALSE(a1 != a3);
+    EXPECT_TRUE(a1 == a4);
+    EXPECT_TRUE(arena_allocator<int>() != a1);
+    int* p = a2.allocate(1);
+    EXPECT_EQ(1, a1.size());
+    a1.deallocate(p, 1);
+    EXPECT_EQ(0, a2.size());
+    // a different element type gets its own slots
+    double* d = a3.allocate(1);
+    *d = 2.5;
+    int* q = a4.allocate(1);
+    *q = 7;
+    EXPECT_EQ(1, a1.size());
+    EXPECT_EQ(1, a3.size());
+    EXPECT_EQ(2.5, *d);
+    arena_allocator<double>(a1).deallocate(d, 1);
+    EXPECT_EQ(0, a3.size());
+    a1.deallocate(q, 1);
+    // release returns the slabs of all the types
+    a3.allocate(1);
+    a1.release();
+    EXPECT_EQ(0, a1.capacity());
+    EXPECT_EQ(0, a3.capacity());
+}
+
+TEST(arena_allocator_test, containers) {
+    typedef arena_allocator<bst_node<int>> alloc_t;
+    alloc_t alloc;
+    set<int> s;
+    {
+        treap<int, int, bst_duplicate_handling::IGNORE, std::less<int>, bst_random, alloc_t> t(std::less<int>(), bst_random(), alloc);
+        altruct::random::xorshift_64star rng(12345);
+        for (int i = 0; i < 1000; i++) {
+            int k = int(rng.next() % 500);
+            if (rng.next() % 3) s.insert(k), t.insert(k);
+            else s.erase(k), t.erase(k);
+        }
+        EXPECT_EQ(vector<int>(s.begin(), s.end()), vector<int>(t.begin(), t.end()));
+        EXPECT_EQ(s.size() + 1, alloc.size()); // + nil
+        auto t2 = t;
+        EXPECT_EQ(vector<int>(s.begin(), s.end()), vector<int>(t2.begin(), t2.end()));
+        EXPECT_EQ(2 * s.size() + 2, alloc.size());
+    }
+    EXPECT_EQ(0, alloc.size());
+
+    rope<string, bst_random, arena_allocator<bst_node<string>>> r;
+    for (int i = 0; i < 100; i++) r.insert(r.begin() + i / 2, to_string(i));
+    EXPECT_EQ(100, r.size());
+    EXPECT_EQ("1", r[0]);
+    EXPECT_EQ("99", r[49]);
+    EXPECT_EQ("0", r[99]);
+
+    link_cut_tree<int, std::function<void(int&, const int&, const int&)>, arena_allocator<link_cut_node<int>>> lct(5, [](int& p, const int& l, const int& r){ p = l + r; });
+    lct.link(2, 1); lct.link(3, 2);
+    EXPECT_EQ(1, lct.find_root(3));
+}
+
+namespace {
+template<typename TREAP>
+double bench_treap(int n, int64_t& checksum) {
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    auto T0 = clk::now();
+    {
+        TREAP t;
+        for (int i = 0; i < n; i++) t.insert(int(rng.next() >> 1));
+        checksum += t.size();
+    }
+    return since(T0);
+}
+}
+
+TEST(arena_allocator_test, perf) {
+    return; // do not test perf by default
+    int n = 10000000;
+    int64_t c1 = 0, c2 = 0;
+    typedef treap<int, int, bst_duplicate_handling::IGNORE, std::less<int>, bst_random, std::allocator<bst_node<int>>> treap_std;
+    typedef treap<int, int, bst_duplicate_handling::IGNORE, std::less<int>, bst_random, arena_allocator<bst_node<int>>> treap_arena;
+    double t1 = bench_treap<treap_std>(n, c1);
+    double t2 = bench_treap<treap_arena>(n, c2);
+    EXPECT_EQ(c1, c2);
+    cout << "build and destroy " << n << " nodes: std::allocator " << t1 << " arena_allocator " << t2 << endl;
+}
@@ -339,6 +339,17 @@ TEST(binary_search_tree_test, root) {
     EXPECT_EQ(tc.find("aaa"), tc.root().left());
     EXPECT_EQ(tc.find("dddd"), tc.root().right());
     EXPECT_EQ(tc.end(), tc.root().parent());
+    EXPECT_FALSE(tc.root().is_nil());
+    EXPECT_TRUE(tc.end().is_nil());
+    // the leaves point to a nil shared between the trees, which is not `end()`
+    auto leaf = tc.find("b");
+    EXPECT_TRUE(leaf.left().is_nil());
+    EXPECT_TRUE(leaf.right().is_nil());
+    EXPECT_NE(tc.end(), leaf.left());
+    // and the iterators of different trees don't compare equal
+    binary_search_tree_dbg<string, string> tc2;
+    EXPECT_NE(tc.end(), tc2.end());
+    EXPECT_NE(tc.cend(), tc2.cend());
 }
 
 TEST(binary_search_tree_test, relational_operators) {
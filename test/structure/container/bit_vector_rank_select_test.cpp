@@ -0,0 +1,107 @@
+#include "altruct/structure/container/bit_vector_rank_select.h"
+#include "altruct/algorithm/random/xorshift.h"
+
+#include <ctime>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+namespace {
+    template<typename W>
+    void verify_rank_select(const bit_vector<W>& v) {
+        bit_vector_rank_select<W> rs(v);
+        vector<size_t> pos1, pos0;
+        size_t r = 0;
+        for (size_t i = 0; i < v.size(); i++) {
+            EXPECT_EQ(r, rs.rank1(i)) << i;
+            EXPECT_EQ(i - r, rs.rank0(i)) << i;
+            (v.bit_at(i) ? pos1 : pos0).push_back(i);
+            r += v.bit_at(i);
+        }
+        EXPECT_EQ(r, rs.rank1(v.size()));
+        EXPECT_EQ(pos1.size(), rs.count1());
+        EXPECT_EQ(pos0.size(), rs.count0());
+        for (size_t k = 0; k < pos1.size(); k++) {
+            EXPECT_EQ(pos1[k], rs.select1(k)) << k;
+        }
+        for (size_t k = 0; k < pos0.size(); k++) {
+            EXPECT_EQ(pos0[k], rs.select0(k)) << k;
+        }
+    }
+
+    template<typename W>
+    bit_vector<W> random_bit_vector(size_t n, int density, altruct::random::xorshift_64star& rng) {
+        bit_vector<W> v(n);
+        for (size_t i = 0; i < n; i++) {
+            v.set(i, (rng.next() % 100) < uint64_t(density));
+        }
+        return v;
+    }
+}
+
+TEST(bit_vector_rank_select_test, empty) {
+    bit_vector<> v;
+    bit_vector_rank_select<> rs(v);
+    EXPECT_EQ(0, rs.size());
+    EXPECT_EQ(0, rs.count1());
+    EXPECT_EQ(0, rs.rank1(0));
+    EXPECT_EQ(0, rs.rank0(0));
+}
+
+TEST(bit_vector_rank_select_test, small) {
+    bit_vector<> v{ 0, 1, 1, 0, 1, 0, 0, 0, 1 };
+    bit_vector_rank_select<> rs(v);
+    EXPECT_EQ(9, rs.size());
+    EXPECT_EQ(4, rs.count1());
+    EXPECT_EQ(5, rs.count0());
+    EXPECT_EQ(2, rs.rank1(4));
+    EXPECT_EQ(2, rs.rank0(4));
+    EXPECT_EQ(4, rs.rank1(9));
+    EXPECT_EQ(1, rs.select1(0));
+    EXPECT_EQ(8, rs.select1(3));
+    EXPECT_EQ(0, rs.select0(0));
+    EXPECT_EQ(7, rs.select0(4));
+    verify_rank_select(v);
+}
+
+TEST(bit_vector_rank_select_test, random) {
+    altruct::random::xorshift_64star rng(12345);
+    for (int density : { 0, 1, 10, 50, 90, 99, 100 }) {
+        verify_rank_select(random_bit_vector<uint64_t>(40000, density, rng));
+        verify_rank_select(random_bit_vector<uint32_t>(20000, density, rng));
+        verify_rank_select(random_bit_vector<uint8_t>(10000, density, rng));
+    }
+    for (size_t n : { 511, 512, 513, 2047, 2048, 2049, 8191, 8192, 8193 }) {
+        verify_rank_select(random_bit_vector<uint64_t>(n, 50, rng));
+    }
+}
+
+TEST(bit_vector_rank_select_test, clustered) {
+    // long runs of ones and zeros, so that select samples are far apart
+    bit_vector<> v(100000);
+    v.apply(3000, 4000, v.op_set1);
+    v.apply(50000, 50100, v.op_set1);
+    v.apply(70000, 95000, v.op_set1);
+    v.set(99999, 1);
+    verify_rank_select(v);
+}
+
+TEST(bit_vector_rank_select_test, perf) {
+    return; // skip perf tests by default
+    altruct::random::xorshift_64star rng(12345);
+    size_t n = size_t(1) << 28;
+    auto v = random_bit_vector<uint64_t>(n, 50, rng);
+    auto T0 = clock();
+    bit_vector_rank_select<> rs(v);
+    auto T1 = clock();
+    size_t r = 0;
+    for (int i = 0; i < 10000000; i++) r += rs.rank1(rng.next() % n);
+    auto T2 = clock();
+    for (int i = 0; i < 10000000; i++) r += rs.select1(rng.next() % rs.count1());
+    auto T3 = clock();
+    printf("build: %0.3lf s, rank: %0.3lf s, select: %0.3lf s    %d\n",
+        double(T1 - T0) / CLOCKS_PER_SEC, double(T2 - T1) / CLOCKS_PER_SEC, double(T3 - T2) / CLOCKS_PER_SEC, int(r & 1));
+}
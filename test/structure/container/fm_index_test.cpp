@@ -0,0 +1,109 @@
+#include "altruct/structure/container/fm_index.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/concurrency/concurrency.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+using namespace altruct::concurrency;
+
+namespace {
+    // the number of (possibly overlapping) occurrences; `n + 1` for the empty pattern
+    template<typename T>
+    int naive_count(const vector<T>& s, const vector<T>& p) {
+        int r = 0;
+        for (size_t i = 0; i + p.size() <= s.size(); i++) {
+            if (equal(p.begin(), p.end(), s.begin() + i)) r++;
+        }
+        return r;
+    }
+
+    template<typename T, typename EXEC>
+    void verify_counts(const vector<T>& s, const vector<T>& alphabet, const EXEC& exec) {
+        fm_index<T> fm(s.begin(), s.end(), exec);
+        int n = (int)s.size();
+        EXPECT_EQ(n, fm.size());
+        // empty pattern and the whole string
+        vector<T> e;
+        EXPECT_EQ(n + 1, fm.count(e.begin(), e.end()));
+        EXPECT_EQ(1, fm.count(s.begin(), s.end()));
+        // all the substrings up to the length 4
+        for (int i = 0; i < n; i++) {
+            for (int len = 1; len <= 4 && i + len <= n; len++) {
+                vector<T> p(s.begin() + i, s.begin() + i + len);
+                EXPECT_EQ(naive_count(s, p), fm.count(p.begin(), p.end()));
+            }
+        }
+        // all the patterns up to the length 3 over the alphabet, mostly absent ones
+        for (int len = 1; len <= 3; len++) {
+            vector<int> d(len);
+            for (;;) {
+                vector<T> p; for (int k : d) p.push_back(alphabet[k]);
+                EXPECT_EQ(naive_count(s, p), fm.count(p.begin(), p.end()));
+                int k = 0;
+                while (k < len && ++d[k] == (int)alphabet.size()) d[k++] = 0;
+                if (k == len) break;
+            }
+        }
+        // longer than the string
+        vector<T> l(s); l.push_back(s.empty() ? alphabet[0] : s[0]);
+        EXPECT_EQ(0, fm.count(l.begin(), l.end()));
+    }
+
+    template<typename EXEC>
+    void verify_strings(const EXEC& exec) {
+        string abc = "abcz";
+        vector<char> alphabet(abc.begin(), abc.end());
+        for (string s : { "", "a", "aaaa", "banana", "mississippi", "abracadabra", "abababab" }) {
+            verify_counts(vector<char>(s.begin(), s.end()), alphabet, exec);
+        }
+        altruct::random::xorshift_64star rng(12345);
+        for (int len : { 10, 100, 500 }) {
+            vector<char> s(len);
+            for (auto& c : s) c = char('a' + rng.next() % 3);
+            verify_counts(s, alphabet, exec);
+        }
+    }
+}
+
+TEST(fm_index_test, count) {
+    verify_strings(serial_range_executor());
+}
+
+TEST(fm_index_test, parallel) {
+    verify_strings(parallel_range_executor(4));
+}
+
+TEST(fm_index_test, signed_bytes) {
+    // the bytes >= 0x80 are negative chars, and sort before the others
+    vector<char> alphabet{ char(0x00), char(0x41), char(0x7F), char(0x80), char(0xC3), char(0xFF) };
+    altruct::random::xorshift_64star rng(1);
+    for (int len : { 1, 10, 300 }) {
+        vector<char> s(len);
+        for (auto& c : s) c = alphabet[rng.next() % 5]; // 0xFF stays absent
+        verify_counts(s, alphabet, serial_range_executor());
+    }
+    vector<char> all; for (int c = 0; c < 256; c++) all.push_back(char(c));
+    verify_counts(all, alphabet, serial_range_executor());
+}
+
+TEST(fm_index_test, int_alphabet) {
+    vector<int> alphabet{ -1000000, -3, 0, 5, 1000000 };
+    vector<int> s{ 5, -3, 5, 0, -3, 5, 0, 0, 5, -3, 1000000 };
+    verify_counts(s, alphabet, serial_range_executor());
+}
+
+TEST(fm_index_test, from_suffix_array) {
+    string s = "mississippi";
+    suffix_array<char> sa(s.begin(), s.end());
+    fm_index<char> fm(sa);
+    for (string p : { "i", "s", "ss", "issi", "ppi", "sip", "x", "mississippi" }) {
+        int r = 0;
+        for (size_t i = s.find(p); i != string::npos; i = s.find(p, i + 1)) r++;
+        EXPECT_EQ(r, fm.count(p.begin(), p.end())) << p;
+    }
+}
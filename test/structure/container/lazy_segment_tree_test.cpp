@@ -1,7 +1,12 @@
 #include "altruct/structure/container/lazy_segment_tree.h"
 
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
+
 #include "gtest/gtest.h"
 
+#include <iostream>
+
 using namespace std;
 using namespace altruct::container;
 
@@ -190,3 +195,86 @@ TEST(lazy_segment_tree_test, deep_modify) {
         { 1, 2, 0 }, { 1, -3, 0 }, { 1, 4, 0 }, { 1, 6, 0 }, { 1, 11, 0 }, { 1, 9, 8 }, { 1, 8, 8 }, { 1, 3, 8 }, { 1, 15, 8 }, { 1, 5, 8 }, { 1, 11, 8 }, { 1, 9, 8 }, { 1, 4, 8 }, { 1, 9, 8 }, { 1, 5, 0 }, { 1, 9, 0 }, { 1, -2, 0 }, { 1, 6, 0 }, { 1, -5, 0 }, { 1, 3, 0 }, { 1, 9, 8 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, };
     EXPECT_EQ(e3, st3.v);
 }
+
+TEST(lazy_segment_tree_test, update_many) {
+    vector<atom_sum> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3, 3, 1, -4, 1, 5, 9, -2, 6, -5, 3, 1 };
+    lazy_segment_tree<atom_sum> st(v.begin(), v.end(), atom_sum::resolve_up, atom_sum::resolve_down);
+    // leave some updates pending
+    st.update(3, 17, atom_sum::add_functor(10));
+    for (int i = 3; i < 17; i++) v[i].val += 10;
+    vector<pair<int, int>> ops{ { 6, 2 }, { 8, -7 }, { 0, 5 }, { 6, 3 }, { 20, 8 }, { 15, 1 } };
+    for (const auto& op : ops) v[op.first].val += op.second;
+    st.update_many(ops.begin(), ops.end(), [](atom_sum& t, int val){ t.add(val); });
+    verify_all(st, v, atom_sum::resolve_up);
+}
+
+TEST(lazy_segment_tree_test, get_many) {
+    vector<atom_sum> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3, 3, 1, -4, 1, 5, 9, -2, 6, -5, 3, 1 };
+    lazy_segment_tree<atom_sum> st(v.begin(), v.end(), atom_sum::resolve_up, atom_sum::resolve_down);
+    st.update(3, 17, atom_sum::add_functor(10));
+    st.update(0, 9, atom_sum::add_functor(-1));
+    for (int i = 3; i < 17; i++) v[i].val += 10;
+    for (int i = 0; i < 9; i++) v[i].val -= 1;
+    vector<pair<int, int>> queries;
+    for (int b = 0; b <= 21; b += 3) {
+        for (int e = b; e <= 21; e += 2) {
+            queries.push_back({ b, e });
+        }
+    }
+    auto r = st.get_many(queries.begin(), queries.end());
+    ASSERT_EQ(queries.size(), r.size());
+    for (size_t k = 0; k < queries.size(); k++) {
+        int b = queries[k].first, e = queries[k].second;
+        EXPECT_EQ(slow_get(v, b, e, atom_sum::resolve_up).val, r[k].val) << " unexpected result of get(" << b << ", " << e << ")";
+    }
+}
+
+TEST(lazy_segment_tree_test, make_lazy_segment_tree) {
+    vector<atom_sum> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3, 3, 1, -4, 1, 5, 9, -2, 6, -5, 3, 1 };
+    auto st = make_lazy_segment_tree(v.begin(), v.end(),
+        [](atom_sum& parent, const atom_sum& left, const atom_sum& right){ atom_sum::resolve_up(parent, left, right); },
+        [](atom_sum& parent, atom_sum& left, atom_sum& right){ atom_sum::resolve_down(parent, left, right); });
+    st.update(3, 17, [](atom_sum& t){ t.add(10); return true; });
+    for (int i = 3; i < 17; i++) v[i].val += 10;
+    for (size_t begin = 0; begin < v.size(); begin++) {
+        for (size_t end = begin; end < v.size(); end++) {
+            EXPECT_EQ(slow_get(v, begin, end, atom_sum::resolve_up).val, st.get(begin, end).val);
+        }
+    }
+}
+
+namespace {
+template<typename ST>
+double bench_lazy_segment_tree(ST& st, int n, int k, int64_t& checksum) {
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    auto T0 = clk::now();
+    for (int i = 0; i < k; i++) {
+        uint64_t r = rng.next();
+        int b = int(r % n), e = int((r >> 32) % n);
+        if (b > e) swap(b, e);
+        if (r & (1 << 20)) {
+            int val = int(r >> 60);
+            st.update(b, e + 1, [val](atom_sum& t){ t.add(val); return true; });
+        } else {
+            checksum += st.get(b, e + 1).val;
+        }
+    }
+    return since(T0);
+}
+}
+
+TEST(lazy_segment_tree_test, perf) {
+    return; // do not test perf by default
+    int n = 1 << 20, k = 10000000;
+    int64_t c1 = 0, c2 = 0;
+    vector<atom_sum> v(n, atom_sum(0));
+    lazy_segment_tree<atom_sum> st1(v.begin(), v.end(), atom_sum::resolve_up, atom_sum::resolve_down);
+    double t1 = bench_lazy_segment_tree(st1, n, k, c1);
+    auto st2 = make_lazy_segment_tree(v.begin(), v.end(),
+        [](atom_sum& parent, const atom_sum& left, const atom_sum& right){ atom_sum::resolve_up(parent, left, right); },
+        [](atom_sum& parent, atom_sum& left, atom_sum& right){ atom_sum::resolve_down(parent, left, right); });
+    double t2 = bench_lazy_segment_tree(st2, n, k, c2);
+    EXPECT_EQ(c1, c2);
+    cout << "std::function: " << t1 << " lambda: " << t2 << endl;
+}
@@ -0,0 +1,123 @@
+#include "altruct/structure/container/lazy_treap.h"
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+namespace {
+    // element with a key, a value, and the aggregated sum and count over its subtree;
+    // `add` is a pending addition to the values in the subtrees of the children
+    struct item {
+        int k = 0, cnt = 0;
+        long long v = 0, sum = 0, add = 0;
+        item() {}
+        item(int k, long long v) : k(k), cnt(1), v(v), sum(v) {}
+    };
+    struct item_cmp {
+        bool operator()(const item& a, const item& b) const { return a.k < b.k; }
+    };
+    void item_up(item& p, const item& l, const item& r) {
+        p.cnt = l.cnt + 1 + r.cnt;
+        p.sum = l.sum + p.v + r.sum;
+    }
+    void item_add(item& t, long long a) {
+        t.v += a, t.add += a, t.sum += a * t.cnt;
+    }
+    void item_down(item& p, item& l, item& r) {
+        if (p.add == 0) return;
+        item_add(l, p.add), item_add(r, p.add);
+        p.add = 0;
+    }
+    typedef lazy_treap<item, item_cmp> lazy_treap_t;
+
+    // returns the subtree size; verifies the aggregates, taking the pending additions into account
+    template<typename IT>
+    int verify_subtree(IT it, long long add, vector<pair<int, long long>>& out) {
+        if (it.is_nil()) return 0;
+        int cl = verify_subtree(it.left(), add + it->add, out);
+        out.push_back({ it->k, it->v + add });
+        int cr = verify_subtree(it.right(), add + it->add, out);
+        EXPECT_EQ(cl + 1 + cr, it->cnt);
+        EXPECT_EQ(cl + 1 + cr, it.size());
+        auto l = it.left(), r = it.right();
+        long long sl = l.is_nil() ? 0 : l->sum + l->cnt * (add + it->add);
+        long long sr = r.is_nil() ? 0 : r->sum + r->cnt * (add + it->add);
+        EXPECT_EQ(sl + (it->v + add) + sr, it->sum + it->cnt * add);
+        if (!l.is_nil()) EXPECT_FALSE(l.it.balance() < it.it.balance());
+        if (!r.is_nil()) EXPECT_FALSE(r.it.balance() < it.it.balance());
+        return cl + 1 + cr;
+    }
+    template<typename LT>
+    void verify_structure(LT& t, const vector<pair<int, long long>>& expected) {
+        vector<pair<int, long long>> actual;
+        EXPECT_EQ(int(expected.size()), verify_subtree(t.root(), 0, actual));
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(int(expected.size()), t.size());
+    }
+}
+
+TEST(lazy_treap_test, assign_sorted) {
+    vector<item> v; vector<pair<int, long long>> e;
+    for (int i = 0; i < 100; i++) v.push_back(item(i * 3, i * i)), e.push_back({ i * 3, i * i });
+    lazy_treap_t t(v.begin(), v.end(), item_up, item_down);
+    verify_structure(t, e);
+    EXPECT_EQ(328350, t.root()->sum);
+    t.assign_sorted(v.begin(), v.begin() + 10);
+    verify_structure(t, vector<pair<int, long long>>(e.begin(), e.begin() + 10));
+    // unsorted input falls back to insertion
+    vector<item> u{ item(5, 1), item(3, 2), item(8, 3) };
+    lazy_treap_t t2(u.begin(), u.end(), item_up, item_down);
+    verify_structure(t2, { { 3, 2 }, { 5, 1 }, { 8, 3 } });
+}
+
+TEST(lazy_treap_test, split_merge) {
+    vector<item> v;
+    for (int i = 0; i < 50; i++) v.push_back(item(i * 2, i));
+    for (int k = -1; k <= 100; k++) {
+        lazy_treap_t t1(v.begin(), v.end(), item_up, item_down), t2(item_up, item_down);
+        // add 1000 to all the elements lazily
+        item_add(*t1.root(), 1000);
+        t1.split(item(k, 0), t2);
+        vector<pair<int, long long>> e1, e2;
+        for (auto& it : v) ((it.k < k) ? e1 : e2).push_back({ it.k, it.v + 1000 });
+        verify_structure(t1, e1);
+        verify_structure(t2, e2);
+        if (!t2.empty()) item_add(*t2.root(), 1);
+        for (auto& p : e2) p.second += 1;
+        t1.merge(t2);
+        e1.insert(e1.end(), e2.begin(), e2.end());
+        verify_structure(t1, e1);
+        verify_structure(t2, {});
+    }
+}
+
+TEST(lazy_treap_test, make_lazy_treap) {
+    auto up = [](item& p, const item& l, const item& r) { item_up(p, l, r); };
+    auto down = [](item& p, item& l, item& r) { item_down(p, l, r); };
+    auto t1 = make_lazy_treap<item>(up, down, item_cmp());
+    static_assert(is_same<decltype(t1), lazy_treap<item, item_cmp, decltype(up), decltype(down)>>::value, "the functor types should be deduced");
+    vector<pair<int, long long>> e;
+    for (int i = 0; i < 40; i++) {
+        int k = (i * 17) % 40;
+        t1.insert(item(k, k * 10));
+    }
+    for (int k = 0; k < 40; k++) e.push_back({ k, k * 10 });
+    verify_structure(t1, e);
+    item_add(*t1.root(), 5);
+    for (auto& p : e) p.second += 5;
+    decltype(t1) t2(up, down, item_cmp());
+    t1.split(item(25, 0), t2);
+    verify_structure(t1, vector<pair<int, long long>>(e.begin(), e.begin() + 25));
+    verify_structure(t2, vector<pair<int, long long>>(e.begin() + 25, e.end()));
+    t1.merge(t2);
+    verify_structure(t1, e);
+    for (int k = 0; k < 40; k += 3) t1.erase(item(k, 0));
+    vector<pair<int, long long>> e2;
+    for (auto& p : e) if (p.first % 3 != 0) e2.push_back(p);
+    verify_structure(t1, e2);
+}
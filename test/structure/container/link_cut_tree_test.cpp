@@ -0,0 +1,119 @@
+#include "altruct/structure/container/link_cut_tree.h"
+#include "altruct/algorithm/random/xorshift.h"
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+namespace {
+    // node value, and the sum of the values over its aux subtree
+    struct item {
+        long long v = 0, sum = 0;
+        item() {}
+        item(long long v) : v(v), sum(v) {}
+    };
+
+    // naive forest, given by the parent of each node; 0 for the roots
+    struct naive_forest {
+        vector<int> parent;
+        vector<long long> val;
+        int root(int u) const { while (parent[u]) u = parent[u]; return u; }
+        int depth(int u) const { int d = 0; while (parent[u]) u = parent[u], d++; return d; }
+        long long path_sum(int u) const { long long s = 0; for (; u; u = parent[u]) s += val[u]; return s; }
+        int lca(int u, int v) const {
+            if (root(u) != root(v)) return 0;
+            int du = depth(u), dv = depth(v);
+            for (; du > dv; du--) u = parent[u];
+            for (; dv > du; dv--) v = parent[v];
+            while (u != v) u = parent[u], v = parent[v];
+            return u;
+        }
+    };
+
+    template<typename LCT>
+    void verify(LCT& t, const naive_forest& f) {
+        int n = int(f.parent.size()) - 1;
+        ASSERT_EQ(n, t.size());
+        for (int u = 1; u <= n; u++) {
+            EXPECT_EQ(f.root(u), t.find_root(u)) << u;
+            EXPECT_EQ(f.depth(u), t.depth(u)) << u;
+            if (f.parent[u]) EXPECT_EQ(f.parent[u], t.find_parent(u)) << u;
+            EXPECT_EQ(f.path_sum(u), t.get(u).sum) << u;
+            EXPECT_EQ(f.lca(u, n + 1 - u), t.find_lca(u, n + 1 - u)) << u;
+        }
+    }
+
+    // links and cuts random nodes in both forests
+    template<typename LCT>
+    void random_ops(LCT& t, naive_forest& f, altruct::random::xorshift_64star& rng, int ops) {
+        int n = int(f.parent.size()) - 1;
+        for (int k = 0; k < ops; k++) {
+            int u = 1 + int(rng.next() % n), v = 1 + int(rng.next() % n);
+            if (f.parent[u]) {
+                t.cut(u), f.parent[u] = 0;
+            } else if (f.root(v) != u) {
+                t.link(u, v), f.parent[u] = v;
+            }
+        }
+    }
+}
+
+TEST(link_cut_tree_test, make_link_cut_tree) {
+    auto up = [](item& p, const item& l, const item& r) { p.sum = l.sum + p.v + r.sum; };
+    auto t = make_link_cut_tree<item>(0, up);
+    static_assert(is_same<decltype(t), link_cut_tree<item, decltype(up)>>::value, "the functor type should be deduced");
+    naive_forest f{ { 0 }, { 0 } };
+    for (int i = 1; i <= 30; i++) {
+        EXPECT_EQ(i, t.add(item(i * i)));
+        f.parent.push_back(0), f.val.push_back(i * i);
+    }
+    verify(t, f);
+    altruct::random::xorshift_64star rng(1);
+    for (int r = 0; r < 20; r++) {
+        random_ops(t, f, rng, 10);
+        verify(t, f);
+    }
+}
+
+TEST(link_cut_tree_test, move) {
+    auto up = [](item& p, const item& l, const item& r) { p.sum = l.sum + p.v + r.sum; };
+    vector<item> vals;
+    naive_forest f{ { 0 }, { 0 } };
+    for (int i = 1; i <= 20; i++) {
+        vals.push_back(item(i));
+        f.parent.push_back(0), f.val.push_back(i);
+    }
+    altruct::random::xorshift_64star rng(2);
+    {
+        typedef link_cut_tree<item, decltype(up)> lct_t;
+        unique_ptr<lct_t> t1(new lct_t(vals.begin(), vals.end(), up));
+        random_ops(*t1, f, rng, 30);
+        verify(*t1, f);
+        lct_t t2(std::move(*t1));
+        // the moved-from tree must not free the moved nodes
+        t1.reset();
+        // the moved-to tree keeps the structure, and can be used further
+        verify(t2, f);
+        random_ops(t2, f, rng, 30);
+        EXPECT_EQ(21, t2.add(item(21)));
+        f.parent.push_back(0), f.val.push_back(21);
+        t2.link(21, 1), f.parent[21] = 1;
+        verify(t2, f);
+    }
+    {
+        link_cut_tree<item> t1(vals.begin(), vals.end(), up);
+        link_cut_tree<item> t2(std::move(t1));
+        t2.link(2, 1);
+        EXPECT_EQ(1, t2.find_root(2));
+        EXPECT_EQ(3, t2.get(2).sum);
+        // moved twice; the moved-from trees get destroyed after the final one
+        link_cut_tree<item> t3(std::move(t2));
+        EXPECT_EQ(1, t3.find_parent(2));
+    }
+}
@@ -0,0 +1,70 @@
+#include "altruct/structure/container/persistent_segment_tree.h"
+#include "altruct/structure/container/segment_tree.h"
+#include "altruct/algorithm/random/xorshift.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+TEST(persistent_segment_tree_test, get) {
+    vector<int> v{ 5, 3, 8, 4, 1, 9 };
+    auto st = make_persistent_segment_tree(v.begin(), v.end(), segment_tree_min<int>(), 1000);
+    EXPECT_EQ(8, st.size());
+    for (size_t b = 0; b <= st.size(); b++) {
+        for (size_t e = b; e <= st.size(); e++) {
+            int m = 1000;
+            for (size_t i = b; i < e && i < v.size(); i++) m = min(m, v[i]);
+            EXPECT_EQ(m, st.get(b, e)) << b << " " << e;
+        }
+    }
+    for (size_t i = 0; i < v.size(); i++) {
+        EXPECT_EQ(v[i], st[i]);
+        EXPECT_EQ(v[i], st.get(i));
+    }
+    EXPECT_EQ(1000, st[7]);
+}
+
+TEST(persistent_segment_tree_test, versions) {
+    typedef persistent_segment_tree<long long, segment_tree_sum<long long>> pst;
+    arena_allocator<persistent_segment_tree_node<long long>> alloc;
+    {
+        int n = 1000;
+        altruct::random::xorshift_64star rng(12345);
+        // a tree of identity elements takes just O(log n) nodes
+        vector<pst> vt{ pst(n, {}, 0, alloc) };
+        EXPECT_EQ(11, alloc.size());
+        vector<vector<long long>> vv{ vector<long long>(n) };
+        for (int i = 0; i < 1000; i++) {
+            int j = int(rng.next() % vt.size());
+            pst t = vt[j];
+            vector<long long> v = vv[j];
+            int k = int(rng.next() % n);
+            long long val = rng.next() % 1000000;
+            size_t used = alloc.size();
+            t.set(k, val);
+            v[k] = val;
+            EXPECT_LE(alloc.size(), used + 11);
+            vt.push_back(t);
+            vv.push_back(v);
+        }
+        for (int iter = 0; iter < 1000; iter++) {
+            int j = int(rng.next() % vt.size());
+            int b = int(rng.next() % n), e = int(rng.next() % n);
+            if (b > e) swap(b, e);
+            long long s = 0; for (int i = b; i < e; i++) s += vv[j][i];
+            EXPECT_EQ(s, vt[j].get(b, e));
+        }
+        // modifying a path that is not shared doesn't allocate
+        pst t = vt.back();
+        t.set(0, 41);
+        size_t used = alloc.size();
+        t.set(0, 42);
+        EXPECT_EQ(used, alloc.size());
+        EXPECT_EQ(42, t[0]);
+        EXPECT_EQ(vv.back()[0], vt.back()[0]);
+    }
+    EXPECT_EQ(0, alloc.size());
+}
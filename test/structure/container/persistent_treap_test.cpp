@@ -0,0 +1,115 @@
+#include "altruct/structure/container/persistent_treap.h"
+#include "altruct/algorithm/random/xorshift.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+
+namespace {
+    template<typename PT, typename COLLECTION>
+    void verify_structure(const PT& t, const COLLECTION& c) {
+        vector<typename PT::value_type> va;
+        for (auto it = t.cbegin(); it != t.cend(); ++it) {
+            for (int i = 0; i < it.count(); i++) {
+                va.push_back(*it);
+            }
+        }
+        EXPECT_EQ(vector<typename PT::value_type>(c.begin(), c.end()), va);
+        EXPECT_EQ(int(c.size()), t.size());
+        EXPECT_EQ(c.empty(), t.empty());
+    }
+}
+
+TEST(persistent_treap_test, constructor) {
+    persistent_treap<int> t0;
+    verify_structure(t0, set<int>());
+    vector<int> v{ 5, 3, 8, 3, 1, 9 };
+    persistent_treap<int> t1(v.begin(), v.end());
+    verify_structure(t1, set<int>(v.begin(), v.end()));
+    persistent_treap<int> t2{ 1, 3, 3, 5, 8, 9 };
+    verify_structure(t2, set<int>(v.begin(), v.end()));
+    EXPECT_TRUE(t1 == t2);
+    persistent_treap<int, int, bst_duplicate_handling::COUNT> t3(v.begin(), v.end());
+    verify_structure(t3, multiset<int>(v.begin(), v.end()));
+    persistent_treap<int, int, bst_duplicate_handling::STORE> t4{ 1, 3, 3, 5, 8, 9 };
+    verify_structure(t4, multiset<int>(v.begin(), v.end()));
+    persistent_treap<int> t5(std::move(t1));
+    verify_structure(t5, set<int>(v.begin(), v.end()));
+    t5.clear();
+    verify_structure(t5, set<int>());
+}
+
+TEST(persistent_treap_test, query) {
+    persistent_treap<int, int, bst_duplicate_handling::STORE> t{ 1, 3, 3, 5, 8, 9 };
+    EXPECT_EQ(3, t.count_less(4));
+    EXPECT_EQ(3, t.count_less_or_equal(3));
+    EXPECT_EQ(2, t.count(3));
+    EXPECT_EQ(0, t.count(4));
+    EXPECT_EQ(5, *t.find_kth(3));
+    EXPECT_TRUE(t.find_kth(6) == t.end());
+    EXPECT_EQ(5, *t.find(5));
+    EXPECT_TRUE(t.find(4) == t.end());
+    EXPECT_EQ(5, *t.lower_bound(4));
+    EXPECT_EQ(5, *t.upper_bound(3));
+    EXPECT_TRUE(t.upper_bound(9) == t.end());
+    EXPECT_EQ((vector<int>{ 3, 3, 5, 8, 9 }), vector<int>(t.lower_bound(2), t.end()));
+}
+
+TEST(persistent_treap_test, versions) {
+    typedef pair<const int, string> entry;
+    arena_allocator<persistent_treap_node<entry>> alloc;
+    {
+        altruct::random::xorshift_64star rng(12345);
+        typedef persistent_treap<int, entry, bst_duplicate_handling::IGNORE, less<int>, bst_random, arena_allocator<persistent_treap_node<entry>>> ptreap;
+        vector<ptreap> vt{ ptreap(less<int>(), bst_random(), alloc) };
+        vector<map<int, string>> vm{ {} };
+        for (int i = 0; i < 2000; i++) {
+            // derive a new version from a random existing one
+            int j = int(rng.next() % vt.size());
+            ptreap t = vt[j];
+            map<int, string> m = vm[j];
+            int k = int(rng.next() % 100);
+            size_t used = alloc.size();
+            if (rng.next() % 3 == 0) {
+                t.erase(k);
+                m.erase(k);
+            } else {
+                t.insert({ k, to_string(i) });
+                m.insert({ k, to_string(i) });
+            }
+            // only the path gets copied
+            EXPECT_LE(alloc.size(), used + 3 * 20);
+            vt.push_back(t);
+            vm.push_back(m);
+        }
+        for (size_t j = 0; j < vt.size(); j++) {
+            verify_structure(vt[j], vm[j]);
+        }
+        // dropping the versions reclaims their nodes
+        vt.resize(1);
+        EXPECT_EQ(0, alloc.size());
+    }
+    EXPECT_EQ(0, alloc.size());
+}
+
+TEST(persistent_treap_test, count) {
+    persistent_treap<string, string, bst_duplicate_handling::COUNT> t0;
+    t0.insert("b", 3);
+    auto t1 = t0;
+    t1.insert("a", 2);
+    t1.insert("b", 1);
+    auto t2 = t1;
+    t2.erase("b", 2);
+    auto t3 = t2;
+    t3.erase("b");
+    verify_structure(t0, vector<string>{ "b", "b", "b" });
+    verify_structure(t1, vector<string>{ "a", "a", "b", "b", "b", "b" });
+    verify_structure(t2, vector<string>{ "a", "a", "b", "b" });
+    verify_structure(t3, vector<string>{ "a", "a" });
+}
@@ -231,3 +231,19 @@ TEST(rope_test, update_and_query) {
     EXPECT_EQ(se, string(t.cbegin(), t.cend()));
     EXPECT_EQ(qe, qa);
 }
+
+TEST(rope_test, split_merge) {
+    string s = "the quick brown fox jumps over the lazy dog";
+    for (int k = 0; k <= (int)s.size(); k++) {
+        rope<char> t1(s.begin(), s.end()), t2{ 'x', 'y' };
+        t1.split(k, t2);
+        verify_structure(t1, s.substr(0, k));
+        verify_structure(t2, s.substr(k));
+        t2.merge(t1);
+        verify_structure(t1, string());
+        verify_structure(t2, s.substr(k) + s.substr(0, k));
+        t1.merge(t2);
+        verify_structure(t1, s.substr(k) + s.substr(0, k));
+        EXPECT_EQ(s[k / 2], t1[(k / 2 + (int)s.size() - k) % (int)s.size()]);
+    }
+}
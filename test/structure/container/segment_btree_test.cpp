@@ -0,0 +1,146 @@
+#include "altruct/structure/container/segment_btree.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace altruct::container;
+
+namespace {
+template<typename T, typename F>
+T slow_get(const vector<T>& v, size_t begin, size_t end, F f, const T& id = T()) {
+    T t = id;
+    for (size_t i = begin; i < end; i++) {
+        t = f(t, v[i]);
+    }
+    return t;
+}
+
+template<typename ST, typename T, typename F>
+void verify_all(const ST& st, const vector<T>& v, F f, const T& id = T()) {
+    for (size_t begin = 0; begin < v.size(); begin++) {
+        EXPECT_EQ(v[begin], st.get(begin)) << " unexpected result of get(" << begin << ")";
+        for (size_t end = begin; end <= v.size(); end++) {
+            EXPECT_EQ(slow_get(v, begin, end, f, id), st.get(begin, end)) << " unexpected result of get(" << begin << ", " << end << ")";
+        }
+    }
+}
+}
+
+TEST(segment_btree_test, build_str_cat) {
+    auto concat = [](const string& s1, const string& s2){ return s1 + s2; };
+    vector<string> v{ "aaa", "b", "cc", "dddd", "ee", "ff", "g", "hhhhh", "i", "jj", "kkk" };
+
+    segment_btree<string, std::function<string(string, string)>, 2> st1(v.size(), concat);
+    EXPECT_EQ(12, st1.size());
+    for (size_t i = 0; i < v.size(); i++) st1.set(i, v[i]);
+    verify_all(st1, v, concat);
+
+    segment_btree<string, std::function<string(string, string)>, 3> st2(v.begin(), v.end(), concat);
+    EXPECT_EQ(12, st2.size());
+    verify_all(st2, v, concat);
+
+    segment_btree<string> st3(v.begin(), v.end(), concat);
+    EXPECT_EQ(16, st3.size());
+    verify_all(st3, v, concat);
+}
+
+TEST(segment_btree_test, build_int_min) {
+    int inf = numeric_limits<int>::max();
+    auto min_f = [](int v1, int v2){ return std::min(v1, v2); };
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3 };
+
+    segment_btree<int, segment_tree_min<int>, 2> st1(v.size(), {}, inf);
+    EXPECT_EQ(10, st1.size());
+    for (size_t i = 0; i < v.size(); i++) st1.set(i, v[i]);
+    verify_all(st1, v, min_f, inf);
+
+    segment_btree<int, segment_tree_min<int>, 4> st2(v.begin(), v.end(), {}, inf);
+    EXPECT_EQ(12, st2.size());
+    verify_all(st2, v, min_f, inf);
+}
+
+TEST(segment_btree_test, modify_rebuild) {
+    int inf = numeric_limits<int>::max();
+    auto min_f = [](int v1, int v2){ return std::min(v1, v2); };
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3 };
+
+    segment_btree<int, segment_tree_min<int>, 2> st(v.begin(), v.end(), {}, inf);
+    st[3] = v[3] = 9;
+    st[6] = v[6] = 2;
+    st[8] = v[8] = -7;
+    st.rebuild();
+    verify_all(st, v, min_f, inf);
+    st[6] = v[6] = 3;
+    st[7] = v[7] = -8;
+    st.rebuild(6, 7 + 1);
+    verify_all(st, v, min_f, inf);
+    st[1] = v[1] = 5;
+    st.rebuild(1);
+    verify_all(st, v, min_f, inf);
+    // empty ranges are no-ops
+    st.rebuild(0, 0);
+    st.rebuild(5, 5);
+    st.rebuild(7, 3);
+    verify_all(st, v, min_f, inf);
+}
+
+TEST(segment_btree_test, random) {
+    altruct::random::xorshift_64star rng(12345);
+    int n = 1000;
+    vector<int> v(n);
+    for (auto& x : v) x = int(rng.next() % 1000);
+    segment_tree<int, segment_tree_sum<int>> st(v.begin(), v.end(), {});
+    segment_btree<int, segment_tree_sum<int>, 4> sb4(v.begin(), v.end(), {});
+    segment_btree<int, segment_tree_sum<int>, 16> sb16(v.begin(), v.end(), {});
+    for (int k = 0; k < 10000; k++) {
+        uint64_t r = rng.next();
+        int b = int(r % (n + 1)), e = int((r >> 32) % (n + 1));
+        if (b > e) swap(b, e);
+        if (r & (1 << 20)) {
+            int val = int(r >> 54);
+            st.set(b % n, val); sb4.set(b % n, val); sb16.set(b % n, val);
+        } else {
+            EXPECT_EQ(st.get(b, e), sb4.get(b, e));
+            EXPECT_EQ(st.get(b, e), sb16.get(b, e));
+        }
+    }
+}
+
+namespace {
+template<typename ST>
+double bench_get(const ST& st, int n, int k, int64_t& checksum) {
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    auto T0 = clk::now();
+    for (int i = 0; i < k; i++) {
+        uint64_t r = rng.next();
+        int b = int(r % n), e = int((r >> 32) % n);
+        checksum += st.get(min(b, e), max(b, e) + 1);
+    }
+    return since(T0);
+}
+}
+
+TEST(segment_btree_test, perf) {
+    return; // do not test perf by default
+    int k = 10000000;
+    for (int n : { 1 << 16, 1 << 20, 1 << 24 }) {
+        vector<int> v(n, 1);
+        int64_t c1 = 0, c2 = 0, c3 = 0, c4 = 0;
+        segment_tree<int, segment_tree_sum<int>> st_sum(v.begin(), v.end(), {});
+        double t1 = bench_get(st_sum, n, k, c1);
+        segment_btree<int, segment_tree_sum<int>> sb_sum(v.begin(), v.end(), {});
+        double t2 = bench_get(sb_sum, n, k, c2);
+        segment_tree<int, segment_tree_min<int>> st_min(v.begin(), v.end(), {}, numeric_limits<int>::max());
+        double t3 = bench_get(st_min, n, k, c3);
+        segment_btree<int, segment_tree_min<int>> sb_min(v.begin(), v.end(), {}, numeric_limits<int>::max());
+        double t4 = bench_get(sb_min, n, k, c4);
+        EXPECT_EQ(c1, c2);
+        EXPECT_EQ(c3, c4);
+        cout << "n: " << n << " sum: segment_tree " << t1 << " segment_btree " << t2 << " min: segment_tree " << t3 << " segment_btree " << t4 << endl;
+    }
+}
@@ -1,7 +1,14 @@
 #include "altruct/structure/container/segment_tree.h"
 
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
+
 #include "gtest/gtest.h"
 
+#include <functional>
+#include <iostream>
+#include <numeric>
+
 using namespace std;
 using namespace altruct::container;
 
@@ -96,3 +103,95 @@ TEST(segment_tree_test, modify_range_rebuild) {
     st.rebuild(6, 8 + 1);
     verify_all(st, v, min_f, inf);
 }
+
+TEST(segment_tree_test, set_many) {
+    int inf = numeric_limits<int>::max();
+    auto min_f = [](int v1, int v2){ return std::min(v1, v2); };
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3 };
+
+    segment_tree<int> st(v.begin(), v.end(), min_f, inf);
+    vector<pair<int, int>> ops{ { 6, 2 }, { 8, -7 }, { 0, 5 }, { 6, 3 }, { 9, 8 } };
+    for (const auto& op : ops) v[op.first] = op.second;
+    st.set_many(ops.begin(), ops.end());
+    verify_all(st, v, min_f, inf);
+
+    // executes the range one by one
+    auto exec = [](int begin, int end, std::function<void(int, int)> f) {
+        for (int i = begin; i < end; i++) f(i, i + 1);
+    };
+    ops = { { 1, 4 }, { 2, -2 }, { 3, 1 }, { 5, 1 } };
+    for (const auto& op : ops) v[op.first] = op.second;
+    st.set_many(ops.begin(), ops.end(), exec);
+    verify_all(st, v, min_f, inf);
+}
+
+TEST(segment_tree_test, get_many) {
+    auto concat = [](const string& s1, const string& s2){ return s1 + s2; };
+    vector<string> v{ "aaa", "b", "cc", "dddd", "ee", "ff", "g", "hhhhh" };
+
+    segment_tree<string> st(v.begin(), v.end(), concat);
+    vector<pair<int, int>> queries{ { 0, 8 }, { 2, 5 }, { 3, 3 }, { 7, 8 }, { 1, 6 } };
+    EXPECT_EQ((vector<string>{ "aaabccddddeeffghhhhh", "ccddddee", "", "hhhhh", "bccddddeeff" }), st.get_many(queries.begin(), queries.end()));
+}
+
+TEST(segment_tree_test, functors) {
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3 };
+    segment_tree<int, segment_tree_sum<int>> st_sum(v.begin(), v.end(), {});
+    segment_tree<int, segment_tree_min<int>> st_min(v.begin(), v.end(), {}, numeric_limits<int>::max());
+    segment_tree<int, segment_tree_max<int>> st_max(v.begin(), v.end(), {}, numeric_limits<int>::min());
+    for (size_t begin = 0; begin < v.size(); begin++) {
+        for (size_t end = begin + 1; end <= v.size(); end++) {
+            EXPECT_EQ(accumulate(v.begin() + begin, v.begin() + end, 0), st_sum.get(begin, end));
+            EXPECT_EQ(*min_element(v.begin() + begin, v.begin() + end), st_min.get(begin, end));
+            EXPECT_EQ(*max_element(v.begin() + begin, v.begin() + end), st_max.get(begin, end));
+        }
+    }
+}
+
+TEST(segment_tree_test, make_segment_tree) {
+    auto concat = [](const string& s1, const string& s2){ return s1 + s2; };
+    vector<string> v{ "aaa", "b", "cc", "dddd", "ee", "ff", "g", "hhhhh" };
+    auto st1 = make_segment_tree(v.begin(), v.end(), concat);
+    EXPECT_EQ("ccddddee", st1.get(2, 5));
+    auto st2 = make_segment_tree<string>(v.size(), concat);
+    for (size_t i = 0; i < v.size(); i++) st2.set(i, v[i]);
+    EXPECT_EQ(st1.v, st2.v);
+    auto st3 = make_segment_tree(10, segment_tree_min<int>(), numeric_limits<int>::max());
+    st3.set(3, 5); st3.set(7, 2);
+    EXPECT_EQ(5, st3.get(0, 7));
+    EXPECT_EQ(2, st3.get(0, 8));
+}
+
+namespace {
+template<typename ST>
+double bench_segment_tree(ST& st, int n, int k, int64_t& checksum) {
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    auto T0 = clk::now();
+    for (int i = 0; i < k; i++) {
+        uint64_t r = rng.next();
+        int b = int(r % n), e = int((r >> 32) % n);
+        if (r & (1 << 20)) {
+            st.set(b, int(r >> 40));
+        } else {
+            checksum += st.get(min(b, e), max(b, e) + 1);
+        }
+    }
+    return since(T0);
+}
+}
+
+TEST(segment_tree_test, perf) {
+    return; // do not test perf by default
+    int n = 1 << 20, k = 10000000;
+    int64_t c1 = 0, c2 = 0, c3 = 0;
+    segment_tree<int> st1(n, [](int a, int b){ return a + b; });
+    double t1 = bench_segment_tree(st1, n, k, c1);
+    segment_tree<int, segment_tree_sum<int>> st2(n, {});
+    double t2 = bench_segment_tree(st2, n, k, c2);
+    auto st3 = make_segment_tree(n, [](int a, int b){ return a + b; }, 0);
+    double t3 = bench_segment_tree(st3, n, k, c3);
+    EXPECT_EQ(c1, c2);
+    EXPECT_EQ(c1, c3);
+    cout << "std::function: " << t1 << " segment_tree_sum: " << t2 << " lambda: " << t3 << endl;
+}
@@ -0,0 +1,131 @@
+#include "altruct/structure/container/suffix_array.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/concurrency/concurrency.h"
+#include "common_test_util.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+using namespace altruct::concurrency;
+using namespace altruct::test_util;
+
+namespace {
+    // the suffixes sorted by comparing them, including the empty one;
+    // by the `char` comparison, unlike `string::compare` that compares the bytes as unsigned
+    vector<int> naive_suffix_array(const string& s) {
+        int n = (int)s.size();
+        vector<int> sa(n + 1);
+        for (int i = 0; i <= n; i++) sa[i] = i;
+        sort(sa.begin(), sa.end(), [&](int i, int j){ return lexicographical_compare(s.begin() + i, s.end(), s.begin() + j, s.end()); });
+        return sa;
+    }
+
+    int naive_lcp(const string& s, int i, int j) {
+        int k = 0;
+        while (i + k < (int)s.size() && j + k < (int)s.size() && s[i + k] == s[j + k]) k++;
+        return k;
+    }
+
+    template<typename EXEC>
+    void verify_suffix_array(const string& s, const EXEC& exec) {
+        int n = (int)s.size();
+        suffix_array<char> sa(s.begin(), s.end(), exec);
+        vector<int> expected = naive_suffix_array(s);
+        ASSERT_EQ(n, sa.size());
+        for (int k = 0; k <= n; k++) {
+            ASSERT_EQ(expected[k], sa.get_kth_suffix(k)) << s << " k=" << k;
+            ASSERT_EQ(k, sa.get_suffix_order(expected[k])) << s << " k=" << k;
+        }
+        // lcp of the successive sorted suffixes, as computed by Kasai's scan
+        for (int k = 1; k <= n; k++) {
+            ASSERT_EQ(naive_lcp(s, expected[k - 1], expected[k]), sa.get_lcp(expected[k - 1], expected[k])) << s << " k=" << k;
+        }
+        // lcp of arbitrary suffixes, as the range minimum
+        for (int i = 0; i < n; i += 1 + n / 16) {
+            for (int j = 0; j < n; j++) {
+                ASSERT_EQ(naive_lcp(s, i, j), sa.get_lcp(i, j)) << s << " i=" << i << " j=" << j;
+            }
+        }
+    }
+
+    template<typename EXEC>
+    void verify_all(const EXEC& exec) {
+        for (string s : { "", "a", "aa", "ab", "ba", "banana", "mississippi", "mmiissiissiippii",
+                          "abababababab", "aaaaaaaaaaaaaaaa", "abaabaaabaaaab", "cabcabcabca", "baabaabaab" }) {
+            verify_suffix_array(s, exec);
+        }
+        // all the strings over {a, b} of lengths up to 10;
+        // this includes the LMS substrings that run into the end of the input
+        for (int len = 0; len <= 10; len++) {
+            for (int m = 0; m < (1 << len); m++) {
+                string s(len, 'a');
+                for (int i = 0; i < len; i++) if ((m >> i) & 1) s[i] = 'b';
+                verify_suffix_array(s, exec);
+            }
+        }
+        // random strings over small alphabets, for the deeper recursions
+        altruct::random::xorshift_64star rng(12345);
+        for (int alpha : { 2, 3, 4, 26 }) {
+            for (int len : { 50, 200, 1000, 3000 }) {
+                string s(len, 'a');
+                for (auto& c : s) c = char('a' + rng.next() % alpha);
+                verify_suffix_array(s, exec);
+            }
+        }
+    }
+}
+
+TEST(suffix_array_test, serial) {
+    verify_all(serial_range_executor());
+}
+
+TEST(suffix_array_test, chunked) {
+    verify_all(chunked_range_executor{ 1 });
+    verify_all(chunked_range_executor{ 7 });
+}
+
+TEST(suffix_array_test, parallel) {
+    verify_all(parallel_range_executor(4));
+}
+
+TEST(suffix_array_test, induce_blocks) {
+    // small blocks, so that the suffixes get placed into the blocks not yet read, and into the block being placed
+    int old_block_size = suffix_array<char>::induce_block_size;
+    for (int block_size : { 1, 2, 7, 64 }) {
+        suffix_array<char>::induce_block_size = block_size;
+        verify_all(chunked_range_executor{ 3 });
+    }
+    suffix_array<char>::induce_block_size = 256;
+    verify_all(parallel_range_executor(4));
+    suffix_array<char>::induce_block_size = old_block_size;
+}
+
+TEST(suffix_array_test, signed_bytes) {
+    // the bytes >= 0x80 are negative chars, and sort before the others
+    string s;
+    for (int c = 0; c < 256; c++) s += char(c);
+    verify_suffix_array(s, serial_range_executor());
+    altruct::random::xorshift_64star rng(1);
+    for (int len : { 1, 10, 100, 1000 }) {
+        string r(len, 0);
+        for (auto& c : r) c = char(0x7E + rng.next() % 4);
+        verify_suffix_array(r, serial_range_executor());
+    }
+}
+
+TEST(suffix_array_test, compare_substrings) {
+    string s = "abracadabra";
+    suffix_array<char> sa(s.begin(), s.end());
+    int n = (int)s.size();
+    for (int b1 = 0; b1 <= n; b1++) for (int e1 = b1; e1 <= n; e1++) {
+        for (int b2 = 0; b2 <= n; b2++) for (int e2 = b2; e2 <= n; e2++) {
+            int c = s.compare(b1, e1 - b1, s, b2, e2 - b2);
+            EXPECT_EQ((c > 0) - (c < 0), sa.compare_substrings(b1, e1, b2, e2));
+        }
+    }
+}
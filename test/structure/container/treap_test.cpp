@@ -25,12 +25,12 @@ namespace {
         typedef treap<K, T, DUP, CMP, RAND, ALLOC> treap_t;
         using const_iterator = typename treap_t::const_iterator;
 
-        treap_dbg(const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+        treap_dbg(const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
             treap_t(cmp, rnd, alloc) {
         }
 
         template<typename It>
-        treap_dbg(It begin, It end, const CMP& cmp = CMP(), const RAND& rnd = rand, const ALLOC& alloc = ALLOC()) :
+        treap_dbg(It begin, It end, const CMP& cmp = CMP(), const RAND& rnd = bst_default_random<RAND>(), const ALLOC& alloc = ALLOC()) :
             treap_t(begin, end, cmp, rnd, alloc) {
         }
 
@@ -66,12 +66,16 @@ namespace {
         }
         void debug_check(const_iterator it) const {
             if (it == this->end()) return;
-            if (it.left() != this->end()) {
+            ASSERT_EQ(it.size(), it.count() + it.left().size() + it.right().size()) << "ERROR: size out of sync";
+            if (it.parent() != this->end()) {
+                ASSERT_FALSE(it.it.balance() < it.parent().it.balance()) << "ERROR: heap order violation";
+            }
+            if (!it.left().is_nil()) {
                 ASSERT_FALSE(this->tree.compare(*it, *it.left())) << "ERROR: parent < left";
                 ASSERT_FALSE(it.left().parent() != it) << "ERROR: left not connected back to parent";
                 debug_check(it.left());
             }
-            if (it.right() != this->end()) {
+            if (!it.right().is_nil()) {
                 ASSERT_FALSE(this->tree.compare(*it.right(), *it)) << "ERROR: right < parent";
                 ASSERT_FALSE(it.right().parent() != it) << "ERROR: right not connected back to parent";
                 debug_check(it.right());
@@ -434,6 +438,84 @@ TEST(treap_test, iterator_add_pos) {
     EXPECT_EQ(tc.end(), it.add(+3));
 }
 
+TEST(treap_test, assign_sorted) {
+    vector<int> v; for (int i = 0; i < 1000; i++) v.push_back(rand() % 300);
+    sort(v.begin(), v.end());
+    treap_dbg<int, int, bst_duplicate_handling::IGNORE> t1(v.begin(), v.end());
+    verify_structure(t1, set<int>(v.begin(), v.end()));
+    treap_dbg<int, int, bst_duplicate_handling::COUNT> t2(v.begin(), v.end());
+    verify_structure(t2, multiset<int>(v.begin(), v.end()));
+    treap_dbg<int, int, bst_duplicate_handling::STORE> t3;
+    t3.insert(5);
+    t3.assign_sorted(v.begin(), v.end());
+    verify_structure(t3, multiset<int>(v.begin(), v.end()));
+    t3.assign_sorted(v.begin(), v.begin());
+    verify_structure(t3, multiset<int>());
+    // unsorted input falls back to insertion
+    vector<int> u{ 5, 3, 8, 3, 1 };
+    treap_dbg<int> t4(u.begin(), u.end());
+    verify_structure(t4, set<int>(u.begin(), u.end()));
+}
+
+TEST(treap_test, split_merge) {
+    for (int n : { 0, 1, 2, 10, 100 }) {
+        for (int k = 0; k <= n + 1; k++) {
+            vector<int> v; for (int i = 0; i < n; i++) v.push_back(i * 2);
+            treap_dbg<int> t1(v.begin(), v.end()), t2{ 1, 2, 3 };
+            t1.split(k, t2); // elements >= k go to t2
+            verify_structure(t1, set<int>(v.begin(), lower_bound(v.begin(), v.end(), k)));
+            verify_structure(t2, set<int>(lower_bound(v.begin(), v.end(), k), v.end()));
+            t1.merge(t2);
+            verify_structure(t1, set<int>(v.begin(), v.end()));
+            verify_structure(t2, set<int>());
+            if (k > n) continue;
+            t1.split_kth(k, t2);
+            verify_structure(t1, set<int>(v.begin(), v.begin() + k));
+            verify_structure(t2, set<int>(v.begin() + k, v.end()));
+            t2.merge(t1);
+            t1.swap(t2);
+            vector<int> w(v.begin() + k, v.end()); w.insert(w.end(), v.begin(), v.begin() + k);
+            EXPECT_EQ(w, vector<int>(t1.begin(), t1.end()));
+            EXPECT_EQ(n, t1.size());
+            EXPECT_EQ(0, t2.size());
+        }
+    }
+}
+
+TEST(treap_test, split_merge_outlive) {
+    // the moved nodes do not refer to the tree they came from
+    vector<int> v; for (int i = 0; i < 100; i++) v.push_back(i);
+    treap_dbg<int> t2;
+    {
+        treap_dbg<int> t1(v.begin(), v.end());
+        t1.split(30, t2);
+    }
+    verify_structure(t2, set<int>(v.begin() + 30, v.end()));
+    {
+        treap_dbg<int> t1(v.begin(), v.begin() + 30);
+        t1.merge(t2);
+        t2.swap(t1);
+    }
+    verify_structure(t2, set<int>(v.begin(), v.end()));
+    t2.erase(99); t2.insert(100);
+    EXPECT_EQ(100, *--t2.end());
+    EXPECT_EQ(t2.end(), t2.find_kth(100));
+}
+
+TEST(treap_test, default_random) {
+    bst_random rnd;
+    for (int i = 0; i < 1000; i++) EXPECT_LE(0, rnd());
+    // sorted insertion; balanced only if the priorities are random
+    set<int> s1; for (int i = 0; i < 1000; i++) s1.insert(i);
+    typedef treap_dbg<int, int, bst_duplicate_handling::IGNORE, std::less<int>, bst_random> treap_t;
+    treap_t t1(s1.begin(), s1.end());
+    verify_structure(t1, s1);
+    std::function<int(treap_t::const_iterator)> height = [&](treap_t::const_iterator it) {
+        return it.is_nil() ? 0 : 1 + max(height(it.left()), height(it.right()));
+    };
+    EXPECT_GT(100, height(t1.root()));
+}
+
 namespace {
 namespace x{
     struct rdtsc_clock {
@@ -492,6 +574,20 @@ void test_perf(const std::function<int()>& rnd, const string& title) {
     printf("treap %s %lf %lf %lf %lf %d %d %d %lf\n", title.c_str(), dd(dt_i), dd(dt_e), dd(dt_c), dd(dt_t), ct_c, ct_t, iter, dur);
 }
 
+TEST(treap_test, build_perf) {
+    return; // skip perf tests by default
+    using namespace std::chrono;
+    int n = 10000000;
+    vector<int> v(n); for (int i = 0; i < n; i++) v[i] = i;
+    auto T0 = x::clock::now();
+    treap<int> t1; for (int k : v) t1.insert(k);
+    double d1 = duration_cast<duration<double>>(x::since(T0)).count();
+    auto T1 = x::clock::now();
+    treap<int> t2(v.begin(), v.end());
+    double d2 = duration_cast<duration<double>>(x::since(T1)).count();
+    printf("treap build %d: insert %lf, sorted %lf\n", n, d1, d2);
+}
+
 TEST(treap_test, perf) {
     return; // skip perf tests by default
     altruct::random::xorshift_64star xrnd;
@@ -0,0 +1,142 @@
+#include "altruct/structure/container/wavelet_matrix.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/concurrency/concurrency.h"
+#include "common_test_util.h"
+
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::container;
+using namespace altruct::test_util;
+
+namespace {
+    template<typename T>
+    void verify_queries(const wavelet_matrix<T>& wm, const vector<T>& v, altruct::random::xorshift_64star& rng) {
+        size_t n = v.size();
+        EXPECT_EQ(n, wm.size());
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(v[i], wm[i]);
+        }
+        for (int iter = 0; iter < 200; iter++) {
+            size_t b = rng.next() % (n + 1), e = rng.next() % (n + 1);
+            if (b > e) swap(b, e);
+            vector<T> s(v.begin() + b, v.begin() + e);
+            sort(s.begin(), s.end());
+            for (size_t k = 0; k < s.size(); k++) {
+                EXPECT_EQ(s[k], wm.kth(b, e, k));
+            }
+            T x = v.empty() ? T(0) : T(v[rng.next() % n] + rng.next() % 3 - 1);
+            T y = T(x + rng.next() % 10);
+            if (y < x) swap(x, y);
+            EXPECT_EQ(size_t(count(s.begin(), s.end(), x)), wm.rank(b, e, x));
+            EXPECT_EQ(size_t(lower_bound(s.begin(), s.end(), x) - s.begin()), wm.count_less(b, e, x));
+            EXPECT_EQ(size_t(lower_bound(s.begin(), s.end(), y) - lower_bound(s.begin(), s.end(), x)), wm.range_freq(b, e, x, y));
+            map<T, size_t> m;
+            for (T t : s) m[t]++;
+            vector<pair<T, size_t>> vf(m.begin(), m.end());
+            stable_sort(vf.begin(), vf.end(), [](const pair<T, size_t>& p1, const pair<T, size_t>& p2){ return p1.second > p2.second; });
+            size_t k = rng.next() % 5;
+            vf.resize(min(vf.size(), k));
+            EXPECT_EQ(vf, wm.top_k(b, e, k));
+        }
+        map<T, vector<size_t>> pos;
+        for (size_t i = 0; i < n; i++) pos[v[i]].push_back(i);
+        for (const auto& p : pos) {
+            for (size_t k = 0; k < p.second.size(); k++) {
+                EXPECT_EQ(p.second[k], wm.select(p.first, k));
+            }
+            EXPECT_EQ(n, wm.select(p.first, p.second.size()));
+        }
+    }
+}
+
+TEST(wavelet_matrix_test, empty) {
+    vector<uint32_t> v;
+    wavelet_matrix<> wm(v.begin(), v.end());
+    EXPECT_EQ(0, wm.size());
+    EXPECT_EQ(0, wm.levels());
+    EXPECT_EQ(0, wm.rank(0, 0, 5));
+    EXPECT_EQ(0, wm.count_less(0, 0, 5));
+    EXPECT_TRUE(wm.top_k(0, 0, 3).empty());
+}
+
+TEST(wavelet_matrix_test, queries) {
+    vector<uint32_t> v{ 5, 4, 5, 5, 2, 1, 5, 6, 1, 3, 5, 0 };
+    wavelet_matrix<> wm(v.begin(), v.end());
+    EXPECT_EQ(3, wm.levels());
+    EXPECT_EQ(6, wm[7]);
+    EXPECT_EQ(1, wm.kth(2, 9, 0));
+    EXPECT_EQ(5, wm.kth(2, 9, 4));
+    EXPECT_EQ(3, wm.rank(2, 9, 5));
+    EXPECT_EQ(0, wm.rank(2, 9, 7));
+    EXPECT_EQ(0, wm.rank(2, 9, 100));
+    EXPECT_EQ(3, wm.count_less(2, 9, 5));
+    EXPECT_EQ(7, wm.count_less(2, 9, 100));
+    EXPECT_EQ(1, wm.range_freq(2, 9, 2, 5));
+    EXPECT_EQ(4, wm.range_freq(2, 9, 2, 6));
+    EXPECT_EQ(6, wm.select(5, 3));
+    EXPECT_EQ(12, wm.select(5, 5));
+    EXPECT_EQ(12, wm.select(7, 0));
+    EXPECT_EQ((vector<pair<uint32_t, size_t>>{ { 5, 3 }, { 1, 2 }, { 2, 1 } }), wm.top_k(2, 9, 3));
+    wavelet_matrix<> wm2 = wm;
+    wm = wavelet_matrix<>();
+    EXPECT_EQ(3, wm2.rank(2, 9, 5));
+    EXPECT_EQ(0, wm.size());
+}
+
+TEST(wavelet_matrix_test, random) {
+    altruct::random::xorshift_64star rng(12345);
+    for (uint32_t sigma : { 1, 2, 5, 100, 1000000 }) {
+        vector<uint32_t> v(1000);
+        for (auto& x : v) x = uint32_t(rng.next() % sigma);
+        verify_queries(wavelet_matrix<uint32_t>(v.begin(), v.end()), v, rng);
+    }
+    vector<uint64_t> v(300);
+    for (auto& x : v) x = rng.next() % 4 * 0x4000000000000000ULL + rng.next() % 4;
+    verify_queries(wavelet_matrix<uint64_t>(v.begin(), v.end()), v, rng);
+    vector<uint8_t> v8(300);
+    for (auto& x : v8) x = uint8_t(rng.next());
+    verify_queries(wavelet_matrix<uint8_t>(v8.begin(), v8.end()), v8, rng);
+}
+
+TEST(wavelet_matrix_test, parallel) {
+    altruct::random::xorshift_64star rng(12345);
+    vector<uint32_t> v(300000);
+    for (auto& x : v) x = uint32_t(rng.next() % 5000);
+    wavelet_matrix<> wm1(v.begin(), v.end());
+    wavelet_matrix<> wm2(v.begin(), v.end(), chunked_range_executor{ 1 });
+    wavelet_matrix<> wm3(v.begin(), v.end(), altruct::concurrency::parallel_range_executor(4));
+    for (int iter = 0; iter < 1000; iter++) {
+        size_t i = rng.next() % v.size();
+        EXPECT_EQ(v[i], wm2[i]);
+        EXPECT_EQ(v[i], wm3[i]);
+        size_t b = rng.next() % v.size(), e = rng.next() % v.size();
+        if (b > e) swap(b, e);
+        uint32_t x = uint32_t(rng.next() % 5000);
+        EXPECT_EQ(wm1.count_less(b, e, x), wm2.count_less(b, e, x));
+        EXPECT_EQ(wm1.count_less(b, e, x), wm3.count_less(b, e, x));
+    }
+}
+
+TEST(wavelet_matrix_test, perf) {
+    return; // skip perf tests by default
+    altruct::random::xorshift_64star rng(12345);
+    vector<uint32_t> v(1 << 24);
+    for (auto& x : v) x = uint32_t(rng.next() % 1000000);
+    auto T0 = clock();
+    wavelet_matrix<> wm(v.begin(), v.end());
+    auto T1 = clock();
+    size_t r = 0;
+    for (int i = 0; i < 1000000; i++) {
+        size_t b = rng.next() % v.size(), e = rng.next() % v.size();
+        if (b > e) swap(b, e);
+        r += wm.kth(b, e, (e - b) / 2) + wm.count_less(b, e, uint32_t(i));
+    }
+    auto T2 = clock();
+    printf("build: %0.3lf s, queries: %0.3lf s    %d\n", double(T1 - T0) / CLOCKS_PER_SEC, double(T2 - T1) / CLOCKS_PER_SEC, int(r & 1));
+}
@@ -1,8 +1,15 @@
 ﻿#include "altruct/algorithm/math/base.h"
 #include "altruct/structure/math/fenwick_tree.h"
 
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
+
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <numeric>
 #include <vector>
 
 using namespace std;
@@ -49,3 +56,69 @@ TEST(fenwick_tree_test, fenwick_tree_max) {
     }
     EXPECT_EQ((vector<int>(n + 1, -1000000000)), va);
 }
+
+TEST(fenwick_tree_test, functors) {
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3, 3, 1, -4, 1, 5, 9, -2, 6, -5, 3, 1 };
+    int n = int(v.size());
+    fenwick_tree<int, fenwick_tree_sum<int>> fs(n, {});
+    fenwick_tree<int, fenwick_tree_min<int>> fmin(n, {}, INT_MAX);
+    fenwick_tree<int, fenwick_tree_max<int>> fmax(n, {}, INT_MIN);
+    for (int i = 0; i < n; i++) {
+        fs.add(i, v[i]);
+        fmin.add(i, v[i]);
+        fmax.add(i, v[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(accumulate(v.begin(), v.begin() + i + 1, 0), fs.get_sum(i));
+        EXPECT_EQ(*min_element(v.begin(), v.begin() + i + 1), fmin.get_sum(i, INT_MAX));
+        EXPECT_EQ(*max_element(v.begin(), v.begin() + i + 1), fmax.get_sum(i, INT_MIN));
+    }
+}
+
+TEST(fenwick_tree_test, make_fenwick_tree) {
+    vector<int> v{ 2, -3, 4, 6, 11, 1, 0, -5, 7, -3, 3, 1, -4, 1, 5, 9, -2, 6, -5, 3, 1 };
+    int n = int(v.size());
+    auto f = make_fenwick_tree(n, [](int a, int b){ return a ^ b; }, 0);
+    for (int i = 0; i < n; i++) {
+        f.add(i, v[i]);
+    }
+    int x = 0;
+    for (int i = 0; i < n; i++) {
+        x ^= v[i];
+        EXPECT_EQ(x, f.get_sum(i));
+    }
+}
+
+namespace {
+template<typename FT>
+double bench_fenwick_tree(FT& f, int n, int k, int64_t& checksum) {
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    auto T0 = clk::now();
+    for (int i = 0; i < k; i++) {
+        uint64_t r = rng.next();
+        int b = int(r % n);
+        if (r & (1 << 20)) {
+            f.add(b, int(r >> 40));
+        } else {
+            checksum += f.get_sum(b);
+        }
+    }
+    return since(T0);
+}
+}
+
+TEST(fenwick_tree_test, perf) {
+    return; // do not test perf by default
+    int n = 1 << 20, k = 10000000;
+    int64_t c1 = 0, c2 = 0, c3 = 0;
+    fenwick_tree<int> f1(n, [](int a, int b){ return a + b; });
+    double t1 = bench_fenwick_tree(f1, n, k, c1);
+    fenwick_tree<int, fenwick_tree_sum<int>> f2(n, {});
+    double t2 = bench_fenwick_tree(f2, n, k, c2);
+    auto f3 = make_fenwick_tree(n, [](int a, int b){ return a + b; }, 0);
+    double t3 = bench_fenwick_tree(f3, n, k, c3);
+    EXPECT_EQ(c1, c2);
+    EXPECT_EQ(c1, c3);
+    cout << "std::function: " << t1 << " fenwick_tree_sum: " << t2 << " lambda: " << t3 << endl;
+}
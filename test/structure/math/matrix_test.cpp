@@ -1,9 +1,12 @@
 ﻿#include "altruct/structure/math/matrix.h"
 #include "altruct/structure/math/modulo.h"
+#include "altruct/algorithm/random/xorshift.h"
+#include "altruct/chrono/chrono.h"
 #include "structure_test_util.h"
 
 #include "gtest/gtest.h"
 
+#include <climits>
 #include <vector>
 
 using namespace std;
@@ -13,6 +16,37 @@ using namespace altruct::test_util;
 typedef modulo<int, 1000000007> mod;
 typedef moduloX<int> modx;
 
+namespace {
+template<typename T>
+matrix<T> random_matrix(altruct::random::xorshift_64star& rng, int n, int m) {
+    matrix<T> r(n, m);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            r[i][j] = T(int(rng.next() % 2000) - 1000);
+        }
+    }
+    return r;
+}
+
+template<typename T>
+matrix<T> mul_long(const matrix<T>& m1, const matrix<T>& m2) {
+    matrix<T> r(m1.rows(), m2.cols());
+    matrix<T>::_mul_long(r, m1, m2);
+    return r;
+}
+
+template<typename T>
+void test_mul(int n, int m, int p, int strassen_threshold) {
+    altruct::random::xorshift_64star rng(n * 1000000 + m * 1000 + p);
+    auto m1 = random_matrix<T>(rng, n, m);
+    auto m2 = random_matrix<T>(rng, m, p);
+    int old_threshold = matrix_mul<T>::strassen_threshold;
+    matrix_mul<T>::strassen_threshold = strassen_threshold;
+    EXPECT_EQ(mul_long(m1, m2), m1 * m2) << n << " " << m << " " << p << " " << strassen_threshold;
+    matrix_mul<T>::strassen_threshold = old_threshold;
+}
+}
+
 TEST(matrix_test, constructor) {
     matrix<int> m1;
     EXPECT_EQ(0, m1.rows());
@@ -139,6 +173,61 @@ TEST(matrix_test, operators_arithmetic) {
     EXPECT_EQ((matrix<int>{ { 30, 36, 42 }, { 66, 81, 96 }, { 102, 126, 150 }}), mr);
 }
 
+TEST(matrix_test, mul) {
+    for (int t : { 2, 5, 16, 1000 }) {
+        test_mul<int>(16, 16, 16, t);
+        test_mul<int>(64, 64, 64, t);
+        test_mul<int>(37, 16, 21, t);
+        test_mul<int>(50, 71, 33, t);
+        test_mul<mod>(64, 64, 64, t);
+        test_mul<mod>(67, 40, 93, t);
+        test_mul<double>(33, 65, 40, t);
+        test_mul<double>(128, 128, 128, t);
+    }
+    test_mul<mod>(300, 290, 280, 64);
+}
+
+TEST(matrix_test, mul_floating_point) {
+    // Strassen-Winograd is opt-in for the floating point types
+    EXPECT_EQ(INT_MAX, matrix_mul<double>::strassen_threshold);
+    EXPECT_EQ(INT_MAX, matrix_mul<float>::strassen_threshold);
+    EXPECT_EQ(128, matrix_mul<mod>::strassen_threshold);
+    EXPECT_EQ(128, matrix_mul<int>::strassen_threshold);
+}
+
+TEST(matrix_test, mul_perf) {
+    return; // do not test perf by default
+    using clk = altruct::chrono::rdtsc_clock<>;
+    auto bench = [&](auto zero, const string& name) {
+        typedef decltype(zero) T;
+        altruct::random::xorshift_64star rng(12345);
+        for (int n = 64; n <= 2048; n *= 2) {
+            auto m1 = random_matrix<T>(rng, n, n);
+            auto m2 = random_matrix<T>(rng, n, n);
+            double t_long = 0;
+            if (n <= 512) {
+                auto T0 = clk::now();
+                mul_long(m1, m2);
+                t_long = since(T0);
+            }
+            int old_threshold = matrix_mul<T>::strassen_threshold;
+            matrix_mul<T>::strassen_threshold = n + 1;
+            auto T1 = clk::now();
+            auto r1 = m1 * m2;
+            double t_blocked = since(T1);
+            matrix_mul<T>::strassen_threshold = 128;
+            auto T2 = clk::now();
+            auto r2 = m1 * m2;
+            double t_strassen = since(T2);
+            matrix_mul<T>::strassen_threshold = old_threshold;
+            EXPECT_EQ(r1, r2);
+            cout << name << " n: " << n << " long: " << t_long << " blocked: " << t_blocked << " strassen: " << t_strassen << endl;
+        }
+    };
+    bench(mod(0), "mod");
+    bench(double(0), "double");
+}
+
 TEST(matrix_test, operators_inverse) {
     const matrix<mod> m1({ { 20, 30, 40 }, { 50, 60, 70 } });
     const matrix<mod> m2({ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } });
@@ -159,6 +248,98 @@ TEST(matrix_test, operators_inverse) {
     EXPECT_EQ((matrix<mod>{{ 36, 13, -5 }, { 0, 13, 13 }, { -36, 13, 31 }}) / mod(78), mr);
 }
 
+TEST(matrix_test, rank) {
+    EXPECT_EQ(0, (matrix<mod>{ { 0, 0 }, { 0, 0 } }).rank());
+    EXPECT_EQ(2, (matrix<mod>{ { 0, 1, 0 }, { 0, 0, 1 }, { 0, 1, 0 } }).rank());
+    EXPECT_EQ(2, (matrix<mod>{ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } }).rank());
+    EXPECT_EQ(3, (matrix<mod>{ { 2, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } }).rank());
+    EXPECT_EQ(2, (matrix<mod>{ { 20, 30, 40 }, { 50, 60, 70 } }).rank());
+    EXPECT_EQ(2, (matrix<mod>{ { 20, 30 }, { 40, 50 }, { 60, 70 } }).rank());
+    EXPECT_EQ(1, (matrix<mod>{ { 0, 2, 4, 6 }, { 0, 3, 6, 9 } }).rank(chunked_range_executor{ 1 }));
+    matrix<mod> m(3, 3); matrix<mod> inv; mod det;
+    m = { { 0, 1, 0 }, { 0, 0, 1 }, { 0, 1, 0 } };
+    EXPECT_EQ(2, matrix<mod>::gauss(m, inv, det));
+    EXPECT_EQ(mod(0), det);
+}
+
+TEST(matrix_test, lu) {
+    const matrix<mod> m3({ { 0, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } });
+    matrix<mod> m = m3;
+    vector<int> perm;
+    EXPECT_EQ(1, matrix<mod>::lu(m, perm));
+    EXPECT_EQ((vector<int>{ 1, 0, 2 }), perm);
+    matrix<mod> l = matrix<mod>::identity(3, 1), u(3, 3);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            (j < i ? l : u)[i][j] = m[i][j];
+        }
+    }
+    EXPECT_EQ((matrix<mod>{ m3[1], m3[0], m3[2] }), l * u);
+    m = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
+    EXPECT_EQ(-1, matrix<mod>::lu(m, perm));
+}
+
+TEST(matrix_test, det) {
+    EXPECT_EQ(mod(0), (matrix<mod>{ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } }).det());
+    EXPECT_EQ(mod(-78), (matrix<mod>{ { 2, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } }).det());
+    EXPECT_EQ(mod(78), (matrix<mod>{ { 7, 11, 13 }, { 2, 3, 5 }, { 17, 19, 23 } }).det());
+    EXPECT_EQ(-78.0, (matrix<double>{ { 2, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } }).det());
+    altruct::random::xorshift_64star rng(12345);
+    for (int n : { 1, 2, 5, 63, 64, 65, 150 }) {
+        auto m = random_matrix<mod>(rng, n, n);
+        if (n > 1) m[n - 1] = m[0]; // singular
+        matrix<mod> mat(m), inv; mod det;
+        EXPECT_EQ(n > 1 ? n - 1 : 1, matrix<mod>::gauss(mat, inv, det));
+        EXPECT_EQ(det, m.det()) << n;
+        EXPECT_EQ(n > 1 ? n - 1 : 1, m.rank(chunked_range_executor{ 7 })) << n;
+        m[n - 1][0] += 1; // non-singular
+        mat = m; matrix<mod>::gauss(mat, inv, det);
+        EXPECT_EQ(det, m.det()) << n;
+        EXPECT_EQ(det, m.det(chunked_range_executor{ 7 })) << n;
+        EXPECT_EQ(n, m.rank()) << n;
+        EXPECT_EQ(inv, m.inverse(chunked_range_executor{ 7 })) << n;
+    }
+}
+
+TEST(matrix_test, solve) {
+    const matrix<mod> m3({ { 2, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } });
+    const matrix<mod> b({ { 1, 0 }, { 2, 5 }, { 3, 7 } });
+    EXPECT_EQ(m3.inverse() * b, m3.solve(b));
+    EXPECT_EQ(matrix<mod>(), (matrix<mod>{ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } }).solve(b));
+    altruct::random::xorshift_64star rng(12345);
+    for (int n : { 1, 2, 5, 63, 64, 65, 150 }) {
+        auto m = random_matrix<mod>(rng, n, n);
+        auto b = random_matrix<mod>(rng, n, 3);
+        auto x = m.solve(b, chunked_range_executor{ 2 });
+        EXPECT_EQ(b, m * x) << n;
+        EXPECT_EQ(x, m.solve(b)) << n;
+    }
+}
+
+TEST(matrix_test, gauss_perf) {
+    return; // do not test perf by default
+    using clk = altruct::chrono::rdtsc_clock<>;
+    altruct::random::xorshift_64star rng(12345);
+    for (int n = 100; n <= 1600; n *= 2) {
+        auto m = random_matrix<mod>(rng, n, n);
+        auto b = random_matrix<mod>(rng, n, 1);
+        auto T0 = clk::now();
+        auto inv = m.inverse();
+        double t_inverse = since(T0);
+        auto T1 = clk::now();
+        auto d = m.det();
+        double t_det = since(T1);
+        auto T2 = clk::now();
+        int r = m.rank();
+        double t_rank = since(T2);
+        auto T3 = clk::now();
+        auto x = m.solve(b);
+        double t_solve = since(T3);
+        EXPECT_EQ(inv * b, x);
+        cout << "n: " << n << " r: " << r << " det: " << d.v << " inverse: " << t_inverse << " det: " << t_det << " rank: " << t_rank << " solve: " << t_solve << endl;
+    }
+}
+
 TEST(matrix_test, power) {
     const matrix<mod> m1({ { 2, 3, 5 }, { 7, 11, 13 }, { 17, 19, 23 } });
     EXPECT_EQ((matrix<mod>{ { 1, 0, 0}, { 0, 1, 0}, { 0, 0, 1} }), m1.pow(0));
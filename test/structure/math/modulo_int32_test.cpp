@@ -305,6 +305,32 @@ TEST(modulo_int32_test, casts) {
     EXPECT_EQ(M, m8.M());
 }
 
+TEST(modulo_int32_test, dot_product) {
+    // all the values close to M, so that the 64-bit accumulator overflows many times
+    vector<mod> a, b;
+    mod r = mod(-3);
+    for (int i = 0; i < 1000; i++) {
+        a.push_back(mod(-1 - i));
+        b.push_back(mod(-7 - 3 * i));
+        r += a.back() * b.back();
+    }
+    EXPECT_EQ(r, dot_product<mod>::impl(mod(-3), a.data(), 1, b.data(), 1, 1000));
+    EXPECT_EQ(mod(-3), dot_product<mod>::impl(mod(-3), a.data(), 1, b.data(), 1, 0));
+    EXPECT_EQ(a[999] * b[0] + a[998] * b[1], dot_product<mod>::impl(mod(0), a.data() + 999, -1, b.data(), 1, 2));
+    // instance modulus
+    typedef moduloX<int32_t> modx;
+    vector<modx> ax, bx;
+    modx rx = modx(5, 1000000007);
+    for (int i = 0; i < 100; i++) {
+        ax.push_back(modx(-1 - i * i, 1000000007));
+        bx.push_back(modx(i * 12345, 1000000007));
+        rx += ax.back() * bx.back();
+    }
+    modx dx = dot_product<modx>::impl(modx(5, 1000000007), ax.data(), 1, bx.data(), 1, 100);
+    EXPECT_EQ(rx, dx);
+    EXPECT_EQ(1000000007, dx.M());
+}
+
 TEST(modulo_int8_test, modulo_normalize_bruteforce) {
     for (int m = 1; m < (1 << 7); m++) {
         for (int v = -(1 << 7); v < (1 << 7); v++) {
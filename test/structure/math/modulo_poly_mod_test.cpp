@@ -44,3 +44,15 @@ TEST(modulo_poly_mod_test, fibonacci) {
     EXPECT_EQ((vector<mod>{0, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144}), vf);
     EXPECT_EQ(mod(687995182), powT(x, 100).v[1]); // f(100) % 1000000007
 }
+
+TEST(modulo_poly_mod_test, inverse_high_degree) {
+    // x^500 - x - 1; the inverse goes through the half-gcd
+    poly m{ -1, -1 }; m[500] = 1;
+    polymod::M() = m;
+    poly p;
+    for (int i = 0; i < 400; i++) p[i] = mod(i * i + 3);
+    polymod v(p);
+    polymod vi = v.inv();
+    EXPECT_EQ(polymod(1), v * vi);
+    EXPECT_EQ(polymod(5), (v * 5) / v);
+}
@@ -270,3 +270,25 @@ TEST(modulo_uint64_test, casts) {
     EXPECT_EQ(UINT64_C(6708427641812857077), m8.v);
     EXPECT_EQ(M, m8.M());
 }
+
+TEST(modulo_uint64_test, dot_product) {
+    // M > 2^32 uses the generic loop
+    vector<mod> a, b;
+    mod r = mod(3);
+    for (int i = 0; i < 100; i++) {
+        a.push_back(mod(0) - mod(1 + i));
+        b.push_back(mod(0) - mod(7 + 3 * i));
+        r += a.back() * b.back();
+    }
+    EXPECT_EQ(r, dot_product<mod>::impl(mod(3), a.data(), 1, b.data(), 1, 100));
+    // M = 2^32 - 5, the largest prime below 2^32
+    typedef modulo<uint64_t, UINT64_C(4294967291), modulo_storage::CONSTANT> mod32;
+    vector<mod32> a32, b32;
+    mod32 r32 = mod32(3);
+    for (int i = 0; i < 1000; i++) {
+        a32.push_back(mod32(UINT64_C(4294967290) - i));
+        b32.push_back(mod32(UINT64_C(4294967290) - 5 * i));
+        r32 += a32.back() * b32.back();
+    }
+    EXPECT_EQ(r32, dot_product<mod32>::impl(mod32(3), a32.data(), 1, b32.data(), 1, 1000));
+}
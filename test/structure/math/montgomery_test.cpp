@@ -0,0 +1,62 @@
+#include "altruct/structure/math/montgomery.h"
+#include "altruct/structure/math/modulo.h"
+#include "altruct/algorithm/random/xorshift.h"
+
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace altruct::math;
+
+TEST(montgomery_test, constructor) {
+    montgomery64 m(1000000007);
+    EXPECT_EQ(1000000007, m.n);
+    EXPECT_EQ(1, m.n * m.n_inv);
+    EXPECT_EQ((uint64_t(1) << 32) % 1000000007 * ((uint64_t(1) << 32) % 1000000007) % 1000000007, m.r1);
+    EXPECT_EQ(1, m.from(m.one()));
+}
+
+TEST(montgomery_test, arithmetic) {
+    altruct::random::xorshift_64star rng(12345);
+    for (uint64_t n : { 3ULL, 1000000007ULL, 4294967291ULL, 2305843009213693951ULL, 18446744073709551557ULL, 18446744073709551615ULL }) {
+        montgomery64 m(n);
+        for (int i = 0; i < 1000; i++) {
+            uint64_t x = rng.next(), y = rng.next() % n;
+            uint64_t mx = m.to(x), my = m.to(y);
+            EXPECT_EQ(x % n, m.from(mx));
+            EXPECT_EQ(modulo_mul(x % n, y, n), m.from(m.mul(mx, my)));
+            EXPECT_EQ(modulo_add(x % n, y, n), m.from(m.add(mx, my)));
+            EXPECT_EQ(modulo_sub(x % n, y, n), m.from(m.sub(mx, my)));
+        }
+        uint64_t x = rng.next() % n, r = 1;
+        for (uint64_t e = 0; e < 100; e++) {
+            EXPECT_EQ(r, m.from(m.pow(m.to(x), e)));
+            r = modulo_mul(r, x, n);
+        }
+    }
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(montgomery_test, arithmetic128) {
+    typedef unsigned __int128 u128;
+    altruct::random::xorshift_64star rng(12345);
+    u128 p61 = (u128(1) << 61) - 1, p64 = 18446744073709551557ULL;
+    for (u128 n : { u128(1000000007), p61, p61 * p64, (u128(1) << 127) + 29, ~u128(0) }) {
+        montgomery128 m(n);
+        EXPECT_TRUE(m.n * m.n_inv == 1);
+        for (int i = 0; i < 100; i++) {
+            u128 x = (u128(rng.next()) << 64 | rng.next()) % n, y = (u128(rng.next()) << 64 | rng.next()) % n;
+            u128 mx = m.to(x), my = m.to(y);
+            EXPECT_TRUE(x == m.from(mx));
+            // x * y mod n by doubling
+            u128 r = 0, a = x;
+            for (u128 e = y; e > 0; e >>= 1) {
+                if (e & 1) r = m.add(r, a);
+                a = m.add(a, a);
+            }
+            EXPECT_TRUE(r == m.from(m.mul(mx, my)));
+            EXPECT_TRUE(m.add(x, y) == m.from(m.add(mx, my)));
+            EXPECT_TRUE(m.sub(x, y) == m.from(m.sub(mx, my)));
+        }
+    }
+}
+#endif
@@ -1,6 +1,7 @@
 ﻿#include "altruct/algorithm/math/fft.h"
 #include "altruct/structure/math/polynom.h"
 #include "altruct/structure/math/modulo.h"
+#include "altruct/algorithm/random/xorshift.h"
 #include "structure_test_util.h"
 
 #include "gtest/gtest.h"
@@ -19,6 +20,13 @@ public:
 };
 
 typedef modulo<int, 1012924417> mod;
+
+polynom<mod> random_polynom(altruct::random::xorshift_64star& rng, int l) {
+    polynom<mod> p;
+    for (int i = l; i >= 0; i--) p[i] = mod(int(rng.next() % 1000000000));
+    if (p[l] == 0) p[l] = 1;
+    return p;
+}
 }
 
 namespace altruct {
@@ -591,6 +599,79 @@ TEST(polynom_test, mod) {
     EXPECT_EQ((polynom<int>{ 0, 0, 0, 0, 0, 0 }), pr);
 }
 
+TEST(polynom_test, div_mod) {
+    const polynom<int> p1{ 6 };
+    const polynom<int> p2{ 1, -3, 0, -2, 0, 0 };
+    const polynom<int> p3{ 12, 18, 30, -42, 36, 0, 24, 0 };
+    polynom<int> q, r;
+    polynom<int>::div_mod(q, r, p3, p1);
+    EXPECT_EQ((polynom<int>{ 2, 3, 5, -7, 6, 0, 4 }), q);
+    EXPECT_EQ((polynom<int>{}), r);
+    polynom<int>::div_mod(q, r, p3, p2);
+    EXPECT_EQ((polynom<int>{ 15, 0, 0, -12 }), q);
+    EXPECT_EQ((polynom<int>{-3, 63, 30 }), r);
+    polynom<int>::div_mod(q, r, p2, p3);
+    EXPECT_EQ((polynom<int>{}), q);
+    EXPECT_EQ((polynom<int>{ 1, -3, 0, -2 }), r);
+}
+
+TEST(polynom_test, half_gcd) {
+    altruct::random::xorshift_64star rng(12345);
+    for (int l0 : { 1, 2, 10, 63, 64, 65, 100, 257, 500 }) {
+        for (int l1 : { 0, l0 / 3, l0 / 2, l0 - 1 }) {
+            auto p0 = random_polynom(rng, l0);
+            auto p1 = random_polynom(rng, l1);
+            int k = (l0 + 1) / 2;
+            auto m = polynom<mod>::half_gcd(p0, p1);
+            polynom<mod> r0, r1;
+            polynom<mod>::_mat_apply(r0, r1, m, p0, p1);
+            EXPECT_GE(polynom<mod>::_deg(r0), k);
+            EXPECT_LT(polynom<mod>::_deg(r1), k);
+            auto r0_long = p0, r1_long = p1;
+            auto m_long = polynom<mod>::_half_gcd_long(r0_long, r1_long, k);
+            for (int i = 0; i < 4; i++) {
+                EXPECT_EQ(m_long[i], m[i]) << " l0: " << l0 << " l1: " << l1 << " i: " << i;
+            }
+        }
+    }
+}
+
+TEST(polynom_test, gcd) {
+    typedef polynom<mod> poly;
+    EXPECT_EQ((poly{ -1, 1 }), gcd(poly{ -1, 0, 1 }, poly{ -1, 1 }));
+    EXPECT_EQ(0, gcd(poly{ 3, 1 }, poly{ 2, 1 }).deg());
+    altruct::random::xorshift_64star rng(12345);
+    auto g = random_polynom(rng, 70);
+    for (int l : { 10, 100, 400 }) {
+        auto p0 = random_polynom(rng, l) * g;
+        auto p1 = random_polynom(rng, l - 7) * g;
+        auto r = gcd(p0, p1);
+        EXPECT_EQ(g / g.leading_coeff(), r / r.leading_coeff()) << " l: " << l;
+    }
+}
+
+TEST(polynom_test, gcd_ex) {
+    typedef polynom<mod> poly;
+    altruct::random::xorshift_64star rng(12345);
+    auto g = random_polynom(rng, 30);
+    for (int l : { 0, 10, 100, 400 }) {
+        for (int d : { -5, 0, 7 }) {
+            auto p0 = random_polynom(rng, l) * g;
+            auto p1 = random_polynom(rng, std::max(l + d, 0)) * g;
+            poly x, y; int s;
+            auto r = gcd_ex(p0, p1, &x, &y, &s);
+            EXPECT_EQ(r, p0 * x + p1 * y) << " l: " << l << " d: " << d;
+            EXPECT_EQ(g / g.leading_coeff(), r / r.leading_coeff()) << " l: " << l << " d: " << d;
+            // same as the plain Euclidean algorithm
+            poly r0 = p0, r1 = p1;
+            auto m = poly::_half_gcd_long(r0, r1, 0);
+            EXPECT_EQ(r0, r);
+            EXPECT_EQ(m[0], x);
+            EXPECT_EQ(m[1], y);
+        }
+    }
+}
+
 TEST(polynom_test, muls) {
     const polynom<int> p0{};
     const polynom<int> p1{ 4 };
@@ -1,5 +1,23 @@
 #pragma once
 
+#include <algorithm>
+
 #define ALTRUCT_STRINGIFY(x) #x
 #define ALTRUCT_TOSTRING(x) ALTRUCT_STRINGIFY(x)
 #define ALTRUCT_AT __FILE__ ":" ALTRUCT_TOSTRING(__LINE__)
+
+namespace altruct {
+namespace test_util {
+
+// executes the range in chunks of the given length, one by one;
+// for testing the code that takes an executor with different splits of the work
+struct chunked_range_executor {
+    int len;
+    template<typename F>
+    void operator () (int begin, int end, F f) const {
+        for (int i = begin; i < end; i += len) f(i, std::min(end, i + len));
+    }
+};
+
+} // test_util
+} // altruct